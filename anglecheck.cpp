@@ -3,55 +3,48 @@
 #include "qgsgeometryutils.h"
 #include "featurepool.h"
 #include "checkerror.h"
+#include "vertexmetrics.h"
 
 QList<QgsWkbTypes::GeometryType> AngleCheck::compatibleGeometryTypes() const
 {
     return factoryCompatibleGeometryTypes();
 }
 
-void AngleCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void AngleCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, context());
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
-        const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
-        for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+        collectFeatureErrors(layerFeature, errors);
+    }
+}
+
+void AngleCheck::collectFeatureErrors(const CheckerUtils::LayerFeature &layerFeature, CheckErrorSink &errors) const
+{
+    const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
+    const double cosMinAngle = VertexMetrics::cosThreshold(mMinAngle);
+    VertexMetrics metrics;
+    for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+    {
+        for (int iRing = 0, nRings = geom->ringCount(iPart); iRing < nRings; ++iRing)
         {
-            for (int iRing = 0, nRings = geom->ringCount(iPart); iRing < nRings; ++iRing)
+            metrics.setRing(geom, iPart, iRing);
+            // Less than three points, no angles to check
+            if (metrics.size() < 3)
             {
-                bool closed = false;
-                int nVerts = CheckerUtils::polyLineSize(geom, iPart, iRing, &closed);
-                // Less than three points, no angles to check
-                if (nVerts < 3)
-                {
-                    continue;
-                }
-                for (int iVert = !closed; iVert < nVerts - !closed; ++iVert)
+                continue;
+            }
+            metrics.compute(cosMinAngle);
+            for (int iVert = 0, nVerts = metrics.size(); iVert < nVerts; ++iVert)
+            {
+                if (metrics.isSharp(iVert))
                 {
-                    const QgsPoint &p1 = geom->vertexAt(QgsVertexId(iPart, iRing, (iVert - 1 + nVerts) % nVerts));
-                    const QgsPoint &p2 = geom->vertexAt(QgsVertexId(iPart, iRing, iVert));
-                    const QgsPoint &p3 = geom->vertexAt(QgsVertexId(iPart, iRing, (iVert + 1) % nVerts));
-                    QgsVector v21, v23;
-                    try
-                    {
-                        v21 = QgsVector(p1.x() - p2.x(), p1.y() - p2.y()).normalized();
-                        v23 = QgsVector(p3.x() - p2.x(), p3.y() - p2.y()).normalized();
-                    }
-                    catch (const QgsException &)
-                    {
-                        // Zero length vectors
-                        continue;
-                    }
-
-                    double angle = std::acos(v21 * v23) / M_PI * 180.0;
-                    if (angle < mMinAngle)
-                    {
-                        errors.append(new CheckError(this, layerFeature, p2, QgsVertexId(iPart, iRing, iVert), angle));
-                    }
+                    QgsPointXY p2(metrics.x(iVert), metrics.y(iVert));
+                    errors.append(new CheckError(this, layerFeature, p2, QgsVertexId(iPart, iRing, iVert), metrics.angle(iVert)));
                 }
             }
         }
@@ -20,7 +20,9 @@ public:
         layers = var.value<QSet<QgsVectorLayer *>>();
     }
 
-    void collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids = LayerFeatureIds()) const override;
+    void collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids = LayerFeatureIds()) const override;
+    bool isFeatureLocal() const override { return true; }
+    void collectFeatureErrors(const CheckerUtils::LayerFeature &layerFeature, CheckErrorSink &errors) const override;
     void fixError(const QMap<QString, FeaturePool *> &featurePools, CheckError *error, int method, const QMap<QString, int> &mergeAttributeIndices, Changes &changes) const override;
 
     QList<QgsWkbTypes::GeometryType> compatibleGeometryTypes() const override;
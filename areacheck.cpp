@@ -5,25 +5,30 @@
 #include "featurepool.h"
 #include "checkerror.h"
 
-void AreaCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void AreaCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext);
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
-        const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
-        double layerToMapUnits = scaleFactor(layerFeature.layer());
-        for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+        collectFeatureErrors(layerFeature, errors);
+    }
+}
+
+void AreaCheck::collectFeatureErrors(const CheckerUtils::LayerFeature &layerFeature, CheckErrorSink &errors) const
+{
+    const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
+    double layerToMapUnits = scaleFactor(layerFeature.layer());
+    for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+    {
+        double value;
+        const QgsAbstractGeometry *part = CheckerUtils::getGeomPart(geom, iPart);
+        if (checkThreshold(layerToMapUnits, part, value))
         {
-            double value;
-            const QgsAbstractGeometry *part = CheckerUtils::getGeomPart(geom, iPart);
-            if (checkThreshold(layerToMapUnits, part, value))
-            {
-                errors.append(new CheckError(this, layerFeature, part->centroid(), QgsVertexId(iPart), value * layerToMapUnits * layerToMapUnits, CheckError::ValueArea));
-            }
+            errors.append(new CheckError(this, layerFeature, part->centroid(), QgsVertexId(iPart), value * layerToMapUnits * layerToMapUnits, CheckError::ValueArea));
         }
     }
 }
@@ -3,21 +3,25 @@
 #include "featurepool.h"
 #include "checkerror.h"
 
-void AttrValidCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void AttrValidCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext);
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
+        collectFeatureErrors(layerFeature, errors);
+    }
+}
 
-        QgsFeature f = layerFeature.feature();
-        QgsFields pFields = f.fields();
-        if(f.attribute(attr).isValid() && f.attribute(attr).isNull()){
-            errors.append(new CheckError(this, layerFeature, layerFeature.geometry().centroid().asPoint(), QgsVertexId(), attr));
-        }
+void AttrValidCheck::collectFeatureErrors(const CheckerUtils::LayerFeature &layerFeature, CheckErrorSink &errors) const
+{
+    QgsFeature f = layerFeature.feature();
+    QgsFields pFields = f.fields();
+    if(f.attribute(attr).isValid() && f.attribute(attr).isNull()){
+        errors.append(new CheckError(this, layerFeature, layerFeature.geometry().centroid().asPoint(), QgsVertexId(), attr));
     }
 }
 
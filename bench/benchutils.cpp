@@ -0,0 +1,206 @@
+#include "benchutils.h"
+#include "checkerutils.h"
+
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+    volatile double sSink = 0;
+}
+
+std::unique_ptr<QgsLineString> BenchUtils::randomWalk(int vertexCount, double step, quint32 seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> direction(0, 2 * M_PI);
+    std::uniform_real_distribution<double> length(0.5 * step, 1.5 * step);
+    QVector<double> x, y;
+    x.reserve(vertexCount);
+    y.reserve(vertexCount);
+    double px = 0, py = 0;
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        x.append(px);
+        y.append(py);
+        const double angle = direction(generator);
+        const double dist = length(generator);
+        px += dist * std::cos(angle);
+        py += dist * std::sin(angle);
+    }
+    return std::unique_ptr<QgsLineString>(new QgsLineString(x, y));
+}
+
+std::unique_ptr<QgsLineString> BenchUtils::gridLine(int vertexCount, double spacing)
+{
+    const int columns = std::max(2, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(vertexCount)))));
+    QVector<double> x, y;
+    x.reserve(vertexCount);
+    y.reserve(vertexCount);
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        const int row = i / columns;
+        const int column = row % 2 == 0 ? i % columns : columns - 1 - i % columns;
+        x.append(column * spacing);
+        y.append(row * spacing);
+    }
+    return std::unique_ptr<QgsLineString>(new QgsLineString(x, y));
+}
+
+std::unique_ptr<QgsLineString> BenchUtils::zigzag(int vertexCount, double amplitude, double yOffset)
+{
+    QVector<double> x, y;
+    x.reserve(vertexCount);
+    y.reserve(vertexCount);
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        x.append(i);
+        y.append(yOffset + (i % 2 == 0 ? amplitude : -amplitude));
+    }
+    return std::unique_ptr<QgsLineString>(new QgsLineString(x, y));
+}
+
+std::unique_ptr<QgsPolygon> BenchUtils::longRing(int vertexCount, double radius, double jitter, quint32 seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> offset(-jitter, jitter);
+    QVector<double> x, y;
+    x.reserve(vertexCount + 1);
+    y.reserve(vertexCount + 1);
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        const double angle = 2 * M_PI * i / vertexCount;
+        x.append(radius * std::cos(angle) + offset(generator));
+        y.append(radius * std::sin(angle) + offset(generator));
+    }
+    x.append(x.first());
+    y.append(y.first());
+    std::unique_ptr<QgsPolygon> polygon(new QgsPolygon());
+    polygon->setExteriorRing(new QgsLineString(x, y));
+    return polygon;
+}
+
+QPair<std::shared_ptr<QgsPolygon>, std::shared_ptr<QgsPolygon>> BenchUtils::adjacentSquares(int vertexCount, double size)
+{
+    // The shared edge runs along x = 0 from (0, 0) to (0, size)
+    QVector<double> edgeY;
+    for (int i = 0; i < vertexCount; ++i)
+        edgeY.append(size * i / std::max(1, vertexCount - 1));
+
+    QVector<double> leftX, leftY, rightX, rightY;
+    leftX << -size;
+    leftY << 0;
+    rightX << size;
+    rightY << size;
+    for (int i = 0; i < edgeY.size(); ++i)
+    {
+        leftX << 0;
+        leftY << edgeY[i];
+        rightX << 0;
+        rightY << edgeY[edgeY.size() - 1 - i];
+    }
+    leftX << -size << -size;
+    leftY << size << 0;
+    rightX << size << size;
+    rightY << 0 << size;
+
+    std::shared_ptr<QgsPolygon> left(new QgsPolygon());
+    left->setExteriorRing(new QgsLineString(leftX, leftY));
+    std::shared_ptr<QgsPolygon> right(new QgsPolygon());
+    right->setExteriorRing(new QgsLineString(rightX, rightY));
+    return qMakePair(left, right);
+}
+
+QVector<LineSegment> BenchUtils::sortedSegments(const QgsLineString *line)
+{
+    QVector<LineSegment> segments;
+    segments.reserve(line->numPoints());
+    for (int i = 0; i + 1 < line->numPoints(); ++i)
+    {
+        segments.append(LineSegment(QgsPointXY(line->xAt(i), line->yAt(i)), QgsPointXY(line->xAt(i + 1), line->yAt(i + 1))));
+    }
+    std::sort(segments.begin(), segments.end(), CheckerUtils::cmp);
+    return segments;
+}
+
+BenchUtils::Measurement BenchUtils::measure(const std::function<void()> &op, qint64 minTimeMs, int opsPerCall)
+{
+    Measurement measurement;
+    QElapsedTimer timer;
+    timer.start();
+    do
+    {
+        op();
+        ++measurement.iterations;
+    } while (timer.elapsed() < minTimeMs);
+    measurement.nsPerOp = static_cast<double>(timer.nsecsElapsed()) / (measurement.iterations * std::max(1, opsPerCall));
+    return measurement;
+}
+
+void BenchUtils::consume(double value)
+{
+    sSink = sSink + value;
+}
+
+void BenchUtils::report(QTextStream &out, const QList<Measurement> &measurements, bool csv)
+{
+    if (csv)
+        out << "kernel,shape,vertices,tolerance,iterations,ns_per_op,scaling" << endl;
+    else
+        out << QStringLiteral("%1 %2 %3 %4 %5 %6").arg(QStringLiteral("kernel"), -24).arg(QStringLiteral("shape"), -12).arg(QStringLiteral("vertices"), 9).arg(QStringLiteral("tolerance"), 10).arg(QStringLiteral("ns/op"), 14).arg(QStringLiteral("scaling"), 8) << endl;
+
+    for (int i = 0; i < measurements.size(); ++i)
+    {
+        const Measurement &m = measurements[i];
+        // Growth against the previous vertex count of the same series
+        QString scaling;
+        if (i > 0)
+        {
+            const Measurement &previous = measurements[i - 1];
+            if (previous.kernel == m.kernel && previous.shape == m.shape && previous.tolerance == m.tolerance &&
+                previous.vertexCount < m.vertexCount && previous.nsPerOp > 0)
+            {
+                scaling = QString::number(std::log(m.nsPerOp / previous.nsPerOp) / std::log(static_cast<double>(m.vertexCount) / previous.vertexCount), 'f', 2);
+            }
+        }
+
+        if (csv)
+        {
+            out << m.kernel << ',' << m.shape << ',' << m.vertexCount << ',' << m.tolerance << ',' << m.iterations << ','
+                << QString::number(m.nsPerOp, 'f', 1) << ',' << scaling << endl;
+        }
+        else
+        {
+            out << QStringLiteral("%1 %2 %3 %4 %5 %6").arg(m.kernel, -24).arg(m.shape, -12).arg(m.vertexCount, 9).arg(m.tolerance, 10, 'g', 2).arg(m.nsPerOp, 14, 'f', 1).arg(scaling, 8) << endl;
+        }
+    }
+}
+
+QList<int> BenchUtils::parseIntList(const QString &text)
+{
+    QList<int> values;
+    for (const QString &part : text.split(QLatin1Char(','), QString::SkipEmptyParts))
+    {
+        bool ok = false;
+        const int value = part.trimmed().toInt(&ok);
+        if (!ok || value <= 0)
+            return QList<int>();
+        values.append(value);
+    }
+    return values;
+}
+
+QList<double> BenchUtils::parseDoubleList(const QString &text)
+{
+    QList<double> values;
+    for (const QString &part : text.split(QLatin1Char(','), QString::SkipEmptyParts))
+    {
+        bool ok = false;
+        const double value = part.trimmed().toDouble(&ok);
+        if (!ok || value <= 0)
+            return QList<double>();
+        values.append(value);
+    }
+    return values;
+}
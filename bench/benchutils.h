@@ -0,0 +1,67 @@
+#ifndef BENCHUTILS_H
+#define BENCHUTILS_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+#include <functional>
+#include <memory>
+
+#include <qgslinestring.h>
+#include <qgspolygon.h>
+
+#include "linesegment.h"
+
+// Synthetic geometries and timing for the benchmark executables.
+// All generators are deterministic for a given seed, so runs can be compared.
+namespace BenchUtils
+{
+    // A walk of vertexCount vertices with steps of about step length in random directions
+    std::unique_ptr<QgsLineString> randomWalk(int vertexCount, double step, quint32 seed = 1);
+
+    // A line running back and forth over a grid of vertexCount vertices with the given spacing
+    std::unique_ptr<QgsLineString> gridLine(int vertexCount, double spacing);
+
+    // A straight line of vertexCount vertices whose vertices alternate by amplitude to either side
+    std::unique_ptr<QgsLineString> zigzag(int vertexCount, double amplitude, double yOffset = 0);
+
+    // A closed ring of vertexCount vertices around a circle, each vertex moved by up to jitter
+    std::unique_ptr<QgsPolygon> longRing(int vertexCount, double radius, double jitter, quint32 seed = 1);
+
+    // Two squares sharing one edge, which is split into vertexCount vertices in both
+    QPair<std::shared_ptr<QgsPolygon>, std::shared_ptr<QgsPolygon>> adjacentSquares(int vertexCount, double size);
+
+    // The segments of line, sorted by angle as CheckerUtils::lineOverlay() expects them
+    QVector<LineSegment> sortedSegments(const QgsLineString *line);
+
+    // One measurement of a kernel
+    struct Measurement
+    {
+        QString kernel;
+        QString shape;
+        int vertexCount = 0;
+        double tolerance = 0;
+        qint64 iterations = 0;
+        double nsPerOp = 0;
+    };
+
+    // Calls op until at least minTimeMs have passed, at least once.
+    // opsPerCall is the number of kernel calls one call of op stands for.
+    Measurement measure(const std::function<void()> &op, qint64 minTimeMs, int opsPerCall = 1);
+
+    // Keeps the optimizer from dropping the result of a kernel
+    void consume(double value);
+
+    // Prints the measurements as table, or as csv, with the scaling exponent between
+    // successive vertex counts of the same kernel, shape and tolerance (1 = linear, 2 = quadratic)
+    void report(QTextStream &out, const QList<Measurement> &measurements, bool csv);
+
+    // Parses a comma separated list, returns an empty list if any value is invalid
+    QList<int> parseIntList(const QString &text);
+    QList<double> parseDoubleList(const QString &text);
+}
+
+#endif // BENCHUTILS_H
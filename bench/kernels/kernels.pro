@@ -0,0 +1,27 @@
+TEMPLATE = app
+TARGET = TopologyCheckerKernelBench
+CONFIG += console
+CONFIG -= app_bundle
+
+PROJECT_PATH = $$PWD/../..
+SDK_PATH = $$PROJECT_PATH/../../
+
+CONFIG(debug, debug|release){
+    DESTDIR = $$SDK_PATH/bin/debug
+}
+else{
+    DESTDIR = $$SDK_PATH/bin/release
+}
+
+include( $$SDK_PATH/include/qgisconfig.pri )
+
+# The geometry kernels live with the checks
+include( $$PROJECT_PATH/vector.pri )
+INCLUDEPATH += $$PROJECT_PATH $$PWD/..
+
+HEADERS += \
+    $$PWD/../benchutils.h
+
+SOURCES += \
+    $$PWD/../benchutils.cpp \
+    $$PWD/main.cpp
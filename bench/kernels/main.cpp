@@ -0,0 +1,165 @@
+// Measures the geometry kernels of CheckerUtils on synthetic geometries.
+//
+//   TopologyCheckerKernelBench [--sizes 100,1000,10000] [--tolerances 1e-8,0.01]
+//                              [--min-time 200] [--kernel name] [--csv]
+//
+// Every kernel runs on each vertex count and tolerance for at least min-time
+// milliseconds. The scaling column is the growth exponent of ns/op against the
+// previous vertex count, 1 for linear and 2 for quadratic kernels.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include "benchutils.h"
+#include "checkerutils.h"
+
+namespace
+{
+    struct Kernel
+    {
+        QString name;
+        QString shape;
+        // Prepares the geometries for a vertex count and tolerance and measures the kernel
+        std::function<BenchUtils::Measurement(int vertexCount, double tolerance, qint64 minTimeMs)> run;
+    };
+
+    QList<Kernel> kernels()
+    {
+        QList<Kernel> list;
+
+        list.append({QStringLiteral("pointOnLine(segment)"), QStringLiteral("zigzag"), [](int n, double tol, qint64 minTime) {
+                         // One call per segment, ns/op is per call
+                         const std::unique_ptr<QgsLineString> line = BenchUtils::zigzag(n, 0.5);
+                         QVector<QgsPointXY> points;
+                         for (int i = 0; i < n; ++i)
+                             points.append(QgsPointXY(line->xAt(i), line->yAt(i)));
+                         return BenchUtils::measure([&] {
+                             int count = 0;
+                             for (int i = 0; i + 2 < points.size(); ++i)
+                                 count += CheckerUtils::pointOnLine(points[i + 1], points[i], points[i + 2], tol);
+                             BenchUtils::consume(count);
+                         }, minTime, std::max(1, n - 2));
+                     }});
+
+        list.append({QStringLiteral("pointOnLine(line)"), QStringLiteral("randomwalk"), [](int n, double tol, qint64 minTime) {
+                         const std::unique_ptr<QgsLineString> line = BenchUtils::randomWalk(n, 1.0);
+                         const QgsPoint p(1e6, 1e6);
+                         return BenchUtils::measure([&] {
+                             BenchUtils::consume(CheckerUtils::pointOnLine(p, line.get(), tol));
+                         }, minTime);
+                     }});
+
+        list.append({QStringLiteral("getFootOfPerpendicular"), QStringLiteral("randomwalk"), [](int n, double tol, qint64 minTime) {
+                         const std::unique_ptr<QgsLineString> line = BenchUtils::randomWalk(n, 1.0);
+                         const QgsPoint p(line->xAt(n / 2) + 0.25, line->yAt(n / 2) + 0.25);
+                         return BenchUtils::measure([&] {
+                             BenchUtils::consume(CheckerUtils::getFootOfPerpendicular(p, line.get(), tol).x());
+                         }, minTime);
+                     }});
+
+        list.append({QStringLiteral("lineOverlay"), QStringLiteral("zigzag"), [](int n, double tol, qint64 minTime) {
+                         // Two near collinear zigzags, most segment pairs are candidates
+                         const std::unique_ptr<QgsLineString> a = BenchUtils::zigzag(n, 1e-3);
+                         const std::unique_ptr<QgsLineString> b = BenchUtils::zigzag(n, 1e-3, tol / 2);
+                         QVector<LineSegment> linesA = BenchUtils::sortedSegments(a.get());
+                         QVector<LineSegment> linesB = BenchUtils::sortedSegments(b.get());
+                         return BenchUtils::measure([&] {
+                             BenchUtils::consume(CheckerUtils::lineOverlay(linesA, linesB, tol).size());
+                         }, minTime);
+                     }});
+
+        list.append({QStringLiteral("lineSelfOverlay"), QStringLiteral("gridline"), [](int n, double tol, qint64 minTime) {
+                         // Grid lines have only two directions, every segment has many parallel ones
+                         const std::unique_ptr<QgsLineString> line = BenchUtils::gridLine(n, 1.0);
+                         QVector<LineSegment> lines = BenchUtils::sortedSegments(line.get());
+                         return BenchUtils::measure([&] {
+                             BenchUtils::consume(CheckerUtils::lineSelfOverlay(lines, tol).size());
+                         }, minTime);
+                     }});
+
+        list.append({QStringLiteral("selfIntersections"), QStringLiteral("randomwalk"), [](int n, double tol, qint64 minTime) {
+                         const std::unique_ptr<QgsLineString> line = BenchUtils::randomWalk(n, 1.0);
+                         return BenchUtils::measure([&] {
+                             BenchUtils::consume(CheckerUtils::selfIntersections(line.get(), 0, 0, tol).size());
+                         }, minTime);
+                     }});
+
+        list.append({QStringLiteral("selfIntersections"), QStringLiteral("longring"), [](int n, double tol, qint64 minTime) {
+                         const std::unique_ptr<QgsPolygon> polygon = BenchUtils::longRing(n, 1000.0, 0.1);
+                         return BenchUtils::measure([&] {
+                             BenchUtils::consume(CheckerUtils::selfIntersections(polygon.get(), 0, 0, tol).size());
+                         }, minTime);
+                     }});
+
+        list.append({QStringLiteral("lineIntersections"), QStringLiteral("randomwalk"), [](int n, double tol, qint64 minTime) {
+                         const std::unique_ptr<QgsLineString> a = BenchUtils::randomWalk(n, 1.0, 1);
+                         const std::unique_ptr<QgsLineString> b = BenchUtils::randomWalk(n, 1.0, 2);
+                         return BenchUtils::measure([&] {
+                             BenchUtils::consume(CheckerUtils::lineIntersections(a.get(), b.get(), tol).size());
+                         }, minTime);
+                     }});
+
+        list.append({QStringLiteral("sharedEdgeLength"), QStringLiteral("squares"), [](int n, double tol, qint64 minTime) {
+                         const auto squares = BenchUtils::adjacentSquares(n, 100.0);
+                         return BenchUtils::measure([&] {
+                             BenchUtils::consume(CheckerUtils::sharedEdgeLength(squares.first.get(), squares.second.get(), tol));
+                         }, minTime);
+                     }});
+
+        return list;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("TopologyCheckerKernelBench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Measures the geometry kernels of the topology checks."));
+    parser.addHelpOption();
+    QCommandLineOption sizesOption(QStringLiteral("sizes"), QStringLiteral("Comma separated vertex counts (default 100,1000,10000)."), QStringLiteral("counts"), QStringLiteral("100,1000,10000"));
+    QCommandLineOption tolerancesOption(QStringLiteral("tolerances"), QStringLiteral("Comma separated tolerances (default 1e-8,0.01)."), QStringLiteral("values"), QStringLiteral("1e-8,0.01"));
+    QCommandLineOption minTimeOption(QStringLiteral("min-time"), QStringLiteral("Minimum time per measurement in milliseconds (default 200)."), QStringLiteral("ms"), QStringLiteral("200"));
+    QCommandLineOption kernelOption(QStringLiteral("kernel"), QStringLiteral("Only run the kernels with this name."), QStringLiteral("name"));
+    QCommandLineOption csvOption(QStringLiteral("csv"), QStringLiteral("Print comma separated values."));
+    parser.addOption(sizesOption);
+    parser.addOption(tolerancesOption);
+    parser.addOption(minTimeOption);
+    parser.addOption(kernelOption);
+    parser.addOption(csvOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    const QList<int> sizes = BenchUtils::parseIntList(parser.value(sizesOption));
+    const QList<double> tolerances = BenchUtils::parseDoubleList(parser.value(tolerancesOption));
+    if (sizes.isEmpty() || tolerances.isEmpty())
+    {
+        QTextStream(stderr) << "Vertex counts and tolerances must be positive numbers." << endl;
+        return 1;
+    }
+    const qint64 minTime = parser.value(minTimeOption).toLongLong();
+
+    QList<BenchUtils::Measurement> measurements;
+    for (const Kernel &kernel : kernels())
+    {
+        if (parser.isSet(kernelOption) && !kernel.name.startsWith(parser.value(kernelOption)))
+            continue;
+        for (double tolerance : tolerances)
+        {
+            for (int size : sizes)
+            {
+                BenchUtils::Measurement measurement = kernel.run(size, tolerance, minTime);
+                measurement.kernel = kernel.name;
+                measurement.shape = kernel.shape;
+                measurement.vertexCount = size;
+                measurement.tolerance = tolerance;
+                measurements.append(measurement);
+            }
+        }
+    }
+
+    BenchUtils::report(out, measurements, parser.isSet(csvOption));
+    return 0;
+}
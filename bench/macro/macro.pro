@@ -0,0 +1,29 @@
+TEMPLATE = app
+TARGET = TopologyCheckerMacroBench
+CONFIG += console
+CONFIG -= app_bundle
+
+PROJECT_PATH = $$PWD/../..
+SDK_PATH = $$PROJECT_PATH/../../
+
+CONFIG(debug, debug|release){
+    DESTDIR = $$SDK_PATH/bin/debug
+}
+else{
+    DESTDIR = $$SDK_PATH/bin/release
+}
+
+include( $$SDK_PATH/include/qgisconfig.pri )
+
+# The checks, feature pools and checker, without any widgets
+include( $$PROJECT_PATH/vector.pri )
+INCLUDEPATH += $$PROJECT_PATH $$PWD/..
+
+HEADERS += \
+    $$PWD/../benchutils.h \
+    $$PWD/../syntheticdataset.h
+
+SOURCES += \
+    $$PWD/../benchutils.cpp \
+    $$PWD/../syntheticdataset.cpp \
+    $$PWD/main.cpp
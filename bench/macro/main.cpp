@@ -0,0 +1,262 @@
+// Runs every check type on generated datasets and records its cost end to end.
+//
+//   TopologyCheckerMacroBench [--features 10000,100000,1000000] [--dir datasets]
+//                             [--seed 1] [--check name] [--cancel-after ms]
+//                             [--output results.json]
+//
+// A dataset with the synthetic defects is written for each feature count, the same
+// size and seed always give the same dataset. Each check then runs alone through
+// the checker with fresh feature pools, recording the wall time, the peak resident
+// memory, the features per second, the number of errors found and what the
+// feature pools read and cached. Peak memory is only measured on Linux.
+//
+// With --cancel-after every check is canceled after the given time instead, and the
+// time from the cancel until the run has stopped is recorded. It should stay below
+// CANCEL_LATENCY_TARGET_MS, checks which take longer are reported.
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QTimer>
+#include <memory>
+
+#include <qgsapplication.h>
+#include <qgsproject.h>
+#include <qgsvectorlayer.h>
+
+#include "benchutils.h"
+#include "check.h"
+#include "checkcontext.h"
+#include "checker.h"
+#include "checkfactory.h"
+#include "syntheticdataset.h"
+#include "vectordataproviderfeaturepool.h"
+
+namespace
+{
+    const int CANCEL_LATENCY_TARGET_MS = 500;
+
+    QTextStream &err()
+    {
+        static QTextStream sStream(stderr);
+        return sStream;
+    }
+
+    // Resets the peak resident memory of the process to its current size
+    void resetPeakMemory()
+    {
+#ifdef Q_OS_LINUX
+        QFile file(QStringLiteral("/proc/self/clear_refs"));
+        if (file.open(QFile::WriteOnly))
+            file.write("5");
+#endif
+    }
+
+    // Returns the peak resident memory of the process in kilobytes, or -1 if unknown
+    qint64 peakMemory()
+    {
+#ifdef Q_OS_LINUX
+        QFile file(QStringLiteral("/proc/self/status"));
+        if (!file.open(QFile::ReadOnly | QFile::Text))
+            return -1;
+        for (const QByteArray &line : file.readAll().split('\n'))
+        {
+            if (line.startsWith("VmHWM:"))
+                return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+        }
+#endif
+        return -1;
+    }
+
+    // Runs one check on fresh feature pools and returns its measurements.
+    // The run is canceled after cancelAfter ms unless that is negative.
+    QJsonObject runCheck(const QString &name, const QList<QgsVectorLayer *> &layers, int cancelAfter)
+    {
+        QJsonObject result;
+        result.insert(QStringLiteral("check"), name);
+
+        CheckContext *context = new CheckContext(8, layers.first()->crs(), QgsCoordinateTransformContext(), QgsProject::instance());
+        Check *check = SyntheticDataset::createCheck(name, layers, context);
+        if (!check)
+        {
+            delete context;
+            result.insert(QStringLiteral("skipped"), true);
+            return result;
+        }
+        qint64 featureCount = 0;
+        for (const QgsVectorLayer *layer : check->configuredLayers())
+            featureCount += layer->featureCount();
+
+        resetPeakMemory();
+        QElapsedTimer timer;
+        timer.start();
+
+        QMap<QString, FeaturePool *> featurePools;
+        for (QgsVectorLayer *layer : layers)
+        {
+            featurePools.insert(layer->id(), new VectorDataProviderFeaturePool(layer, false));
+        }
+        std::unique_ptr<Checker> checker(new Checker(QList<Check *>() << check, context, featurePools));
+
+        QEventLoop evLoop;
+        QFutureWatcher<void> futureWatcher;
+        QObject::connect(&futureWatcher, &QFutureWatcherBase::finished, &evLoop, &QEventLoop::quit);
+        QElapsedTimer cancelTimer;
+        QTimer cancelTrigger;
+        if (cancelAfter >= 0)
+        {
+            cancelTrigger.setSingleShot(true);
+            QObject::connect(&cancelTrigger, &QTimer::timeout, [&cancelTimer, &checker] {
+                cancelTimer.start();
+                checker->cancel();
+            });
+            cancelTrigger.start(cancelAfter);
+        }
+        futureWatcher.setFuture(checker->execute());
+        evLoop.exec();
+        cancelTrigger.stop();
+        const qint64 cancelLatency = cancelTimer.isValid() ? cancelTimer.elapsed() : -1;
+        checker->flushErrors();
+
+        const qint64 elapsed = timer.elapsed();
+        result.insert(QStringLiteral("features"), featureCount);
+        result.insert(QStringLiteral("wall_ms"), elapsed);
+        result.insert(QStringLiteral("peak_rss_kb"), peakMemory());
+        result.insert(QStringLiteral("features_per_s"), elapsed > 0 ? 1000.0 * featureCount / elapsed : 0.0);
+        result.insert(QStringLiteral("errors"), checker->errors().size());
+        // -1 if the check was done before it was canceled
+        if (cancelAfter >= 0)
+            result.insert(QStringLiteral("cancel_latency_ms"), cancelLatency);
+
+        // Summed over the layers, to size the feature cache
+        FeaturePool::Statistics stats;
+        for (const FeaturePool *pool : checker->featurePools())
+        {
+            const FeaturePool::Statistics poolStats = pool->statistics();
+            stats.cacheHits += poolStats.cacheHits;
+            stats.cacheMisses += poolStats.cacheMisses;
+            stats.evictions += poolStats.evictions;
+            stats.providerFetches += poolStats.providerFetches;
+            stats.bytesDecoded += poolStats.bytesDecoded;
+            stats.indexQueries += poolStats.indexQueries;
+            stats.indexResults += poolStats.indexResults;
+        }
+        QJsonObject pools;
+        pools.insert(QStringLiteral("cache_hits"), stats.cacheHits);
+        pools.insert(QStringLiteral("cache_misses"), stats.cacheMisses);
+        pools.insert(QStringLiteral("evictions"), stats.evictions);
+        pools.insert(QStringLiteral("provider_fetches"), stats.providerFetches);
+        pools.insert(QStringLiteral("bytes_decoded"), stats.bytesDecoded);
+        pools.insert(QStringLiteral("index_queries"), stats.indexQueries);
+        pools.insert(QStringLiteral("avg_index_result"), stats.averageIndexResultSize());
+        result.insert(QStringLiteral("pools"), pools);
+        const QStringList messages = checker->getMessages();
+        if (!messages.isEmpty())
+            result.insert(QStringLiteral("messages"), QJsonArray::fromStringList(messages));
+        return result;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QgsApplication app(argc, argv, false);
+    QCoreApplication::setApplicationName(QStringLiteral("TopologyCheckerMacroBench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Measures every check type on generated datasets."));
+    parser.addHelpOption();
+    QCommandLineOption featuresOption(QStringLiteral("features"), QStringLiteral("Comma separated dataset sizes (default 10000)."), QStringLiteral("counts"), QStringLiteral("10000"));
+    QCommandLineOption dirOption(QStringLiteral("dir"), QStringLiteral("Directory of the generated datasets (default the current one)."), QStringLiteral("path"), QStringLiteral("."));
+    QCommandLineOption seedOption(QStringLiteral("seed"), QStringLiteral("Seed of the generated datasets (default 1)."), QStringLiteral("number"), QStringLiteral("1"));
+    QCommandLineOption checkOption(QStringLiteral("check"), QStringLiteral("Only run the checks with this name."), QStringLiteral("name"));
+    QCommandLineOption cancelOption(QStringLiteral("cancel-after"), QStringLiteral("Cancel every check after this time and measure how long it takes to stop."), QStringLiteral("ms"));
+    QCommandLineOption outputOption({QStringLiteral("o"), QStringLiteral("output")}, QStringLiteral("JSON file the results are written to (default standard output)."), QStringLiteral("file"));
+    parser.addOption(featuresOption);
+    parser.addOption(dirOption);
+    parser.addOption(seedOption);
+    parser.addOption(checkOption);
+    parser.addOption(cancelOption);
+    parser.addOption(outputOption);
+    parser.process(app);
+
+    const QList<int> sizes = BenchUtils::parseIntList(parser.value(featuresOption));
+    if (sizes.isEmpty())
+    {
+        err() << "Feature counts must be positive numbers." << endl;
+        return 1;
+    }
+    const quint32 seed = parser.value(seedOption).toUInt();
+    const int cancelAfter = parser.isSet(cancelOption) ? parser.value(cancelOption).toInt() : -1;
+    int slowCancels = 0;
+
+    QgsApplication::initQgis();
+    QJsonArray datasets;
+    for (int size : sizes)
+    {
+        SyntheticDataset dataset(size, seed);
+        const QString path = QDir(parser.value(dirOption)).filePath(QStringLiteral("synthetic_%1_%2.gpkg").arg(size).arg(seed));
+        QString error;
+        err() << "Writing " << QDir::toNativeSeparators(path) << endl;
+        if (!dataset.write(path, &error))
+        {
+            err() << error << endl;
+            QgsApplication::exitQgis();
+            return 1;
+        }
+
+        const QList<QgsVectorLayer *> layers = SyntheticDataset::openLayers(path);
+
+        QJsonArray checks;
+        for (const QString &name : CheckFactory::checkNames())
+        {
+            if (parser.isSet(checkOption) && !name.startsWith(parser.value(checkOption)))
+                continue;
+            const QJsonObject result = runCheck(name, layers, cancelAfter);
+            if (!result.contains(QStringLiteral("skipped")))
+            {
+                err() << name << ": " << result.value(QStringLiteral("wall_ms")).toInt() << " ms, "
+                      << result.value(QStringLiteral("errors")).toInt() << " errors" << endl;
+            }
+            if (result.value(QStringLiteral("cancel_latency_ms")).toInt() > CANCEL_LATENCY_TARGET_MS)
+            {
+                err() << name << " took " << result.value(QStringLiteral("cancel_latency_ms")).toInt() << " ms to stop after it was canceled" << endl;
+                ++slowCancels;
+            }
+            checks.append(result);
+        }
+        qDeleteAll(layers);
+
+        QJsonObject entry = dataset.toJson();
+        entry.insert(QStringLiteral("path"), path);
+        entry.insert(QStringLiteral("checks"), checks);
+        datasets.append(entry);
+    }
+    QgsApplication::exitQgis();
+
+    QJsonObject root;
+    root.insert(QStringLiteral("datasets"), datasets);
+    const QByteArray json = QJsonDocument(root).toJson();
+    // Checks which missed the cancel latency target fail the run
+    const int exitCode = slowCancels > 0 ? 2 : 0;
+    if (!parser.isSet(outputOption))
+    {
+        QTextStream(stdout) << json;
+        return exitCode;
+    }
+    QFile file(parser.value(outputOption));
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        err() << "Could not write " << file.fileName() << endl;
+        return 1;
+    }
+    file.write(json);
+    return exitCode;
+}
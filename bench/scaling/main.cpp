@@ -0,0 +1,229 @@
+// Measures how a check run scales with the number of threads.
+//
+//   TopologyCheckerScalingBench [--features 100000] [--dir datasets] [--seed 1]
+//                               [--threads 1,2,4,8] [--check name] [--csv]
+//
+// All checks, or the ones matching --check, run together on a generated dataset,
+// once for each maximum thread count of the global thread pool. Every run starts
+// from fresh feature pools. For each thread count the wall time, the speedup and
+// efficiency against the first thread count, the time the threads waited for the
+// feature caches and the error list, the critical path and the utilisation are
+// printed. The critical path is the longest single run of any check, which more
+// threads can not shorten. The utilisation is the share of the time the threads
+// spent checking rather than waiting for the last runs to finish. The time per check is printed for the last thread count.
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <memory>
+#include <tuple>
+
+#include <qgsapplication.h>
+#include <qgsproject.h>
+#include <qgsvectorlayer.h>
+
+#include "benchutils.h"
+#include "check.h"
+#include "checkcontext.h"
+#include "checker.h"
+#include "checkfactory.h"
+#include "syntheticdataset.h"
+#include "vectordataproviderfeaturepool.h"
+
+namespace
+{
+    QTextStream &err()
+    {
+        static QTextStream sStream(stderr);
+        return sStream;
+    }
+
+    struct ScalingRun
+    {
+        int threads = 0;
+        double wallMs = 0;
+        double cacheWaitMs = 0;
+        qint64 cacheContentions = 0;
+        double errorWaitMs = 0;
+        qint64 errorContentions = 0;
+        double criticalPathMs = 0;
+        double utilisation = 0;
+        int errorCount = 0;
+        // Check description, run count, total and longest run in ms
+        QList<std::tuple<QString, int, double, double>> checks;
+    };
+
+    // Returns 1, 2, 4 ... up to the number of cores, and the number of cores itself
+    QList<int> defaultThreadCounts()
+    {
+        QList<int> counts;
+        const int cores = std::max(1, QThread::idealThreadCount());
+        for (int n = 1; n < cores; n *= 2)
+            counts.append(n);
+        counts.append(cores);
+        return counts;
+    }
+
+    ScalingRun runPlan(int threads, const QStringList &names, const QList<QgsVectorLayer *> &layers)
+    {
+        ScalingRun result;
+        result.threads = threads;
+        QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+        CheckContext *context = new CheckContext(8, layers.first()->crs(), QgsCoordinateTransformContext(), QgsProject::instance());
+        QList<Check *> checks;
+        for (const QString &name : names)
+        {
+            if (Check *check = SyntheticDataset::createCheck(name, layers, context))
+                checks.append(check);
+        }
+        QMap<QString, FeaturePool *> featurePools;
+        for (QgsVectorLayer *layer : layers)
+        {
+            featurePools.insert(layer->id(), new VectorDataProviderFeaturePool(layer, false));
+        }
+        std::unique_ptr<Checker> checker(new Checker(checks, context, featurePools));
+
+        QElapsedTimer timer;
+        timer.start();
+        QEventLoop evLoop;
+        QFutureWatcher<void> futureWatcher;
+        QObject::connect(&futureWatcher, &QFutureWatcherBase::finished, &evLoop, &QEventLoop::quit);
+        futureWatcher.setFuture(checker->execute());
+        evLoop.exec();
+        checker->flushErrors();
+        result.wallMs = timer.nsecsElapsed() / 1e6;
+
+        for (const FeaturePool *pool : checker->featurePools())
+        {
+            result.cacheWaitMs += pool->cacheLockWait().waitTime() / 1e6;
+            result.cacheContentions += pool->cacheLockWait().contentionCount();
+        }
+        result.errorWaitMs = (checker->errorListLockWait().waitTime() + checker->errorQueueLockWait().waitTime()) / 1e6;
+        result.errorContentions = checker->errorListLockWait().contentionCount() + checker->errorQueueLockWait().contentionCount();
+        result.errorCount = checker->errors().size();
+        result.utilisation = checker->utilisation();
+
+        const QHash<const Check *, Checker::CheckTiming> timings = checker->checkTimings();
+        for (const Check *check : checker->getChecks())
+        {
+            const Checker::CheckTiming timing = timings.value(check);
+            result.criticalPathMs = std::max(result.criticalPathMs, timing.longestRun / 1e6);
+            result.checks.append(std::make_tuple(check->description(), timing.runCount, timing.totalTime / 1e6, timing.longestRun / 1e6));
+        }
+        for (const QString &message : checker->getMessages())
+        {
+            err() << message << endl;
+        }
+        return result;
+    }
+
+    void report(QTextStream &out, const QList<ScalingRun> &runs, bool csv)
+    {
+        if (csv)
+            out << "threads,wall_ms,speedup,efficiency,cache_wait_ms,cache_contentions,error_wait_ms,error_contentions,critical_path_ms,utilisation,errors" << endl;
+        else
+            out << QStringLiteral("%1 %2 %3 %4 %5 %6 %7 %8 %9").arg(QStringLiteral("threads"), 7).arg(QStringLiteral("wall ms"), 10).arg(QStringLiteral("speedup"), 8).arg(QStringLiteral("eff."), 6).arg(QStringLiteral("cache wait ms"), 14).arg(QStringLiteral("error wait ms"), 14).arg(QStringLiteral("crit. path ms"), 14).arg(QStringLiteral("util."), 6).arg(QStringLiteral("errors"), 8) << endl;
+
+        for (const ScalingRun &run : runs)
+        {
+            // Against the first thread count, which is usually a single thread
+            const ScalingRun &base = runs.first();
+            const double speedup = run.wallMs > 0 ? base.wallMs / run.wallMs : 0;
+            const double efficiency = speedup * base.threads / run.threads;
+            if (csv)
+            {
+                out << run.threads << ',' << QString::number(run.wallMs, 'f', 1) << ',' << QString::number(speedup, 'f', 2) << ','
+                    << QString::number(efficiency, 'f', 2) << ',' << QString::number(run.cacheWaitMs, 'f', 1) << ',' << run.cacheContentions << ','
+                    << QString::number(run.errorWaitMs, 'f', 1) << ',' << run.errorContentions << ',' << QString::number(run.criticalPathMs, 'f', 1) << ','
+                    << QString::number(run.utilisation, 'f', 2) << ',' << run.errorCount << endl;
+            }
+            else
+            {
+                out << QStringLiteral("%1 %2 %3 %4 %5 %6 %7 %8 %9").arg(run.threads, 7).arg(run.wallMs, 10, 'f', 1).arg(speedup, 8, 'f', 2).arg(efficiency, 6, 'f', 2).arg(run.cacheWaitMs, 14, 'f', 1).arg(run.errorWaitMs, 14, 'f', 1).arg(run.criticalPathMs, 14, 'f', 1).arg(run.utilisation, 6, 'f', 2).arg(run.errorCount, 8) << endl;
+            }
+        }
+
+        if (csv || runs.isEmpty())
+            return;
+        out << endl << "Checks with " << runs.last().threads << " threads:" << endl;
+        out << QStringLiteral("%1 %2 %3 %4").arg(QStringLiteral("check"), -40).arg(QStringLiteral("runs"), 5).arg(QStringLiteral("total ms"), 10).arg(QStringLiteral("longest ms"), 11) << endl;
+        for (const auto &check : runs.last().checks)
+        {
+            out << QStringLiteral("%1 %2 %3 %4").arg(std::get<0>(check), -40).arg(std::get<1>(check), 5).arg(std::get<2>(check), 10, 'f', 1).arg(std::get<3>(check), 11, 'f', 1) << endl;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QgsApplication app(argc, argv, false);
+    QCoreApplication::setApplicationName(QStringLiteral("TopologyCheckerScalingBench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Measures how a check run scales with the number of threads."));
+    parser.addHelpOption();
+    QCommandLineOption featuresOption(QStringLiteral("features"), QStringLiteral("Size of the generated dataset (default 100000)."), QStringLiteral("count"), QStringLiteral("100000"));
+    QCommandLineOption dirOption(QStringLiteral("dir"), QStringLiteral("Directory of the generated dataset (default the current one)."), QStringLiteral("path"), QStringLiteral("."));
+    QCommandLineOption seedOption(QStringLiteral("seed"), QStringLiteral("Seed of the generated dataset (default 1)."), QStringLiteral("number"), QStringLiteral("1"));
+    QCommandLineOption threadsOption(QStringLiteral("threads"), QStringLiteral("Comma separated thread counts (default 1, 2, 4 ... up to the number of cores)."), QStringLiteral("counts"));
+    QCommandLineOption checkOption(QStringLiteral("check"), QStringLiteral("Only run the checks with this name."), QStringLiteral("name"));
+    QCommandLineOption csvOption(QStringLiteral("csv"), QStringLiteral("Print comma separated values."));
+    parser.addOption(featuresOption);
+    parser.addOption(dirOption);
+    parser.addOption(seedOption);
+    parser.addOption(threadsOption);
+    parser.addOption(checkOption);
+    parser.addOption(csvOption);
+    parser.process(app);
+
+    const int featureCount = parser.value(featuresOption).toInt();
+    const QList<int> threadCounts = parser.isSet(threadsOption) ? BenchUtils::parseIntList(parser.value(threadsOption)) : defaultThreadCounts();
+    if (featureCount <= 0 || threadCounts.isEmpty())
+    {
+        err() << "Feature and thread counts must be positive numbers." << endl;
+        return 1;
+    }
+    QStringList names;
+    for (const QString &name : CheckFactory::checkNames())
+    {
+        if (!parser.isSet(checkOption) || name.startsWith(parser.value(checkOption)))
+            names.append(name);
+    }
+
+    QgsApplication::initQgis();
+    const quint32 seed = parser.value(seedOption).toUInt();
+    SyntheticDataset dataset(featureCount, seed);
+    const QString path = QDir(parser.value(dirOption)).filePath(QStringLiteral("synthetic_%1_%2.gpkg").arg(featureCount).arg(seed));
+    QString error;
+    err() << "Writing " << QDir::toNativeSeparators(path) << endl;
+    if (!dataset.write(path, &error))
+    {
+        err() << error << endl;
+        QgsApplication::exitQgis();
+        return 1;
+    }
+    const QList<QgsVectorLayer *> layers = SyntheticDataset::openLayers(path);
+
+    const int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QList<ScalingRun> runs;
+    for (int threads : threadCounts)
+    {
+        err() << "Checking with " << threads << " threads" << endl;
+        runs.append(runPlan(threads, names, layers));
+    }
+    QThreadPool::globalInstance()->setMaxThreadCount(maxThreadCount);
+
+    QTextStream out(stdout);
+    report(out, runs, parser.isSet(csvOption));
+
+    qDeleteAll(layers);
+    QgsApplication::exitQgis();
+    return 0;
+}
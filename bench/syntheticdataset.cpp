@@ -0,0 +1,271 @@
+#include "syntheticdataset.h"
+
+#include <QFile>
+#include <cmath>
+#include <algorithm>
+#include <memory>
+#include <random>
+
+#include <qgscoordinatereferencesystem.h>
+#include <qgscoordinatetransformcontext.h>
+#include <qgsfeature.h>
+#include <qgsgeometry.h>
+#include <qgslinestring.h>
+#include <qgspolygon.h>
+#include <qgsvectorfilewriter.h>
+#include <qgsvectorlayer.h>
+
+#include "check.h"
+#include "checkcontext.h"
+#include "checkfactory.h"
+
+namespace
+{
+    const double CELL_SIZE = 100.0;
+    // Below the tolerance of the benchmarks, which check with a precision of 8 digits
+    const double NEAR_OFFSET = 2e-9;
+
+    // Writes the features of one layer of the dataset
+    class LayerWriter
+    {
+    public:
+        LayerWriter(const QString &fileName, const QString &layerName, QgsWkbTypes::Type type, bool firstLayer)
+        {
+            mFields.append(QgsField(QStringLiteral("code"), QVariant::String, QString(), 20));
+            QgsVectorFileWriter::SaveVectorOptions options;
+            options.driverName = QStringLiteral("GPKG");
+            options.layerName = layerName;
+            options.fileEncoding = QStringLiteral("UTF-8");
+            options.actionOnExistingFile = firstLayer ? QgsVectorFileWriter::CreateOrOverwriteFile : QgsVectorFileWriter::CreateOrOverwriteLayer;
+            mWriter.reset(QgsVectorFileWriter::create(fileName, mFields, type, QgsCoordinateReferenceSystem(QStringLiteral("EPSG:32650")), QgsCoordinateTransformContext(), options));
+            if (!mWriter)
+                mError = QStringLiteral("Could not create layer %1 in %2").arg(layerName, fileName);
+            else if (mWriter->hasError())
+                mError = mWriter->errorMessage();
+        }
+
+        bool add(QgsAbstractGeometry *geometry)
+        {
+            QgsFeature feature(mFields);
+            feature.setGeometry(QgsGeometry(geometry));
+            feature.setAttribute(0, QString::number(mCount));
+            if (!mError.isEmpty() || !mWriter->addFeature(feature))
+            {
+                if (mError.isEmpty())
+                    mError = mWriter->errorMessage();
+                return false;
+            }
+            ++mCount;
+            return true;
+        }
+
+        QString error() const { return mError; }
+        int count() const { return mCount; }
+
+    private:
+        QgsFields mFields;
+        std::unique_ptr<QgsVectorFileWriter> mWriter;
+        QString mError;
+        int mCount = 0;
+    };
+
+    QgsLineString *lineString(const QVector<double> &x, const QVector<double> &y)
+    {
+        return new QgsLineString(x, y);
+    }
+
+    QgsPolygon *polygon(QVector<double> x, QVector<double> y)
+    {
+        x.append(x.first());
+        y.append(y.first());
+        QgsPolygon *polygon = new QgsPolygon();
+        polygon->setExteriorRing(new QgsLineString(x, y));
+        return polygon;
+    }
+}
+
+SyntheticDataset::SyntheticDataset(int featureCount, quint32 seed, double defectRate)
+    : mFeatureCount(featureCount)
+    , mSeed(seed)
+    , mDefectRate(defectRate)
+{
+}
+
+bool SyntheticDataset::write(const QString &fileName, QString *error)
+{
+    mFeatureCounts.clear();
+    mDefectCounts.clear();
+    QFile::remove(fileName);
+
+    const int layerCount = std::max(1, mFeatureCount / 3);
+    const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(layerCount))));
+    std::mt19937 generator(mSeed);
+    std::uniform_real_distribution<double> chance(0, 1);
+    // Returns the defect for the next feature, -1 for none
+    auto defect = [&](int kinds) {
+        return chance(generator) < mDefectRate ? static_cast<int>(generator() % kinds) : -1;
+    };
+    auto fail = [&](const QString &message) {
+        if (error)
+            *error = message;
+        return false;
+    };
+
+    // A coverage of grid cells
+    {
+        LayerWriter writer(fileName, polygonLayerName(), QgsWkbTypes::Polygon, true);
+        for (int k = 0; k < layerCount && writer.error().isEmpty(); ++k)
+        {
+            const double x0 = (k % columns) * CELL_SIZE, y0 = (k / columns) * CELL_SIZE;
+            const double x1 = x0 + CELL_SIZE, y1 = y0 + CELL_SIZE, xm = x0 + CELL_SIZE / 2, ym = y0 + CELL_SIZE / 2;
+            switch (defect(5))
+            {
+            case 0:
+                ++mDefectCounts[QStringLiteral("gap")];
+                writer.add(polygon({x0, x1 - 1, x1 - 1, x0}, {y0, y0, y1, y1}));
+                break;
+            case 1:
+                ++mDefectCounts[QStringLiteral("overlap")];
+                writer.add(polygon({x0, x1 + 1, x1 + 1, x0}, {y0, y0, y1, y1}));
+                break;
+            case 2:
+                // A spike into the cell from its top edge
+                ++mDefectCounts[QStringLiteral("sharp_angle")];
+                writer.add(polygon({x0, x1, x1, xm + 0.5, xm, xm - 0.5, x0}, {y0, y0, y1, y1, y0 + 10, y1, y1}));
+                break;
+            case 3:
+                ++mDefectCounts[QStringLiteral("self_intersection")];
+                writer.add(polygon({x0, x1, x1, x0}, {y0, y1, y0, y1}));
+                break;
+            case 4:
+                // A notch in the right edge, whose vertices on the edge miss the neighbour by less than the tolerance
+                ++mDefectCounts[QStringLiteral("near_vertex_gap")];
+                writer.add(polygon({x0, x1 + NEAR_OFFSET, x1 + NEAR_OFFSET, x1 - 1, x1 + NEAR_OFFSET, x1 + NEAR_OFFSET, x0},
+                                   {y0, y0 - NEAR_OFFSET, ym - 10, ym, ym + 10, y1 + NEAR_OFFSET, y1}));
+                break;
+            default:
+                writer.add(polygon({x0, x1, x1, x0}, {y0, y0, y1, y1}));
+                break;
+            }
+        }
+        if (!writer.error().isEmpty())
+            return fail(writer.error());
+        mFeatureCounts[polygonLayerName()] = writer.count();
+    }
+
+    // The grid edges as street network, alternating horizontal and vertical
+    {
+        LayerWriter writer(fileName, lineLayerName(), QgsWkbTypes::LineString, false);
+        for (int k = 0; k < layerCount && writer.error().isEmpty(); ++k)
+        {
+            const int node = k / 2;
+            const bool horizontal = k % 2 == 0;
+            const double x0 = (node % columns) * CELL_SIZE, y0 = (node / columns) * CELL_SIZE;
+            const double x1 = horizontal ? x0 + CELL_SIZE : x0, y1 = horizontal ? y0 : y0 + CELL_SIZE;
+            const double xm = (x0 + x1) / 2, ym = (y0 + y1) / 2;
+            // Perpendicular to the edge
+            const double px = horizontal ? 0 : 1, py = horizontal ? 1 : 0;
+            switch (defect(4))
+            {
+            case 0:
+                ++mDefectCounts[QStringLiteral("dangle")];
+                writer.add(lineString({x0, x1 - 5 * py}, {y0, y1 - 5 * px}));
+                break;
+            case 1:
+                // Two features meeting in the middle of the edge
+                ++mDefectCounts[QStringLiteral("pseudo_node")];
+                writer.add(lineString({x0, xm}, {y0, ym}));
+                writer.add(lineString({xm, x1}, {ym, y1}));
+                break;
+            case 2:
+                // A loop crossing the edge
+                ++mDefectCounts[QStringLiteral("self_intersection")];
+                writer.add(lineString({x0, xm + 10 * py, xm + 10 * px, xm - 10 * px, x1},
+                                      {y0, ym + 10 * px, ym + 10 * py, ym - 10 * py, y1}));
+                break;
+            case 3:
+                // A turnback in the middle of the edge
+                ++mDefectCounts[QStringLiteral("sharp_angle")];
+                writer.add(lineString({x0, xm, xm - 20 * py + px, x1}, {y0, ym, ym - 20 * px + py, y1}));
+                break;
+            default:
+                writer.add(lineString({x0, x1}, {y0, y1}));
+                break;
+            }
+        }
+        if (!writer.error().isEmpty())
+            return fail(writer.error());
+        mFeatureCounts[lineLayerName()] = writer.count();
+    }
+
+    // The grid nodes
+    {
+        LayerWriter writer(fileName, pointLayerName(), QgsWkbTypes::Point, false);
+        for (int k = 0; k < layerCount && writer.error().isEmpty(); ++k)
+        {
+            const double x = (k % columns) * CELL_SIZE, y = (k / columns) * CELL_SIZE;
+            if (defect(1) == 0)
+            {
+                ++mDefectCounts[QStringLiteral("duplicate_point")];
+                writer.add(new QgsPoint(x, y));
+            }
+            writer.add(new QgsPoint(x, y));
+        }
+        if (!writer.error().isEmpty())
+            return fail(writer.error());
+        mFeatureCounts[pointLayerName()] = writer.count();
+    }
+    return true;
+}
+
+QJsonObject SyntheticDataset::toJson() const
+{
+    QJsonObject features;
+    for (auto it = mFeatureCounts.constBegin(); it != mFeatureCounts.constEnd(); ++it)
+        features.insert(it.key(), it.value());
+    QJsonObject defects;
+    for (auto it = mDefectCounts.constBegin(); it != mDefectCounts.constEnd(); ++it)
+        defects.insert(it.key(), it.value());
+
+    QJsonObject json;
+    json.insert(QStringLiteral("requested_features"), mFeatureCount);
+    json.insert(QStringLiteral("seed"), static_cast<qint64>(mSeed));
+    json.insert(QStringLiteral("defect_rate"), mDefectRate);
+    json.insert(QStringLiteral("features"), features);
+    json.insert(QStringLiteral("defects"), defects);
+    return json;
+}
+
+QList<QgsVectorLayer *> SyntheticDataset::openLayers(const QString &fileName)
+{
+    QList<QgsVectorLayer *> layers;
+    const QgsVectorLayer::LayerOptions options{QgsCoordinateTransformContext()};
+    for (const QString &layerName : {polygonLayerName(), lineLayerName(), pointLayerName()})
+    {
+        layers.append(new QgsVectorLayer(QStringLiteral("%1|layername=%2").arg(fileName, layerName), layerName, QStringLiteral("ogr"), options));
+    }
+    return layers;
+}
+
+Check *SyntheticDataset::createCheck(const QString &name, const QList<QgsVectorLayer *> &layers, CheckContext *context)
+{
+    for (QgsVectorLayer *layer : layers)
+    {
+        CheckSet set(name);
+        set.layersA.insert(layer);
+        for (QgsVectorLayer *other : layers)
+            set.layersB.insert(other);
+        set.attr = QStringLiteral("code");
+        set.angle = 10;
+        set.lowerLimit = 0.1;
+        set.upperLimit = 1000;
+        set.tolerance = context->tolerance;
+        set.setlayersStr();
+
+        Check *check = CheckFactory::createCheck(set, context);
+        if (check && check->compatibleGeometryTypes().contains(layer->geometryType()))
+            return check;
+        delete check;
+    }
+    return nullptr;
+}
@@ -0,0 +1,61 @@
+#ifndef SYNTHETICDATASET_H
+#define SYNTHETICDATASET_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+class Check;
+class CheckContext;
+class QgsVectorLayer;
+
+// Writes a reproducible GeoPackage for the benchmarks.
+//
+// The dataset has three layers on one square grid: "polygons" with a coverage of
+// grid cells, "lines" with the grid edges as street network and "points" on the
+// grid nodes. A share of the features, given by the defect rate, gets one defect
+// each: gaps, overlaps, sharp angles and self-intersections in the polygons, gaps
+// behind vertices which miss those of the neighbour by less than the tolerance,
+// dangles, pseudo nodes, self-intersections and sharp angles in the lines and
+// duplicates in the points. The same size, seed and rate always give the same file.
+class SyntheticDataset
+{
+public:
+    // The layer names, the same for every generated dataset
+    static QString polygonLayerName() { return QStringLiteral("polygons"); }
+    static QString lineLayerName() { return QStringLiteral("lines"); }
+    static QString pointLayerName() { return QStringLiteral("points"); }
+
+    // featureCount is split evenly between the three layers
+    SyntheticDataset(int featureCount, quint32 seed = 1, double defectRate = 0.01);
+
+    // Writes the dataset to fileName, replacing it. Returns false and sets error on failure.
+    bool write(const QString &fileName, QString *error = nullptr);
+
+    // Returns the number of features written per layer
+    QMap<QString, int> featureCounts() const { return mFeatureCounts; }
+
+    // Returns the number of injected defects per kind
+    QMap<QString, int> defectCounts() const { return mDefectCounts; }
+
+    // Returns the parameters and counts of the last write
+    QJsonObject toJson() const;
+
+    // Opens the layers of a dataset written to fileName, the caller takes ownership
+    static QList<QgsVectorLayer *> openLayers(const QString &fileName);
+
+    // Creates the check set of name for the first of layers the check applies to, with all
+    // layers as second layers and parameters which suit the grid. Returns nullptr if the
+    // check applies to none of the layers.
+    static Check *createCheck(const QString &name, const QList<QgsVectorLayer *> &layers, CheckContext *context);
+
+private:
+    const int mFeatureCount;
+    const quint32 mSeed;
+    const double mDefectRate;
+    QMap<QString, int> mFeatureCounts;
+    QMap<QString, int> mDefectCounts;
+};
+
+#endif // SYNTHETICDATASET_H
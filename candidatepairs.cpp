@@ -0,0 +1,115 @@
+#include "candidatepairs.h"
+#include "checkcontext.h"
+#include "checkprofile.h"
+#include "featurepool.h"
+#include "qgscoordinatetransform.h"
+
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <algorithm>
+
+namespace
+{
+  QString pairKey( const QString &layerIdA, const QString &layerIdB, double tolerance )
+  {
+    return layerIdA + QLatin1Char( '|' ) + layerIdB + QLatin1Char( '|' ) + QString::number( tolerance, 'g', 17 );
+  }
+}
+
+QVector<QgsFeatureId> CandidatePairCache::candidates( const QMap<QString, FeaturePool *> &featurePools,
+    const CheckerUtils::LayerFeature &featureA,
+    const QString &layerIdB, double tolerance,
+    const CheckContext *context )
+{
+  std::shared_ptr<Pairs> pairs;
+  {
+    QMutexLocker locker( &mMutex );
+    std::shared_ptr<Pairs> &slot = mPairs[pairKey( featureA.layerId(), layerIdB, tolerance )];
+    if ( !slot )
+    {
+      slot = std::make_shared<Pairs>();
+    }
+    pairs = slot;
+  }
+
+  const QgsFeatureId idA = featureA.feature().id();
+  QVector<QgsFeatureId> ids;
+  bool found = false;
+  {
+    QReadLocker locker( &pairs->lock );
+    auto it = pairs->candidates.constFind( idA );
+    if ( it != pairs->candidates.constEnd() )
+    {
+      ids = it.value();
+      found = true;
+    }
+  }
+
+  if ( !found )
+  {
+    // Looked up without holding the lock, threads asking for the same feature at once both look it up
+    const FeaturePool *featurePoolB = featurePools.value( layerIdB );
+    QgsRectangle bbox = featureA.geometry().boundingBox();
+    bbox.grow( tolerance );
+    const QgsCoordinateTransform ct( featurePoolB->crs(), context->mapCrs, context->transformContext );
+    const QgsFeatureIds intersecting = featurePoolB->getIntersects( ct.transform( bbox, QgsCoordinateTransform::ReverseTransform ) );
+    ids.reserve( intersecting.size() );
+    for ( QgsFeatureId id : intersecting )
+    {
+      ids.append( id );
+    }
+    std::sort( ids.begin(), ids.end() );
+
+    QWriteLocker locker( &pairs->lock );
+    pairs->candidates.insert( idA, ids );
+  }
+
+  if ( CheckProfile::Counters *counters = CheckProfile::Recorder::counters( layerIdB ) )
+  {
+    counters->candidatePairs += ids.size();
+  }
+  return ids;
+}
+
+bool CandidatePairCache::layerFeature( FeaturePool *featurePool, QgsFeatureId id, const CheckContext *context, CheckerUtils::LayerFeature &feature )
+{
+  std::shared_ptr<Features> features;
+  {
+    QMutexLocker locker( &mMutex );
+    std::shared_ptr<Features> &slot = mFeatures[featurePool->layerId()];
+    if ( !slot )
+    {
+      slot = std::make_shared<Features>();
+    }
+    features = slot;
+  }
+
+  {
+    // QCache::object() reorders the cache, reading needs the lock as well
+    QMutexLocker locker( &features->mutex );
+    if ( const CheckerUtils::LayerFeature *cached = features->features.object( id ) )
+    {
+      feature = *cached;
+      return true;
+    }
+  }
+
+  QgsFeature poolFeature;
+  if ( !featurePool->getFeature( id, poolFeature ) || poolFeature.geometry().isNull() )
+  {
+    return false;
+  }
+  // Reprojected once, the other checks comparing the feature get the same geometry
+  feature = CheckerUtils::LayerFeature( featurePool, poolFeature, context, true );
+  QMutexLocker locker( &features->mutex );
+  features->features.insert( id, new CheckerUtils::LayerFeature( feature ) );
+  return true;
+}
+
+void CandidatePairCache::clear()
+{
+  QMutexLocker locker( &mMutex );
+  mPairs.clear();
+  mFeatures.clear();
+}
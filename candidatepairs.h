@@ -0,0 +1,87 @@
+#ifndef CANDIDATEPAIRS_H
+#define CANDIDATEPAIRS_H
+
+#include <QCache>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+#include "qgsfeatureid.h"
+#include "checkerutils.h"
+
+class CheckContext;
+class FeaturePool;
+
+/**
+ * \ingroup analysis
+ * The candidate pairs of the checks comparing the features of a layer with the features
+ * of another or the same layer, shared by the checks of a run.
+ *
+ * The candidates of a feature are the features of the other layer whose bounding box
+ * intersects its own, grown by a tolerance. They are looked up in the spatial index of
+ * the pool when a check first asks for them and kept as sorted feature ids, for each
+ * pair of layers and tolerance. The other checks on the same layers get the same ids
+ * without querying the index again.
+ *
+ * The features handed out by layerFeature() are kept with their geometries in the map
+ * crs, so checks comparing the same features do not fetch and reproject them again.
+ * At most FEATURE_CACHE_SIZE features are kept per layer, the least recently used are
+ * dropped first.
+ *
+ * All methods are thread safe, the checker clears the cache whenever features change.
+ */
+class CandidatePairCache
+{
+  public:
+
+    /**
+     * Returns the ids of the features of the layer \a layerIdB whose bounding box intersects
+     * the bounding box of \a featureA grown by \a tolerance, in ascending order.
+     * The geometry of \a featureA must be in the map crs.
+     */
+    QVector<QgsFeatureId> candidates( const QMap<QString, FeaturePool *> &featurePools,
+                                      const CheckerUtils::LayerFeature &featureA,
+                                      const QString &layerIdB, double tolerance,
+                                      const CheckContext *context );
+
+    /**
+     * Reads the feature \a id of \a featurePool with its geometry in the map crs into \a feature.
+     * Returns FALSE if the feature does not exist or has no geometry.
+     */
+    bool layerFeature( FeaturePool *featurePool, QgsFeatureId id, const CheckContext *context,
+                       CheckerUtils::LayerFeature &feature );
+
+    /**
+     * Drops all pairs and features. To be called whenever the features in the pools change.
+     */
+    void clear();
+
+  private:
+    //! Features kept per layer with their geometries in the map crs
+    static const int FEATURE_CACHE_SIZE = 10000;
+
+    struct Pairs
+    {
+      QReadWriteLock lock;
+      //! Sorted candidates by feature of the first layer
+      QHash<QgsFeatureId, QVector<QgsFeatureId> > candidates;
+    };
+
+    struct Features
+    {
+      Features() : features( FEATURE_CACHE_SIZE ) {}
+      QMutex mutex;
+      QCache<QgsFeatureId, CheckerUtils::LayerFeature> features;
+    };
+
+    QMutex mMutex;
+    //! Pairs by first layer, second layer and tolerance
+    QHash<QString, std::shared_ptr<Pairs> > mPairs;
+    QHash<QString, std::shared_ptr<Features> > mFeatures;
+};
+
+#endif // CANDIDATEPAIRS_H
@@ -41,6 +41,30 @@ bool Check::isCompatible( QgsVectorLayer *layer ) const
   return compatibleGeometryTypes().contains( layer->geometryType() );
 }
 
+void Check::collectFeatureErrors( const CheckerUtils::LayerFeature &layerFeature, CheckErrorSink &errors ) const
+{
+  Q_UNUSED( layerFeature )
+  Q_UNUSED( errors )
+}
+
+QSet<QgsVectorLayer *> Check::configuredLayers() const
+{
+  return mConfiguration.value( QStringLiteral( "layersA" ) ).value<QSet<QgsVectorLayer *> >();
+}
+
+QSet<QgsVectorLayer *> Check::referencedLayers() const
+{
+  QSet<QgsVectorLayer *> layers;
+  for ( const QVariant &value : mConfiguration )
+  {
+    if ( value.userType() == qMetaTypeId<QSet<QgsVectorLayer *> >() )
+    {
+      layers.unite( value.value<QSet<QgsVectorLayer *> >() );
+    }
+  }
+  return layers;
+}
+
 Check::Flags Check::flags() const
 {
   return Check::Flags();
@@ -27,6 +27,7 @@
 #include "qgsgeometry.h"
 #include "checkerutils.h"
 #include "checkresolutionmethod.h"
+#include "checkerrorsink.h"
 #include "qgssettings.h"
 
 class CheckError;
@@ -260,13 +261,38 @@ class Check
 
     /**
      * The main worker method.
-     * Check all features available from \a featurePools and write errors found to \a errors.
+     * Check all features available from \a featurePools and report errors to \a errors as soon as they are found.
      * Other status messages can be written to \a messages.
      * Progress should be reported to \a feedback. Only features and layers listed in \a ids should be checked.
      *
      * \since QGIS 3.4
      */
-    virtual void collectErrors( const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors SIP_INOUT, QStringList &messages SIP_INOUT, QgsFeedback *feedback, const LayerFeatureIds &ids = Check::LayerFeatureIds() ) const = 0;
+    virtual void collectErrors( const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages SIP_INOUT, QgsFeedback *feedback, const LayerFeatureIds &ids = Check::LayerFeatureIds() ) const = 0;
+
+    /**
+     * Returns TRUE if the errors of a feature only depend on the feature itself.
+     * The checker runs all such checks of a layer together in a single pass over its features,
+     * handing each feature to collectFeatureErrors() of every check.
+     */
+    virtual bool isFeatureLocal() const { return false; }
+
+    /**
+     * Reports the errors of the single feature \a layerFeature to \a errors.
+     * Only called for checks which return TRUE from isFeatureLocal(), with features
+     * of the configured layers which have a compatible geometry type.
+     */
+    virtual void collectFeatureErrors( const CheckerUtils::LayerFeature &layerFeature, CheckErrorSink &errors ) const;
+
+    /**
+     * Returns the layers this check has been configured to check, the "layersA" configuration value.
+     */
+    QSet<QgsVectorLayer *> configuredLayers() const;
+
+    /**
+     * Returns all layers in the configuration of this check, the configured layers
+     * and the layers they are checked against.
+     */
+    QSet<QgsVectorLayer *> referencedLayers() const;
 
     /**
      * Fixes the error \a error with the specified \a method.
@@ -321,6 +347,11 @@ class Check
      */
     const CheckContext *context() const { return mContext; }
 
+    /**
+     * Returns the configuration this check has been created with.
+     */
+    const QVariantMap &configuration() const { return mConfiguration; }
+
   protected:
 
     /**
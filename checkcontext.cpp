@@ -14,6 +14,7 @@
  ***************************************************************************/
 
 #include "checkcontext.h"
+#include "candidatepairs.h"
 #include <QThread>
 
 CheckContext::CheckContext( int precision, const QgsCoordinateReferenceSystem &mapCrs, const QgsCoordinateTransformContext &transformContext, const QgsProject *project )
@@ -22,9 +23,14 @@ CheckContext::CheckContext( int precision, const QgsCoordinateReferenceSystem &m
   , mapCrs( mapCrs )
   , transformContext( transformContext )
   , mProject( project )
+  , mErrorTable( new CheckErrorTable() )
+  , mLineNetworks( new LineNetworkCache() )
+  , mCandidatePairs( new CandidatePairCache() )
 {
 }
 
+CheckContext::~CheckContext() = default;
+
 const QgsProject *CheckContext::project() const
 {
   Q_ASSERT( qApp->thread() == QThread::currentThread() );
@@ -20,6 +20,10 @@
 #include "qgscoordinatereferencesystem.h"
 #include "qgscoordinatetransformcontext.h"
 #include "featurepool.h"
+#include "checkerrortable.h"
+#include "linenetwork.h"
+
+class CandidatePairCache;
 
 /**
  * \ingroup analysis
@@ -40,6 +44,8 @@ class CheckContext
                              const QgsCoordinateTransformContext &transformContext,
                              const QgsProject *mProject );
 
+    ~CheckContext();
+
     /**
      * The tolerance to allow for in geometry checks.
      * Will be calculated as pow(10, -precision) in the constructor.
@@ -74,8 +80,29 @@ class CheckContext
      */
     const QgsProject *project() const;
 
+    /**
+     * The storage shared by all errors found with this context.
+     * Can be accessed from any thread.
+     */
+    CheckErrorTable *errorTable() const { return mErrorTable.get(); }
+
+    /**
+     * The line networks shared by the checks of a run.
+     * Can be accessed from any thread, the checker clears it whenever features change.
+     */
+    LineNetworkCache *lineNetworks() const { return mLineNetworks.get(); }
+
+    /**
+     * The candidate pairs and reprojected features shared by the checks of a run comparing features.
+     * Can be accessed from any thread, the checker clears it whenever features change.
+     */
+    CandidatePairCache *candidatePairs() const { return mCandidatePairs.get(); }
+
   private:
     const QgsProject *mProject;
+    std::unique_ptr<CheckErrorTable> mErrorTable;
+    std::unique_ptr<LineNetworkCache> mLineNetworks;
+    std::unique_ptr<CandidatePairCache> mCandidatePairs;
 
   private:
 #ifdef SIP_RUN
@@ -2,6 +2,7 @@
 #include "ui_checkdock.h"
 #include "setuptab.h"
 #include "resulttab.h"
+#include "check.h"
 
 CheckDock::CheckDock(QgisInterface *iface, QWidget *parent)
     : QDockWidget(parent), ui(new Ui::CheckDock)
@@ -59,10 +60,31 @@ void CheckDock::onCheckerStarted( Checker *checker )
     mTabWidget->removeTab( 1 );
     mTabWidget->addTab( new ResultTab( mIface, checker, mTabWidget ), QStringLiteral("检查结果列表") );
     mTabWidget->setTabEnabled( 1, false );
+
+    // Until the results are shown the tab tells how far the run got, and each check in its tooltip
+    connect( checker, &Checker::progressChanged, this, [this, checker]( double progress, qint64 remainingTime ) {
+        if ( mTabWidget->isTabEnabled( 1 ) )
+            return;
+        QString text = QStringLiteral("检查中 %1%").arg( qRound( progress * 100 ) );
+        if ( remainingTime >= 0 )
+        {
+            const qint64 seconds = remainingTime / 1000;
+            text += seconds >= 60 ? QStringLiteral("，剩余 %1 分 %2 秒").arg( seconds / 60 ).arg( seconds % 60 ) : QStringLiteral("，剩余 %1 秒").arg( seconds );
+        }
+        mTabWidget->setTabText( 1, text );
+        QStringList lines;
+        for ( const Check *check : checker->getChecks() )
+        {
+            lines.append( QStringLiteral("%1：%2%").arg( check->description() ).arg( qRound( checker->checkProgress( check ) * 100 ) ) );
+        }
+        mTabWidget->setTabToolTip( 1, lines.join( QLatin1Char( '\n' ) ) );
+    } );
 }
 
 void CheckDock::onCheckerFinished( bool successful )
 {
+    mTabWidget->setTabText( 1, QStringLiteral("检查结果列表") );
+    mTabWidget->setTabToolTip( 1, QString() );
     if ( successful )
     {
         mTabWidget->setTabEnabled( 1, true );
@@ -14,25 +14,100 @@
  *                                                                         *
  ***************************************************************************/
 
-#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+#include <QElapsedTimer>
 #include <QFutureWatcher>
 #include <QMutex>
+#include <QThread>
+#include <QThreadPool>
 #include <QTimer>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <geos_c.h>
 
+#include "candidatepairs.h"
 #include "checkcontext.h"
 #include "checker.h"
 #include "check.h"
 #include "featurepool.h"
+#include "qgsgeos.h"
 #include "qgsproject.h"
 #include "qgsvectorlayer.h"
+#include "qgssettings.h"
 #include "checkerror.h"
+#include "checksnapshot.h"
+#include "checkerrorsink.h"
+#include "checktracer.h"
+#include "tileprefetcher.h"
 
+// GEOS 3.12 lets each thread interrupt the operations of its own context only. Older
+// versions only have a process wide interrupt, which would stop the GEOS operations of
+// other runs and of QGIS itself, they rely on the checks stopping at their next feature.
+#if GEOS_VERSION_MAJOR > 3 || ( GEOS_VERSION_MAJOR == 3 && GEOS_VERSION_MINOR >= 12 )
+#define CHECKER_GEOS_CONTEXT_INTERRUPT
+#endif
+
+namespace
+{
+#ifdef CHECKER_GEOS_CONTEXT_INTERRUPT
+  //! The feedback of the run on the current thread, GEOS operations stop when it is canceled
+  thread_local const QgsFeedback *sRunFeedback = nullptr;
+
+  // Called by GEOS now and then during an operation of the context of the run
+  int interruptCanceledRun( void *feedback )
+  {
+    return static_cast<const QgsFeedback *>( feedback )->isCanceled() ? 1 : 0;
+  }
+#endif
+
+  /**
+   * Lets GEOS operations on the current thread be interrupted by \a feedback while it exists.
+   * Does nothing before GEOS 3.12.
+   */
+  class GeosInterruptScope
+  {
+    public:
+      explicit GeosInterruptScope( const QgsFeedback *feedback )
+      {
+#ifdef CHECKER_GEOS_CONTEXT_INTERRUPT
+        mPrevious = sRunFeedback;
+        sRunFeedback = feedback;
+        mPreviousCallback = GEOSContext_setInterruptCallback_r( QgsGeos::getGEOSHandler(), &interruptCanceledRun, const_cast<QgsFeedback *>( feedback ) );
+#else
+        Q_UNUSED( feedback )
+#endif
+      }
+
+      ~GeosInterruptScope()
+      {
+#ifdef CHECKER_GEOS_CONTEXT_INTERRUPT
+        GEOSContext_setInterruptCallback_r( QgsGeos::getGEOSHandler(), mPreviousCallback, const_cast<QgsFeedback *>( mPrevious ) );
+        sRunFeedback = mPrevious;
+#endif
+      }
+
+    private:
+#ifdef CHECKER_GEOS_CONTEXT_INTERRUPT
+      const QgsFeedback *mPrevious = nullptr;
+      GEOSContextInterruptCallback *mPreviousCallback = nullptr;
+#endif
+  };
+}
 
 Checker::Checker( const QList<Check *> &checks, CheckContext *context, const QMap<QString, FeaturePool *> &featurePools )
   : mChecks( checks )
   , mContext( context )
   , mFeaturePools( featurePools )
 {
+  mRunSink = &mErrorQueue;
+
+  // Hand errors over in batches, whenever enough of them are found or at the latest with the next progress update
+  mErrorQueue.setBatchCallback( ERROR_BATCH_SIZE, [this]
+  {
+    QMetaObject::invokeMethod( this, "drainErrors", Qt::QueuedConnection );
+  } );
+
   for ( auto it = featurePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
   {
     if ( it.value()->layer() )
@@ -60,33 +135,57 @@ Checker::~Checker()
   delete mContext;
 }
 
+void Checker::cancel()
+{
+  // The feedbacks of the runs follow right away
+  mFeedback.cancel();
+}
+
 QFuture<void> Checker::execute( int *totalSteps )
 {
+  // Fixes may have changed the features since the last run
+  mContext->lineNetworks()->clear();
+  mContext->candidatePairs()->clear();
+  mCheckTimings.clear();
+  mProfile.clear();
+  mFeedback.setProgress( 0 );
+  mBusyTime = 0;
+  mThreadTime = 0;
   if ( totalSteps )
   {
-    *totalSteps = 0;
-    for ( Check *check : qgis::as_const( mChecks ) )
-    {
-      for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
-      {
-        if ( check->checkType() <= Check::FeatureCheck )
-        {
-          *totalSteps += check->isCompatible( it.value()->layer() ) ? it.value()->allFeatureIds().size() : 0;
-        }
-        else
-        {
-          *totalSteps += 1;
-        }
-      }
-    }
+    *totalSteps = PROGRESS_STEPS;
   }
 
-  QFuture<void> future = QtConcurrent::map( mChecks, RunCheckWrapper( this ) );
+  QFuture<void> future;
+  if ( !mTiles.isEmpty() )
+  {
+    // Tiles are checked one after the other, the costs of the runs are estimated per tile
+    planRuns();
+    createRunProgress();
+    mRunTimer.start();
+    future = QtConcurrent::run( this, &Checker::runTiles );
+  }
+  else
+  {
+    prepareIncrementalRun();
+    planRuns();
+    splitRuns();
+    createRunProgress();
+    estimateRunCosts();
+    mRunTimer.start();
+    future = QtConcurrent::run( this, &Checker::runScheduled );
+  }
 
   QFutureWatcher<void> *watcher = new QFutureWatcher<void>();
   watcher->setFuture( future );
   QTimer *timer = new QTimer();
   connect( timer, &QTimer::timeout, this, &Checker::emitProgressValue );
+  connect( watcher, &QFutureWatcherBase::finished, this, &Checker::drainErrors );
+  connect( watcher, &QFutureWatcherBase::finished, this, [this]
+  {
+    mContext->lineNetworks()->clear();
+    mContext->candidatePairs()->clear();
+  } );
   connect( watcher, &QFutureWatcherBase::finished, timer, &QObject::deleteLater );
   connect( watcher, &QFutureWatcherBase::finished, watcher, &QObject::deleteLater );
   timer->start( 100 );
@@ -94,26 +193,673 @@ QFuture<void> Checker::execute( int *totalSteps )
   return future;
 }
 
+namespace
+{
+  //! Time in nanoseconds a check took per unit of work in the earlier runs, by check id
+  QMutex sCostHistoryMutex;
+  QHash<QString, double> sCostHistory;
+  bool sCostHistoryLoaded = false;
+
+  //! Kept in the settings, the first run of a session is planned with the costs of the last ones
+  QString costSettingsGroup()
+  {
+    return QStringLiteral( "TopologyChecker/checkCosts" );
+  }
+
+  // Reads the costs of the earlier sessions once, sCostHistoryMutex must be held
+  void loadCostHistory()
+  {
+    if ( sCostHistoryLoaded )
+    {
+      return;
+    }
+    sCostHistoryLoaded = true;
+    QgsSettings settings;
+    settings.beginGroup( costSettingsGroup() );
+    const QStringList ids = settings.childKeys();
+    for ( const QString &id : ids )
+    {
+      const double cost = settings.value( id ).toDouble();
+      if ( cost > 0 )
+      {
+        sCostHistory.insert( id, cost );
+      }
+    }
+  }
+
+  // Time in nanoseconds a check takes per unit of work, as measured by earlier runs or else
+  // guessed from its type. Layer checks look for the neighbours of each feature and compare
+  // geometries, the others look at one geometry at a time.
+  double checkCost( const Check *check )
+  {
+    {
+      QMutexLocker locker( &sCostHistoryMutex );
+      loadCostHistory();
+      auto it = sCostHistory.constFind( check->id() );
+      if ( it != sCostHistory.constEnd() )
+      {
+        return it.value();
+      }
+    }
+    switch ( check->checkType() )
+    {
+      case Check::FeatureNodeCheck:
+        return 50;
+      case Check::FeatureCheck:
+        return 100;
+      case Check::LayerCheck:
+        return 400;
+    }
+    return 100;
+  }
+
+  void learnCheckCost( const Check *check, double nsPerWork )
+  {
+    QMutexLocker locker( &sCostHistoryMutex );
+    loadCostHistory();
+    double &cost = sCostHistory[check->id()];
+    // The last runs count most, the data may have changed since the first ones
+    cost = cost > 0 ? ( cost + nsPerWork ) / 2 : nsPerWork;
+    QgsSettings().setValue( costSettingsGroup() + QLatin1Char( '/' ) + check->id(), cost );
+  }
+
+  // Returns the part-th of partCount slices of ids. The slices follow the spatial order,
+  // so the neighbours of the features of a slice stay in the cache of its thread.
+  QgsFeatureIds featureSlice( const FeaturePool *featurePool, const QgsFeatureIds &ids, int part, int partCount )
+  {
+    if ( partCount <= 1 || !featurePool || ids.isEmpty() )
+    {
+      return ids;
+    }
+    const QList<QgsFeatureId> ordered = featurePool->spatiallyOrdered( ids );
+    const int begin = static_cast<int>( static_cast<qint64>( ordered.size() ) * part / partCount );
+    const int end = static_cast<int>( static_cast<qint64>( ordered.size() ) * ( part + 1 ) / partCount );
+    QgsFeatureIds slice;
+    slice.reserve( end - begin );
+    for ( int i = begin; i < end; ++i )
+    {
+      slice.insert( ordered.at( i ) );
+    }
+    return slice;
+  }
+}
+
+double Checker::estimateWork( const CheckRun &run, double *steps ) const
+{
+  // A unit of work is a feature or one of its vertices
+  double work = 0;
+  *steps = 0;
+  if ( !run.layerId.isEmpty() )
+  {
+    // Every feature is handed to each check of the run
+    const FeaturePool *featurePool = mFeaturePools.value( run.layerId );
+    const int featureCount = run.incremental ? mRecheckIds.ids.value( run.layerId ).size() : featurePool->allFeatureIds().size();
+    *steps = static_cast<double>( featureCount ) * run.checks.size();
+    return featureCount * ( 1 + featurePool->averageVertexCount() );
+  }
+
+  // Only the features of the configured layers are handed to the check, layer checks
+  // iterate over them as well. Runs on the check threads for tiled runs, the layers
+  // are only compared, not accessed.
+  const Check *check = run.checks.first();
+  const QSet<QgsVectorLayer *> layers = check->configuredLayers();
+  const Check::LayerFeatureIds ids = scopedFeatureIds( check, run.incremental );
+  for ( auto it = ids.ids.constBegin(); it != ids.ids.constEnd(); ++it )
+  {
+    const FeaturePool *featurePool = mFeaturePools.value( it.key() );
+    QgsVectorLayer *layer = featurePool->layerPtr().data();
+    if ( layers.contains( layer ) && ( check->checkType() == Check::LayerCheck || check->isCompatible( layer ) ) )
+    {
+      *steps += it.value().size();
+      work += it.value().size() * ( 1 + featurePool->averageVertexCount() );
+    }
+  }
+  return work;
+}
+
+void Checker::splitRuns()
+{
+  // Runs costing more than a fair share of a thread are split into parts, so that the threads
+  // finish at about the same time. Only feature local checks look at each feature on its own,
+  // the others may look at more than the features they are given, like the nodes of a line
+  // network, and would report what they find there in every part.
+  const int threads = QThreadPool::globalInstance()->maxThreadCount();
+  if ( threads < 2 )
+  {
+    return;
+  }
+  QVector<double> costs;
+  QVector<double> featureCounts;
+  double totalCost = 0;
+  for ( const CheckRun &run : qgis::as_const( mRuns ) )
+  {
+    double steps = 0;
+    double cost = 0;
+    const double work = estimateWork( run, &steps );
+    for ( const Check *check : run.checks )
+    {
+      cost += work * checkCost( check );
+    }
+    costs.append( cost );
+    featureCounts.append( steps / run.checks.size() );
+    totalCost += cost;
+  }
+
+  const int maxParts = threads * PARTS_PER_THREAD;
+  const double partCost = totalCost / maxParts;
+  QList<CheckRun> runs;
+  for ( int i = 0; i < mRuns.size(); ++i )
+  {
+    const CheckRun &run = mRuns.at( i );
+    const bool splittable = !run.layerId.isEmpty();
+    int partCount = 1;
+    if ( splittable && partCost > 0 && costs.at( i ) > partCost )
+    {
+      const int minPartFeatures = MIN_PART_FEATURES;
+      partCount = std::min( { static_cast<int>( std::ceil( costs.at( i ) / partCost ) ), maxParts, static_cast<int>( featureCounts.at( i ) ) / minPartFeatures } );
+      partCount = std::max( partCount, 1 );
+    }
+    for ( int part = 0; part < partCount; ++part )
+    {
+      CheckRun partRun = run;
+      partRun.part = part;
+      partRun.partCount = partCount;
+      runs.append( partRun );
+    }
+  }
+  mRuns = runs;
+}
+
+void Checker::createRunProgress()
+{
+  // Each run reports its progress to a feedback of its own, all of them stop when the checker is canceled
+  mRunProgress.clear();
+  for ( int i = 0; i < mRuns.size(); ++i )
+  {
+    mRuns[i].index = i;
+    mRunProgress.emplace_back( new RunProgress() );
+    connect( &mFeedback, &QgsFeedback::canceled, &mRunProgress.back()->feedback, &QgsFeedback::cancel, Qt::DirectConnection );
+    // A cancel before the run started is not signaled again
+    if ( mFeedback.isCanceled() )
+    {
+      mRunProgress.back()->feedback.cancel();
+    }
+  }
+}
+
+void Checker::estimateRunCosts()
+{
+  for ( const CheckRun &run : qgis::as_const( mRuns ) )
+  {
+    RunProgress &progress = *mRunProgress[run.index];
+    double steps = 0;
+    const double work = estimateWork( run, &steps ) / run.partCount;
+    double cost = 0;
+    for ( const Check *check : run.checks )
+    {
+      cost += work * checkCost( check );
+    }
+    progress.steps = steps / run.partCount;
+    progress.work = work;
+    // Runs without features still take a moment
+    progress.cost = std::max( cost, 1. );
+  }
+  resetRunProgress();
+}
+
+void Checker::runScheduled()
+{
+  // Longest runs first: the expensive runs start right away and the cheap ones fill up the threads at the end
+  QVector<int> order( mRuns.size() );
+  std::iota( order.begin(), order.end(), 0 );
+  std::stable_sort( order.begin(), order.end(), [this]( int a, int b )
+  {
+    return mRunProgress[a]->cost > mRunProgress[b]->cost;
+  } );
+
+  // Threads take the next run from the shared queue whenever they are done with one,
+  // none of them idles while runs are left
+  std::atomic<int> next( 0 );
+  std::atomic<qint64> busyTime( 0 );
+  auto work = [this, &order, &next, &busyTime]
+  {
+    RunCheckWrapper wrapper( this );
+    QElapsedTimer timer;
+    for ( int i = next++; i < order.size(); i = next++ )
+    {
+      timer.start();
+      wrapper( mRuns.at( order.at( i ) ) );
+      busyTime += timer.nsecsElapsed();
+    }
+  };
+
+  const int threads = std::max( 1, std::min( QThreadPool::globalInstance()->maxThreadCount(), order.size() ) );
+  QElapsedTimer timer;
+  timer.start();
+  QList<QFuture<void> > workers;
+  for ( int i = 1; i < threads; ++i )
+  {
+    workers.append( QtConcurrent::run( work ) );
+  }
+  // The calling thread checks as well
+  work();
+  for ( QFuture<void> &worker : workers )
+  {
+    worker.waitForFinished();
+  }
+  mBusyTime += busyTime;
+  mThreadTime += timer.nsecsElapsed() * threads;
+}
+
+double Checker::utilisation() const
+{
+  return mThreadTime > 0 ? static_cast<double>( mBusyTime ) / mThreadTime : 0.;
+}
+
+void Checker::resetRunProgress()
+{
+  for ( const std::unique_ptr<RunProgress> &progress : mRunProgress )
+  {
+    progress->feedback.setProgress( 0 );
+    progress->finished = false;
+  }
+}
+
+double Checker::runsProgress( const Check *check ) const
+{
+  double done = 0;
+  double total = 0;
+  for ( const CheckRun &run : mRuns )
+  {
+    if ( check && !run.checks.contains( check ) )
+    {
+      continue;
+    }
+    const RunProgress &progress = *mRunProgress[run.index];
+    double fraction = 0;
+    if ( progress.finished )
+    {
+      fraction = 1;
+    }
+    else if ( progress.steps > 0 )
+    {
+      // Some layer checks go over their features more than once
+      fraction = std::min( progress.feedback.progress() / progress.steps, 1. );
+    }
+    done += progress.cost * fraction;
+    total += progress.cost;
+  }
+  const double fraction = total > 0 ? done / total : 0;
+  if ( mTiles.isEmpty() )
+  {
+    return fraction;
+  }
+  // The feedback of the checker counts the finished tiles
+  return std::min( ( mFeedback.progress() + fraction ) / mTiles.size(), 1. );
+}
+
+double Checker::progress() const
+{
+  return runsProgress( nullptr );
+}
+
+double Checker::checkProgress( const Check *check ) const
+{
+  return runsProgress( check );
+}
+
+qint64 Checker::remainingTime() const
+{
+  const double done = progress();
+  // Too little is done for the elapsed time to tell
+  if ( !mRunTimer.isValid() || done < 0.01 )
+  {
+    return -1;
+  }
+  if ( done >= 1 )
+  {
+    return 0;
+  }
+  return static_cast<qint64>( mRunTimer.elapsed() * ( 1 - done ) / done );
+}
+
+void Checker::planRuns()
+{
+  // Feature local checks of the same layer share one pass over its features,
+  // every other check runs on its own
+  mRuns.clear();
+  QMap<QPair<QString, bool>, int> layerRuns;
+  for ( const Check *check : qgis::as_const( mChecks ) )
+  {
+    const bool incremental = mIncrementalChecks.contains( check );
+    if ( !check->isFeatureLocal() )
+    {
+      CheckRun run;
+      run.checks.append( check );
+      run.incremental = incremental;
+      mRuns.append( run );
+      continue;
+    }
+    const QSet<QgsVectorLayer *> layers = check->configuredLayers();
+    for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
+    {
+      QgsVectorLayer *layer = it.value()->layer();
+      if ( !layer || !layers.contains( layer ) || !check->isCompatible( layer ) )
+      {
+        continue;
+      }
+      const QPair<QString, bool> key( it.key(), incremental );
+      auto runIt = layerRuns.constFind( key );
+      if ( runIt == layerRuns.constEnd() )
+      {
+        runIt = layerRuns.insert( key, mRuns.size() );
+        CheckRun run;
+        run.layerId = it.key();
+        run.incremental = incremental;
+        mRuns.append( run );
+      }
+      mRuns[runIt.value()].checks.append( check );
+    }
+  }
+}
+
+void Checker::setSnapshotPath( const QString &path )
+{
+  mSnapshotPath = path;
+  mLayerKeys.clear();
+  mCheckKeys.clear();
+  for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
+  {
+    mLayerKeys.insert( it.key(), CheckSnapshot::layerKey( it.value()->layer() ) );
+  }
+  // The same check may be configured more than once, number the occurrences
+  QHash<QString, int> occurrences;
+  for ( const Check *check : qgis::as_const( mChecks ) )
+  {
+    const QString key = CheckSnapshot::checkKey( check );
+    mCheckKeys.insert( check, key + QStringLiteral( "#%1" ).arg( occurrences[key]++ ) );
+  }
+}
+
+void Checker::prepareIncrementalRun()
+{
+  mIncrementalChecks.clear();
+  mRecheckIds = Check::LayerFeatureIds();
+  mRecheckArea = QgsRectangle();
+  mSkippedFeatureCount = 0;
+
+  if ( mSnapshotPath.isEmpty() )
+  {
+    return;
+  }
+  CheckSnapshot snapshot;
+  if ( !snapshot.read( mSnapshotPath ) || !snapshot.isCompatible( CheckSnapshot( mContext->mapCrs.toWkt(), mContext->tolerance ) ) )
+  {
+    return;
+  }
+
+  // Collect the area covered by new, changed and removed features
+  QgsRectangle changedArea;
+  try
+  {
+    for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
+    {
+      QgsCoordinateTransform t( it.value()->crs(), mContext->mapCrs, mContext->transformContext );
+      const QHash<QgsFeatureId, FeaturePool::FeatureFingerprint> oldFingerprints = snapshot.fingerprints( mLayerKeys.value( it.key() ) );
+      // Hashes all the features once, saveSnapshot() reuses them and only hashes the fixed ones
+      const QHash<QgsFeatureId, FeaturePool::FeatureFingerprint> newFingerprints = it.value()->fingerprints();
+      for ( auto fit = newFingerprints.constBegin(); fit != newFingerprints.constEnd(); ++fit )
+      {
+        auto oldIt = oldFingerprints.constFind( fit.key() );
+        if ( oldIt != oldFingerprints.constEnd() && oldIt.value().hash == fit.value().hash )
+        {
+          continue;
+        }
+        changedArea.combineExtentWith( t.transformBoundingBox( fit.value().bbox ) );
+        if ( oldIt != oldFingerprints.constEnd() )
+        {
+          changedArea.combineExtentWith( t.transformBoundingBox( oldIt.value().bbox ) );
+        }
+      }
+      for ( auto oldIt = oldFingerprints.constBegin(); oldIt != oldFingerprints.constEnd(); ++oldIt )
+      {
+        if ( !newFingerprints.contains( oldIt.key() ) )
+        {
+          changedArea.combineExtentWith( t.transformBoundingBox( oldIt.value().bbox ) );
+        }
+      }
+    }
+  }
+  catch ( const QgsCsException & )
+  {
+    QMutexLocker locker( &mErrorListMutex );
+    mMessages.append( tr( "Could not compare with the previous results, all features are checked" ) );
+    return;
+  }
+
+  // Grow it by the layer check errors it touches, like when rechecking after a fix
+  mRecheckArea = changedArea;
+  if ( !changedArea.isNull() )
+  {
+    for ( const Check *check : qgis::as_const( mChecks ) )
+    {
+      if ( check->checkType() != Check::LayerCheck )
+      {
+        continue;
+      }
+      const QList<CheckSnapshot::StoredError> storedErrors = snapshot.errors( mCheckKeys.value( check ) );
+      for ( const CheckSnapshot::StoredError &stored : storedErrors )
+      {
+        if ( stored.affectedArea.intersects( changedArea ) )
+        {
+          mRecheckArea.combineExtentWith( stored.affectedArea );
+        }
+      }
+    }
+    mRecheckArea.grow( 10 * mContext->tolerance );
+  }
+
+  // Features to recheck: all the features in that area, their neighbours may have changed
+  int featureCount = 0;
+  for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
+  {
+    featureCount += it.value()->allFeatureIds().size();
+    QgsFeatureIds &ids = mRecheckIds.ids[it.key()];
+    if ( !mRecheckArea.isNull() )
+    {
+      QgsCoordinateTransform t( mContext->mapCrs, it.value()->crs(), mContext->transformContext );
+      try
+      {
+        ids = it.value()->getIntersects( t.transformBoundingBox( mRecheckArea ) );
+      }
+      catch ( const QgsCsException & )
+      {
+        ids = it.value()->allFeatureIds();
+      }
+    }
+    featureCount -= ids.size();
+  }
+  mSkippedFeatureCount = featureCount;
+
+  // Restore the errors outside of the rechecked area
+  QList<CheckError *> restoredErrors;
+  for ( const Check *check : qgis::as_const( mChecks ) )
+  {
+    const QString checkKey = mCheckKeys.value( check );
+    if ( !snapshot.hasCheck( checkKey ) )
+    {
+      // Not run before with this configuration, check everything
+      continue;
+    }
+    mIncrementalChecks.insert( check );
+    const QList<CheckSnapshot::StoredError> storedErrors = snapshot.errors( checkKey );
+    for ( const CheckSnapshot::StoredError &stored : storedErrors )
+    {
+      const QString layerId = mLayerKeys.key( stored.layerKey );
+      if ( layerId.isEmpty() )
+      {
+        continue;
+      }
+      bool reuse = false;
+      if ( check->checkType() == Check::LayerCheck )
+      {
+        reuse = mRecheckArea.isNull() || !mRecheckArea.intersects( stored.affectedArea );
+      }
+      else
+      {
+        reuse = mFeaturePools[layerId]->allFeatureIds().contains( stored.featureId ) && !mRecheckIds.ids.value( layerId ).contains( stored.featureId );
+      }
+      if ( reuse )
+      {
+        restoredErrors.append( new SnapshotCheckError( check, layerId, stored ) );
+      }
+    }
+  }
+
+  mErrorQueue.appendAll( restoredErrors );
+}
+
+bool Checker::saveSnapshot()
+{
+  // Spilled errors are not kept, a snapshot without them would lose them on the next run.
+  // Tiled runs release the features, there is nothing to take fingerprints from.
+  if ( mSnapshotPath.isEmpty() || spilledErrorCount() > 0 || !mTiles.isEmpty() )
+  {
+    return false;
+  }
+
+  CheckSnapshot snapshot( mContext->mapCrs.toWkt(), mContext->tolerance );
+  for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
+  {
+    // The pools kept the hashes of prepareIncrementalRun(), only features changed since are read again
+    snapshot.setFingerprints( mLayerKeys.value( it.key() ), it.value()->fingerprints() );
+  }
+  for ( const Check *check : qgis::as_const( mChecks ) )
+  {
+    snapshot.addCheck( mCheckKeys.value( check ) );
+  }
+
+  QMutexLocker locker( &mErrorListMutex );
+  for ( const CheckError *error : qgis::as_const( mCheckErrors ) )
+  {
+    if ( error->status() == CheckError::StatusPending || error->status() == CheckError::StatusFixFailed )
+    {
+      snapshot.addError( mCheckKeys.value( error->check() ), mLayerKeys.value( error->layerId() ), error );
+    }
+  }
+  return snapshot.write( mSnapshotPath );
+}
+
+CheckError *Checker::findLiveError( const CheckError *error )
+{
+  const Check *check = error->check();
+  QMap<QString, QgsFeatureIds> ids;
+  if ( check->checkType() == Check::LayerCheck || error->featureId() == FID_NULL )
+  {
+    QgsRectangle area = error->affectedAreaBBox();
+    area.grow( 10 * mContext->tolerance );
+    for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
+    {
+      QgsCoordinateTransform t( mContext->mapCrs, it.value()->crs(), mContext->transformContext );
+      ids[it.key()] = it.value()->getIntersects( t.transformBoundingBox( area ) );
+    }
+  }
+  else
+  {
+    ids[error->layerId()].insert( error->featureId() );
+  }
+
+  CheckErrorListSink sink;
+  QStringList messages;
+  check->collectErrors( mFeaturePools, sink, messages, nullptr, ids );
+  const QList<CheckError *> candidates = sink.takeErrors();
+
+  CheckError *liveError = nullptr;
+  for ( CheckError *candidate : qgis::as_const( candidates ) )
+  {
+    if ( !liveError &&
+         candidate->layerId() == error->layerId() &&
+         candidate->featureId() == error->featureId() &&
+         candidate->vidx() == error->vidx() &&
+         candidate->location().sqrDist( error->location() ) <= mContext->tolerance * mContext->tolerance )
+    {
+      liveError = candidate;
+    }
+    else
+    {
+      delete candidate;
+    }
+  }
+  return liveError;
+}
+
 void Checker::emitProgressValue()
 {
-  emit progressValue( mFeedback.progress() );
+  drainErrors();
+  const double done = progress();
+  emit progressValue( static_cast<int>( done * PROGRESS_STEPS ) );
+  emit progressChanged( done, remainingTime() );
 }
 
 bool Checker::fixError( CheckError *error, int method, bool triggerRepaint )
 {
+  CheckTracer::Span span( "fixError", "fix" );
+  if ( span.isRecording() )
+    span.setDetail( error->check()->id() );
   mMessages.clear();
   if ( error->status() >= CheckError::StatusFixed )
   {
     return true;
   }
+  if ( !canFixErrors() )
+  {
+    // The features of a tiled run have been released, fixes and rechecks would find none
+    error->setFixFailed( tr( "Errors of a tiled run can not be fixed" ) );
+    emit errorUpdated( error, true );
+    return false;
+  }
 #if 0
   QTextStream( stdout ) << "Fixing " << error->description() << ": " << error->layerId() << ":" << error->featureId() << " @[" << error->vidx().part << ", " << error->vidx().ring << ", " << error->vidx().vertex << "](" << error->location().x() << ", " << error->location().y() << ") = " << error->value().toString() << endl;
 #endif
 
+  // Errors restored from a snapshot need to be found again before they can be fixed
+  std::unique_ptr<CheckError> liveError;
+  if ( dynamic_cast<SnapshotCheckError *>( error ) )
+  {
+    liveError.reset( findLiveError( error ) );
+    if ( !liveError )
+    {
+      error->setObsolete();
+      emit errorUpdated( error, true );
+      return false;
+    }
+  }
+
   Check::Changes changes;
   QgsRectangle recheckArea = error->affectedAreaBBox();
 
-  error->check()->fixError( mFeaturePools, error, method, mMergeAttributeIndices, changes );
+  if ( liveError )
+  {
+    error->check()->fixError( mFeaturePools, liveError.get(), method, mMergeAttributeIndices, changes );
+    switch ( liveError->status() )
+    {
+      case CheckError::StatusFixed:
+        error->setFixed( method );
+        break;
+      case CheckError::StatusFixFailed:
+        error->setFixFailed( liveError->resolutionMessage() );
+        break;
+      case CheckError::StatusObsolete:
+        error->setObsolete();
+        break;
+      case CheckError::StatusPending:
+        break;
+    }
+  }
+  else
+  {
+    error->check()->fixError( mFeaturePools, error, method, mMergeAttributeIndices, changes );
+  }
 #if 0
   QTextStream( stdout ) << " * Status: " << error->resolutionMessage() << endl;
   static QVector<QString> strChangeWhat = { "ChangeFeature", "ChangePart", "ChangeRing", "ChangeNode" };
@@ -140,6 +886,9 @@ bool Checker::fixError( CheckError *error, int method, bool triggerRepaint )
   {
     return true;
   }
+  // The rechecks must not compare the changed features with what was cached before the fix
+  mContext->lineNetworks()->clear();
+  mContext->candidatePairs()->clear();
 
   // Determine what to recheck
   // - Collect all features which were changed, get affected area
@@ -192,24 +941,28 @@ bool Checker::fixError( CheckError *error, int method, bool triggerRepaint )
   }
 
   // Recheck feature / changed area to detect new errors
-  QList<CheckError *> recheckErrors;
-  for ( const Check *check : qgis::as_const( mChecks ) )
+  CheckErrorListSink recheckSink;
   {
-    if ( check->checkType() == Check::LayerCheck )
+    CheckTracer::Span recheckSpan( "recheck", "fix" );
+    for ( const Check *check : qgis::as_const( mChecks ) )
     {
-      if ( !recheckAreaFeatures.isEmpty() )
+      if ( check->checkType() == Check::LayerCheck )
       {
-        check->collectErrors( mFeaturePools, recheckErrors, mMessages, nullptr, recheckAreaFeatures );
+        if ( !recheckAreaFeatures.isEmpty() )
+        {
+          check->collectErrors( mFeaturePools, recheckSink, mMessages, nullptr, recheckAreaFeatures );
+        }
       }
-    }
-    else
-    {
-      if ( !recheckFeatures.isEmpty() )
+      else
       {
-        check->collectErrors( mFeaturePools, recheckErrors, mMessages, nullptr, recheckFeatures );
+        if ( !recheckFeatures.isEmpty() )
+        {
+          check->collectErrors( mFeaturePools, recheckSink, mMessages, nullptr, recheckFeatures );
+        }
       }
     }
   }
+  QList<CheckError *> recheckErrors = recheckSink.takeErrors();
 
   // Go through error list, update other errors of the checked feature
   for ( CheckError *err : qgis::as_const( mCheckErrors ) )
@@ -262,10 +1015,10 @@ bool Checker::fixError( CheckError *error, int method, bool triggerRepaint )
   }
 
   // Add new errors
-  for ( CheckError *recheckErr : qgis::as_const( recheckErrors ) )
+  mCheckErrors.append( recheckErrors );
+  if ( !recheckErrors.isEmpty() )
   {
-    emit errorAdded( recheckErr );
-    mCheckErrors.append( recheckErr );
+    emit errorsAdded( recheckErrors );
   }
 
   if ( triggerRepaint )
@@ -279,20 +1032,396 @@ bool Checker::fixError( CheckError *error, int method, bool triggerRepaint )
   return true;
 }
 
-void Checker::runCheck( const QMap<QString, FeaturePool *> &featurePools, const Check *check )
+namespace
+{
+  /**
+   * Passes on the errors intersecting an area and drops all others.
+   */
+  class AreaFilterSink : public CheckErrorSink
+  {
+    public:
+      AreaFilterSink( CheckErrorSink &sink, const QgsRectangle &area )
+        : mSink( sink )
+        , mArea( area )
+      {}
+
+      void append( CheckError *error ) override
+      {
+        if ( mArea.intersects( error->affectedAreaBBox() ) )
+        {
+          mSink.append( error );
+        }
+        else
+        {
+          delete error;
+        }
+      }
+
+    private:
+      CheckErrorSink &mSink;
+      QgsRectangle mArea;
+  };
+
+  /**
+   * Passes on the errors located in a tile and drops all others.
+   * Tiles include their lower and exclude their upper borders, to report errors on a border once.
+   */
+  class TileSink : public CheckErrorSink
+  {
+    public:
+      TileSink( CheckErrorSink &sink, const QgsRectangle &tile )
+        : mSink( sink )
+        , mTile( tile )
+      {}
+
+      void append( CheckError *error ) override
+      {
+        const QgsPointXY location = error->location();
+        if ( location.x() >= mTile.xMinimum() && location.x() < mTile.xMaximum() &&
+             location.y() >= mTile.yMinimum() && location.y() < mTile.yMaximum() )
+        {
+          mSink.append( error );
+        }
+        else
+        {
+          delete error;
+        }
+      }
+
+    private:
+      CheckErrorSink &mSink;
+      QgsRectangle mTile;
+  };
+}
+
+Check::LayerFeatureIds Checker::scopedFeatureIds( const Check *check, bool incremental ) const
 {
-  // Run checks
-  QList<CheckError *> errors;
+  // The features of the configured layers. The layers they are checked against are
+  // listed without features, checks look up their features by layer id when needed.
+  // Runs on the check threads, the layers are only compared, not accessed.
+  const QSet<QgsVectorLayer *> checkedLayers = check->configuredLayers();
+  const QSet<QgsVectorLayer *> referencedLayers = check->referencedLayers();
+  QMap<QString, QgsFeatureIds> ids;
+  for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
+  {
+    QgsVectorLayer *layer = it.value()->layerPtr().data();
+    if ( checkedLayers.contains( layer ) )
+    {
+      ids.insert( it.key(), incremental ? mRecheckIds.ids.value( it.key() ) : it.value()->allFeatureIds() );
+    }
+    else if ( referencedLayers.contains( layer ) )
+    {
+      ids.insert( it.key(), QgsFeatureIds() );
+    }
+  }
+  return ids;
+}
+
+void Checker::runCheck( const QMap<QString, FeaturePool *> &featurePools, const CheckRun &run, QgsFeedback *feedback )
+{
+  const Check *check = run.checks.first();
+  // Run checks, errors are handed over to the main thread while the check is running
+  CheckTracer::Span span( "runCheck", "check" );
+  if ( span.isRecording() )
+    span.setDetail( check->id() );
   QStringList messages;
-  check->collectErrors( featurePools, errors, messages, &mFeedback );
-  mErrorListMutex.lock();
-  mCheckErrors.append( errors );
+  const bool incremental = mIncrementalChecks.contains( check );
+  Check::LayerFeatureIds ids = scopedFeatureIds( check, incremental );
+  for ( auto it = ids.ids.begin(); it != ids.ids.end(); ++it )
+  {
+    it.value() = featureSlice( featurePools.value( it.key() ), it.value(), run.part, run.partCount );
+  }
+  bool hasFeatures = false;
+  for ( auto it = ids.ids.constBegin(); it != ids.ids.constEnd(); ++it )
+  {
+    hasFeatures |= !it.value().isEmpty();
+  }
+  // An empty id map would mean all features of all layers
+  if ( !hasFeatures )
+  {
+    return;
+  }
+  if ( incremental && check->checkType() == Check::LayerCheck )
+  {
+    // Errors outside of the rechecked area have been restored from the snapshot
+    AreaFilterSink sink( *mRunSink, mRecheckArea );
+    check->collectErrors( featurePools, sink, messages, feedback, ids );
+  }
+  else
+  {
+    check->collectErrors( featurePools, *mRunSink, messages, feedback, ids );
+  }
+  mErrorListWait.lock( mErrorListMutex );
   mMessages.append( messages );
   mErrorListMutex.unlock();
-  for ( CheckError *error : qgis::as_const( errors ) )
+}
+
+void Checker::runFeatureLocalChecks( const QMap<QString, FeaturePool *> &featurePools, const CheckRun &run )
+{
+  CheckTracer::Span span( "runFeatureLocalChecks", "check" );
+  if ( span.isRecording() )
+    span.setDetail( run.layerId );
+  FeaturePool *featurePool = featurePools.value( run.layerId );
+  QMap<QString, QgsFeatureIds> featureIds;
+  featureIds.insert( run.layerId, featureSlice( featurePool, run.incremental ? mRecheckIds.ids.value( run.layerId ) : featurePool->allFeatureIds(), run.part, run.partCount ) );
+
+  // Each feature is fetched once and handed to all checks, the iteration counts one step per feature
+  const double extraSteps = run.checks.size() - 1;
+  QgsFeedback *feedback = &mRunProgress[run.index]->feedback;
+  CheckerUtils::LayerFeatures layerFeatures( featurePools, featureIds, { featurePool->geometryType() }, feedback, mContext );
+  for ( const CheckerUtils::LayerFeature &layerFeature : layerFeatures )
+  {
+    for ( const Check *check : run.checks )
+    {
+      CheckProfile::Recorder::setCheck( check );
+      check->collectFeatureErrors( layerFeature, *mRunSink );
+    }
+    // Fetching the features is shared by all checks of the run
+    CheckProfile::Recorder::setCheck( nullptr );
+    feedback->setProgress( feedback->progress() + extraSteps );
+  }
+}
+
+void Checker::setMemoryBudget( qint64 bytes )
+{
+  mMemoryBudget = bytes;
+  mTiles.clear();
+  mTileMargin = 0;
+  if ( bytes <= 0 )
+  {
+    return;
+  }
+
+  QgsRectangle extent;
+  qint64 featureBytes = 0;
+  for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
+  {
+    QgsVectorLayer *layer = it.value()->layer();
+    if ( !layer )
+    {
+      continue;
+    }
+    QgsCoordinateTransform t( it.value()->crs(), mContext->mapCrs, mContext->transformContext );
+    try
+    {
+      extent.combineExtentWith( t.transformBoundingBox( layer->extent() ) );
+    }
+    catch ( const QgsCsException & )
+    {
+      mMessages.append( tr( "Could not determine the extent of layer %1" ).arg( layer->name() ) );
+      continue;
+    }
+    featureBytes += std::max<qint64>( layer->featureCount(), 0 ) * it.value()->estimateFeatureSize();
+  }
+  if ( extent.isNull() )
+  {
+    return;
+  }
+
+  // Assume evenly spread features, a tile loads its margin on all sides as well.
+  // The tiles read ahead are held next to the current one, they share the budget.
+  const double loadFactor = ( 1 + 2 * TILE_MARGIN ) * ( 1 + 2 * TILE_MARGIN );
+  const qint64 tileBytes = std::max<qint64>( 1, bytes / ( std::max( 0, mPrefetchDepth ) + 1 ) );
+  const int tileCount = std::max( 1, static_cast<int>( std::ceil( featureBytes * loadFactor / tileBytes ) ) );
+  const int n = static_cast<int>( std::ceil( std::sqrt( static_cast<double>( tileCount ) ) ) );
+  const double width = extent.width() / n;
+  const double height = extent.height() / n;
+  mTileMargin = TILE_MARGIN * std::max( width, height ) + 10 * mContext->tolerance;
+
+  // Rows are walked back and forth, so that each tile is next to the previous one.
+  // The outer tiles reach beyond the extent to take errors located on its border.
+  for ( int row = 0; row < n; ++row )
+  {
+    for ( int i = 0; i < n; ++i )
+    {
+      const int col = row % 2 == 0 ? i : n - 1 - i;
+      QgsRectangle tile( extent.xMinimum() + col * width, extent.yMinimum() + row * height,
+                         extent.xMinimum() + ( col + 1 ) * width, extent.yMinimum() + ( row + 1 ) * height );
+      if ( col == 0 )
+        tile.setXMinimum( tile.xMinimum() - mTileMargin );
+      if ( col == n - 1 )
+        tile.setXMaximum( tile.xMaximum() + mTileMargin );
+      if ( row == 0 )
+        tile.setYMinimum( tile.yMinimum() - mTileMargin );
+      if ( row == n - 1 )
+        tile.setYMaximum( tile.yMaximum() + mTileMargin );
+      mTiles.append( tile );
+    }
+  }
+}
+
+void Checker::setPrefetchDepth( int depth )
+{
+  mPrefetchDepth = depth;
+  if ( mMemoryBudget > 0 )
+  {
+    setMemoryBudget( mMemoryBudget );
+  }
+}
+
+void Checker::runTiles()
+{
+  // The area each layer loads for a tile
+  QList<TilePrefetcher::TileExtents> tileExtents;
+  for ( const QgsRectangle &tile : qgis::as_const( mTiles ) )
+  {
+    QgsRectangle loadArea = tile;
+    loadArea.grow( mTileMargin );
+    TilePrefetcher::TileExtents extents;
+    for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
+    {
+      QgsCoordinateTransform t( mContext->mapCrs, it.value()->crs(), mContext->transformContext );
+      try
+      {
+        extents.insert( it.key(), t.transformBoundingBox( loadArea ) );
+      }
+      catch ( const QgsCsException & )
+      {
+        extents.insert( it.key(), QgsRectangle() );
+      }
+    }
+    tileExtents.append( extents );
+  }
+
+  TilePrefetcher prefetcher( mFeaturePools, tileExtents, mPrefetchDepth );
+  for ( int i = 0; i < mTiles.size() && !mFeedback.isCanceled(); ++i )
+  {
+    const QgsRectangle tile = mTiles.at( i );
+    const TilePrefetcher::TileFeatures features = prefetcher.take( i );
+    for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
+    {
+      it.value()->loadFeatures( features.value( it.key() ) );
+    }
+    mContext->lineNetworks()->clear();
+    mContext->candidatePairs()->clear();
+    estimateRunCosts();
+
+    // Features near the tile border are loaded by the neighbouring tiles too,
+    // each error is reported by the tile it is located in
+    TileSink sink( mErrorQueue, tile );
+    mRunSink = &sink;
+    runScheduled();
+    mRunSink = &mErrorQueue;
+
+    for ( FeaturePool *featurePool : qgis::as_const( mFeaturePools ) )
+    {
+      featurePool->releaseFeatures();
+    }
+    resetRunProgress();
+    mFeedback.setProgress( i + 1 );
+  }
+  mPrefetchStallTime = prefetcher.stallTime();
+
+  // Messages are reported again by every tile
+  QMutexLocker locker( &mErrorListMutex );
+  mMessages.removeDuplicates();
+}
+
+QJsonObject Checker::profileToJson() const
+{
+  QMap<QString, QString> layerNames;
+  for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
+  {
+    layerNames.insert( it.key(), it.value()->layerName() );
+  }
+  QJsonObject json = mProfile.toJson( layerNames );
+  json.insert( QStringLiteral( "threads" ), QThreadPool::globalInstance()->maxThreadCount() );
+  return json;
+}
+
+void Checker::setErrorSpill( int maxErrorsInMemory, const QString &fileName )
+{
+  mMaxErrorsInMemory = maxErrorsInMemory;
+  mSpillFileName = fileName;
+}
+
+int Checker::spilledErrorCount() const
+{
+  return mSpillSink ? mSpillSink->count() : 0;
+}
+
+QString Checker::spillFileName() const
+{
+  return mSpillSink ? mSpillSink->fileName() : QString();
+}
+
+bool Checker::spillFailed() const
+{
+  return mSpillSink && mSpillSink->hasError();
+}
+
+void Checker::flushErrors()
+{
+  if ( QThread::currentThread() != thread() )
+  {
+    QMetaObject::invokeMethod( this, "drainErrors", Qt::BlockingQueuedConnection );
+  }
+  else
+  {
+    drainErrors();
+  }
+  if ( mSpillSink )
+  {
+    mSpillSink->close();
+    // Errors are dropped from the first failed write on, the run must not look complete
+    if ( mSpillSink->hasError() )
+    {
+      QMutexLocker locker( &mErrorListMutex );
+      mMessages.append( tr( "Could not write %1: %2, %3 errors are lost" ).arg( mSpillSink->fileName(), mSpillSink->errorMessage() ).arg( mSpillSink->lostCount() ) );
+    }
+  }
+}
+
+void Checker::drainErrors()
+{
+  const QList<CheckError *> errors = mErrorQueue.takeAll();
+  if ( mProfilingEnabled )
+  {
+    QHash<QPair<const Check *, QString>, int> errorCounts;
+    for ( const CheckError *error : errors )
+    {
+      // Errors restored from a snapshot were not found by this run
+      if ( !dynamic_cast<const SnapshotCheckError *>( error ) )
+      {
+        ++errorCounts[qMakePair( error->check(), error->layerId() )];
+      }
+    }
+    for ( auto it = errorCounts.constBegin(); it != errorCounts.constEnd(); ++it )
+    {
+      CheckProfile::Counters counters;
+      counters.errors = it.value();
+      mProfile.add( it.key().first, it.key().second, counters );
+    }
+  }
+  QList<CheckError *> addedErrors;
+  addedErrors.reserve( errors.size() );
+  for ( CheckError *error : errors )
   {
-    emit errorAdded( error );
+    if ( !mSpillFileName.isEmpty() && mCheckErrors.size() >= mMaxErrorsInMemory )
+    {
+      if ( !mSpillSink )
+      {
+        // Only create the file once it is needed
+        QMap<QString, QString> layerNames;
+        for ( auto it = mFeaturePools.constBegin(); it != mFeaturePools.constEnd(); ++it )
+        {
+          layerNames.insert( it.key(), it.value()->layerName() );
+        }
+        mSpillSink.reset( new CheckErrorFileSink( mSpillFileName, mContext->mapCrs, mContext->transformContext, layerNames ) );
+      }
+      mSpillSink->append( error );
+      continue;
+    }
+    addedErrors.append( error );
   }
+  if ( addedErrors.isEmpty() )
+  {
+    return;
+  }
+  mErrorListWait.lock( mErrorListMutex );
+  mCheckErrors.append( addedErrors );
+  mErrorListMutex.unlock();
+  emit errorsAdded( addedErrors );
 }
 
 Checker::RunCheckWrapper::RunCheckWrapper( Checker *instance )
@@ -300,7 +1429,55 @@ Checker::RunCheckWrapper::RunCheckWrapper( Checker *instance )
 {
 }
 
-void Checker::RunCheckWrapper::operator()( const Check *check )
+void Checker::RunCheckWrapper::operator()( const CheckRun &run )
 {
-  mInstance->runCheck( mInstance->mFeaturePools, check );
+  RunProgress &progress = *mInstance->mRunProgress[run.index];
+  if ( progress.feedback.isCanceled() )
+  {
+    // Runs which had not started yet when the checker was canceled
+    return;
+  }
+  QElapsedTimer timer;
+  timer.start();
+  {
+    GeosInterruptScope interruptScope( &progress.feedback );
+    CheckProfile::Recorder recorder( mInstance->mProfilingEnabled ? &mInstance->mProfile : nullptr );
+    if ( run.layerId.isEmpty() )
+    {
+      CheckProfile::Recorder::setCheck( run.checks.first() );
+      mInstance->runCheck( mInstance->mFeaturePools, run, &progress.feedback );
+    }
+    else
+    {
+      mInstance->runFeatureLocalChecks( mInstance->mFeaturePools, run );
+    }
+  }
+  const qint64 elapsed = timer.nsecsElapsed();
+  progress.finished = true;
+  if ( run.checks.size() == 1 && progress.work > 0 && !progress.feedback.isCanceled() )
+  {
+    // Fused runs share their time, only runs of a single check tell what it costs
+    learnCheckCost( run.checks.first(), elapsed / progress.work );
+  }
+
+  if ( mInstance->mProfilingEnabled )
+  {
+    // A single check runs over all layers, its time is not split by layer
+    CheckProfile::Counters counters;
+    counters.wallTime = elapsed;
+    for ( const Check *check : run.checks )
+    {
+      mInstance->mProfile.add( check, run.layerId, counters );
+    }
+  }
+
+  mInstance->mErrorListWait.lock( mInstance->mErrorListMutex );
+  for ( const Check *check : run.checks )
+  {
+    CheckTiming &timing = mInstance->mCheckTimings[check];
+    timing.totalTime += elapsed;
+    timing.longestRun = std::max( timing.longestRun, elapsed );
+    ++timing.runCount;
+  }
+  mInstance->mErrorListMutex.unlock();
 }
@@ -19,14 +19,25 @@
 #ifndef CHECKER_H
 #define CHECKER_H
 
+#include <QElapsedTimer>
 #include <QFuture>
+#include <QHash>
 #include <QList>
 #include <QMutex>
+#include <QSet>
 #include <QStringList>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 
 #include "qgsfeedback.h"
 #include "qgsfeatureid.h"
+#include "qgsrectangle.h"
+#include "check.h"
+#include "checkerrorsink.h"
+#include "checkprofile.h"
+#include "lockwaitcounter.h"
 
 typedef qint64 QgsFeatureId;
 class CheckContext;
@@ -58,34 +69,327 @@ class Checker : public QObject
     CheckContext *getContext() const { return mContext; }
     const QMap<QString, FeaturePool *> featurePools() const {return mFeaturePools;}
 
+    /**
+     * Returns all errors handed over so far, in the order they were reported with errorsAdded().
+     * Errors are only ever appended. Must be called from the thread of the checker.
+     */
+    const QList<CheckError *> &errors() const { return mCheckErrors; }
+
+    /**
+     * Enables incremental checking against the snapshot stored at \a path.
+     * Features which did not change since the snapshot was taken are not checked again,
+     * their errors are restored from the snapshot instead.
+     * Must be called from the main thread before execute().
+     */
+    void setSnapshotPath( const QString &path );
+
+    /**
+     * Writes the features and errors of the last run to the snapshot path.
+     * Returns FALSE if no snapshot path is set or the snapshot could not be written.
+     */
+    bool saveSnapshot();
+
+    /**
+     * Returns the number of features which were not checked again by the last run
+     * because they did not change since the snapshot was taken.
+     */
+    int skippedFeatureCount() const { return mSkippedFeatureCount; }
+
+    /**
+     * Keeps at most \a maxErrorsInMemory errors in memory, all further errors are
+     * written to the GeoPackage \a fileName and released right away.
+     * The file is only created if the limit is exceeded.
+     * Must be called before execute().
+     */
+    void setErrorSpill( int maxErrorsInMemory, const QString &fileName );
+
+    /**
+     * Returns the number of errors which have been written to the spill file.
+     */
+    int spilledErrorCount() const;
+
+    /**
+     * Returns the name of the spill file, or an empty string if errors are not spilled.
+     */
+    QString spillFileName() const;
+
+    /**
+     * Returns TRUE if the spill file could not be created or written and errors were lost.
+     * The reason is added to the messages by flushErrors().
+     */
+    bool spillFailed() const;
+
+    /**
+     * Hands the remaining errors over to the thread of the checker, where errorsAdded() is emitted,
+     * and closes the spill file. To be called once all checks have finished.
+     * Can be called from any thread, it returns once the errors have been handed over.
+     */
+    void flushErrors();
+
+    /**
+     * Checks the map tile by tile to keep the memory used by the features within about \a bytes.
+     * The tile size is derived from the budget and the estimated feature sizes of the layers.
+     * Only the features intersecting a tile and a margin around it are loaded into the pools,
+     * all checks are run and the errors located inside the tile are reported, then the features
+     * are released. The feature pools should be created without loading their features.
+     * Snapshots are not used and errors can not be fixed in this mode.
+     * The tiles read ahead by the prefetcher are held at the same time, the budget is shared
+     * by the current tile and setPrefetchDepth() tiles.
+     * Must be called from the main thread before execute(). A budget of 0 disables tiling.
+     */
+    void setMemoryBudget( qint64 bytes );
+
+    /**
+     * Returns the number of tiles a tiled run checks, 0 if the checker does not work in tiles.
+     */
+    int tileCount() const { return mTiles.size(); }
+
+    /**
+     * Returns FALSE if the errors can not be fixed. The features of a tiled run are released
+     * tile by tile, there is nothing left to fix or to recheck once it has finished.
+     */
+    bool canFixErrors() const { return mTiles.isEmpty(); }
+
+    /**
+     * Sets the number of tiles a tiled run reads ahead in the background while the checks
+     * run on the current tile. With 0 every tile is read when the checks get to it.
+     * Must be called from the main thread before execute(), the default is 1.
+     * The tiles are made smaller to keep the memory budget with the tiles read ahead.
+     */
+    void setPrefetchDepth( int depth );
+
+    /**
+     * Returns the time in milliseconds the last tiled run waited for features of a tile to be read.
+     */
+    qint64 prefetchStallTime() const { return mPrefetchStallTime; }
+
+    /**
+     * The time a check took in the last run, measured on the threads it ran on.
+     * Feature local checks of the same layer share one pass over the features,
+     * each of them is given the time of the whole pass.
+     */
+    struct CheckTiming
+    {
+      //! Time in nanoseconds of all runs of the check, over all tiles of a tiled run
+      qint64 totalTime = 0;
+      //! Time in nanoseconds of the longest run, no thread count can check faster than that
+      qint64 longestRun = 0;
+      //! Number of runs, one per layer for feature local checks, per part of a split run and per tile for tiled runs
+      int runCount = 0;
+    };
+
+    /**
+     * Returns the time each check took in the last run.
+     * Must be called once the run has finished.
+     */
+    QHash<const Check *, CheckTiming> checkTimings() const { return mCheckTimings; }
+
+    /**
+     * Records where the time of the next runs goes, per check and layer, see profile().
+     * Recording costs a little time on every feature fetched and every GEOS call.
+     * Must be called before execute(), profiling is disabled by default.
+     */
+    void setProfilingEnabled( bool enabled ) { mProfilingEnabled = enabled; }
+
+    /**
+     * Returns TRUE if the runs are profiled.
+     */
+    bool isProfilingEnabled() const { return mProfilingEnabled; }
+
+    /**
+     * Returns the profile of the last run, empty if profiling is disabled.
+     * Must be called once the run has finished.
+     */
+    const CheckProfile &profile() const { return mProfile; }
+
+    /**
+     * Returns the profile of the last run as JSON.
+     */
+    QJsonObject profileToJson() const;
+
+    /**
+     * Returns the time the threads waited for the list of errors and messages.
+     */
+    const LockWaitCounter &errorListLockWait() const { return mErrorListWait; }
+
+    /**
+     * Returns the time the checks waited to hand over errors to the thread of the checker.
+     */
+    const LockWaitCounter &errorQueueLockWait() const { return mErrorQueue.lockWait(); }
+
+    /**
+     * Returns the part of the current run which is done, from 0 to 1.
+     * The runs of the checks are weighted by their estimated cost, the features and vertices
+     * handed to a check times the time per feature or vertex the check took in earlier runs,
+     * or a guess from the type of the check if it did not run before.
+     */
+    double progress() const;
+
+    /**
+     * Returns the part of the current run of \a check which is done, from 0 to 1.
+     */
+    double checkProgress( const Check *check ) const;
+
+    /**
+     * Returns the estimated time in milliseconds until the current run is done, or -1 while
+     * too little has been done to tell.
+     */
+    qint64 remainingTime() const;
+
+    /**
+     * Stops the current run as soon as possible. Each check stops at its next feature and,
+     * with GEOS 3.12 or later, GEOS operations running for the checks are interrupted.
+     * The errors found so far are kept.
+     * May be called from any thread. A canceled checker does not run again.
+     */
+    void cancel();
+
+    /**
+     * Returns TRUE if the checker has been canceled.
+     */
+    bool isCanceled() const { return mFeedback.isCanceled(); }
+
+    /**
+     * Returns the share of the time the threads of the last run spent checking, from 0 to 1.
+     * Below 1 if threads had no run left to take while others were still checking.
+     * Must be called once the run has finished.
+     */
+    double utilisation() const;
+
   signals:
-    void errorAdded( CheckError *error );
+    /**
+     * Emitted in the thread of the checker with the errors found since the last emission.
+     */
+    void errorsAdded( const QList<CheckError *> &errors );
     void errorUpdated( CheckError *error, bool statusChanged );
+
+    /**
+     * Emitted in the thread of the checker while a run is going on, with the progress
+     * in steps of the total returned by execute().
+     */
     void progressValue( int value );
 
+    /**
+     * Emitted in the thread of the checker while a run is going on, with the result of
+     * progress() and remainingTime().
+     */
+    void progressChanged( double progress, qint64 remainingTime );
+
   private:
+
+    /**
+     * The work done by one thread. Either a single check over all layers, or all the
+     * feature local checks of one layer in a single pass over the features of the layer.
+     * Large fused runs are split into parts, each of which checks a slice of the features.
+     */
+    struct CheckRun
+    {
+      QList<const Check *> checks;
+      //! The layer of a fused run, empty for a single check
+      QString layerId;
+      //! TRUE if only the features changed since the snapshot are checked
+      bool incremental = false;
+      //! Index of the progress of the run in mRunProgress
+      int index = 0;
+      //! The slice of the features the run checks, out of partCount slices
+      int part = 0;
+      int partCount = 1;
+    };
+
+    /**
+     * The progress of a run. Each run reports to a feedback of its own.
+     */
+    struct RunProgress
+    {
+      QgsFeedback feedback;
+      //! Steps the run is expected to report, one for each feature handed to a check
+      double steps = 0;
+      //! Units of work of the run, its features and their vertices
+      double work = 0;
+      //! Estimated cost of the run in nanoseconds, the work times the cost of the checks per unit
+      double cost = 0;
+      std::atomic<bool> finished{ false };
+    };
+
     class RunCheckWrapper
     {
       public:
         explicit RunCheckWrapper( Checker *instance );
-        void operator()( const Check *check );
+        void operator()( const CheckRun &run );
       private:
         Checker *mInstance = nullptr;
     };
 
+    static const int ERROR_BATCH_SIZE = 1000;
+
+    //! Total of the progress steps reported with progressValue()
+    static const int PROGRESS_STEPS = 1000;
+
+    //! Margin around a tile in which features are loaded, relative to the tile size
+    static constexpr double TILE_MARGIN = 0.1;
+
+    //! Number of parts per thread the runs are split into at most
+    static const int PARTS_PER_THREAD = 4;
+
+    //! Features a part of a split run checks at least
+    static const int MIN_PART_FEATURES = 500;
+
     QList<Check *> mChecks;
+    QList<CheckRun> mRuns;
     CheckContext *mContext = nullptr;
     QList<CheckError *> mCheckErrors;
     QStringList mMessages;
     QMutex mErrorListMutex;
+    LockWaitCounter mErrorListWait;
+    QHash<const Check *, CheckTiming> mCheckTimings;
+    bool mProfilingEnabled = false;
+    CheckProfile mProfile;
     QMap<QString, int> mMergeAttributeIndices;
     QgsFeedback mFeedback;
+    std::vector<std::unique_ptr<RunProgress> > mRunProgress;
+    QElapsedTimer mRunTimer;
+    qint64 mBusyTime = 0;
+    qint64 mThreadTime = 0;
     QMap<QString, FeaturePool *> mFeaturePools;
+    CheckErrorQueue mErrorQueue;
+    std::unique_ptr<CheckErrorFileSink> mSpillSink;
+    int mMaxErrorsInMemory = 0;
+    QString mSpillFileName;
+
+    QString mSnapshotPath;
+    QMap<QString, QString> mLayerKeys;
+    QHash<const Check *, QString> mCheckKeys;
+    QSet<const Check *> mIncrementalChecks;
+    Check::LayerFeatureIds mRecheckIds;
+    QgsRectangle mRecheckArea;
+    int mSkippedFeatureCount = 0;
+
+    // Where the running checks report to, this differs for tiled runs
+    CheckErrorSink *mRunSink = nullptr;
+    QList<QgsRectangle> mTiles;
+    double mTileMargin = 0;
+    qint64 mMemoryBudget = 0;
+    int mPrefetchDepth = 1;
+    qint64 mPrefetchStallTime = 0;
 
-    void runCheck( const QMap<QString, FeaturePool *> &featurePools, const Check *check );
+    void planRuns();
+    void splitRuns();
+    void createRunProgress();
+    double estimateWork( const CheckRun &run, double *steps ) const;
+    void estimateRunCosts();
+    void runScheduled();
+    void resetRunProgress();
+    double runsProgress( const Check *check ) const;
+    Check::LayerFeatureIds scopedFeatureIds( const Check *check, bool incremental ) const;
+    void runCheck( const QMap<QString, FeaturePool *> &featurePools, const CheckRun &run, QgsFeedback *feedback );
+    void runFeatureLocalChecks( const QMap<QString, FeaturePool *> &featurePools, const CheckRun &run );
+    void runTiles();
+    void prepareIncrementalRun();
+    CheckError *findLiveError( const CheckError *error );
 
   private slots:
     void emitProgressValue();
+    void drainErrors();
 };
 
 #endif // CHECKER_H
@@ -17,6 +17,7 @@
 
 #include "checkerror.h"
 #include "qgsapplication.h"
+#include "checkcontext.h"
 
 CheckError::CheckError( const Check *check,
     const QString &layerId,
@@ -26,15 +27,18 @@ CheckError::CheckError( const Check *check,
     QgsVertexId vidx,
     const QVariant &value, ValueType valueType )
   : mCheck( check )
-  , mLayerId( layerId )
-  , mFeatureId( featureId )
-  , mGeometry( geometry )
-  , mErrorLocation( errorLocation )
-  , mVidx( vidx )
-  , mValue( value )
-  , mValueType( valueType )
-  , mStatus( StatusPending )
 {
+  CheckErrorTable *table = errorTable();
+  CheckErrorTable::Record record;
+  record.layerIndex = table->intern( layerId );
+  record.featureId = featureId;
+  record.geometry = table->storeGeometry( geometry );
+  record.setLocation( errorLocation );
+  record.setVidx( vidx );
+  table->setValue( record, value );
+  record.valueType = valueType;
+  record.status = StatusPending;
+  mRecord = table->addRecord( record );
 }
 
 CheckError::CheckError( const Check *check,
@@ -44,22 +48,17 @@ CheckError::CheckError( const Check *check,
     const QVariant &value,
     ValueType valueType )
   : mCheck( check )
-  , mLayerId( layerFeature.layerId() )
-  , mFeatureId( layerFeature.feature().id() )
-  , mErrorLocation( errorLocation )
-  , mVidx( vidx )
-  , mValue( value )
-  , mValueType( valueType )
-  , mStatus( StatusPending )
 {
+  QgsPointXY location = errorLocation;
+  QgsGeometry geometry;
   if ( vidx.part != -1 )
   {
     const QgsGeometry geom = layerFeature.geometry();
-    mGeometry = QgsGeometry( CheckerUtils::getGeomPart( geom.constGet(), vidx.part )->clone() );
+    geometry = QgsGeometry( CheckerUtils::getGeomPart( geom.constGet(), vidx.part )->clone() );
   }
   else
   {
-    mGeometry = layerFeature.geometry();
+    geometry = layerFeature.geometry();
   }
   if ( !layerFeature.useMapCrs() )
   {
@@ -69,8 +68,8 @@ CheckError::CheckError( const Check *check,
       QgsCoordinateTransform ct( vl->crs(), check->context()->mapCrs, check->context()->transformContext );
       try
       {
-        mGeometry.transform( ct );
-        mErrorLocation = ct.transform( mErrorLocation );
+        geometry.transform( ct );
+        location = ct.transform( location );
       }
       catch ( const QgsCsException & )
       {
@@ -78,11 +77,43 @@ CheckError::CheckError( const Check *check,
       }
     }
   }
+
+  CheckErrorTable *table = errorTable();
+  CheckErrorTable::Record record;
+  record.layerIndex = table->intern( layerFeature.layerId() );
+  record.featureId = layerFeature.feature().id();
+  record.geometry = table->storeGeometry( geometry );
+  record.setLocation( location );
+  record.setVidx( vidx );
+  table->setValue( record, value );
+  record.valueType = valueType;
+  record.status = StatusPending;
+  mRecord = table->addRecord( record );
+}
+
+const QString &CheckError::layerId() const
+{
+  return errorTable()->string( record().layerIndex );
 }
 
 QgsGeometry CheckError::geometry() const
 {
-  return mGeometry;
+  return errorTable()->geometry( record().geometry );
+}
+
+QVariant CheckError::value() const
+{
+  return errorTable()->value( record() );
+}
+
+QString CheckError::resolutionMessage() const
+{
+  return errorTable()->string( record().resolutionMessageIndex );
+}
+
+CheckErrorTable *CheckError::errorTable() const
+{
+  return mCheck->context()->errorTable();
 }
 
 QgsRectangle CheckError::contextBoundingBox() const
@@ -92,24 +123,24 @@ QgsRectangle CheckError::contextBoundingBox() const
 
 QgsRectangle CheckError::affectedAreaBBox() const
 {
-  return mGeometry.boundingBox();
+  return geometry().boundingBox();
 }
 
 void CheckError::setFixed( int method )
 {
-  mStatus = StatusFixed;
+  record().status = StatusFixed;
   const QList<CheckResolutionMethod> methods = mCheck->availableResolutionMethods();
   for ( const CheckResolutionMethod &fix : methods )
   {
     if ( fix.id() == method )
-      mResolutionMessage = fix.name();
+      record().resolutionMessageIndex = errorTable()->intern( fix.name() );
   }
 }
 
 void CheckError::setFixFailed( const QString &reason )
 {
-  mStatus = StatusFixFailed;
-  mResolutionMessage = reason;
+  record().status = StatusFixFailed;
+  record().resolutionMessageIndex = errorTable()->intern( reason );
 }
 
 bool CheckError::isEqual( CheckError *other ) const
@@ -134,6 +165,8 @@ bool CheckError::handleChanges( const Check::Changes &changes )
     return false;
   }
 
+  // Shifted here and written back once, errors are dropped when it returns FALSE
+  QgsVertexId vidx = this->vidx();
   for ( const Check::Change &change : changes.value( layerId() ).value( featureId() ) )
   {
     if ( change.what == Check::ChangeFeature )
@@ -152,44 +185,45 @@ bool CheckError::handleChanges( const Check::Changes &changes )
     }
     else if ( change.what == Check::ChangePart )
     {
-      if ( mVidx.part == change.vidx.part )
+      if ( vidx.part == change.vidx.part )
       {
         return false;
       }
-      else if ( mVidx.part > change.vidx.part )
+      else if ( vidx.part > change.vidx.part )
       {
-        mVidx.part += change.type == Check::ChangeAdded ? 1 : -1;
+        vidx.part += change.type == Check::ChangeAdded ? 1 : -1;
       }
     }
     else if ( change.what == Check::ChangeRing )
     {
-      if ( mVidx.partEqual( change.vidx ) )
+      if ( vidx.partEqual( change.vidx ) )
       {
-        if ( mVidx.ring == change.vidx.ring )
+        if ( vidx.ring == change.vidx.ring )
         {
           return false;
         }
-        else if ( mVidx.ring > change.vidx.ring )
+        else if ( vidx.ring > change.vidx.ring )
         {
-          mVidx.ring += change.type == Check::ChangeAdded ? 1 : -1;
+          vidx.ring += change.type == Check::ChangeAdded ? 1 : -1;
         }
       }
     }
     else if ( change.what == Check::ChangeNode )
     {
-      if ( mVidx.ringEqual( change.vidx ) )
+      if ( vidx.ringEqual( change.vidx ) )
       {
-        if ( mVidx.vertex == change.vidx.vertex )
+        if ( vidx.vertex == change.vidx.vertex )
         {
           return false;
         }
-        else if ( mVidx.vertex > change.vidx.vertex )
+        else if ( vidx.vertex > change.vidx.vertex )
         {
-          mVidx.vertex += change.type == Check::ChangeAdded ? 1 : -1;
+          vidx.vertex += change.type == Check::ChangeAdded ? 1 : -1;
         }
       }
     }
   }
+  record().setVidx( vidx );
   return true;
 }
 
@@ -209,12 +243,19 @@ QIcon CheckError::icon() const
 void CheckError::update( const CheckError *other )
 {
   Q_ASSERT( mCheck == other->mCheck );
-  Q_ASSERT( mLayerId == other->mLayerId );
-  Q_ASSERT( mFeatureId == other->mFeatureId );
-  mErrorLocation = other->mErrorLocation;
-  mVidx = other->mVidx;
-  mValue = other->mValue;
-  mGeometry = other->mGeometry;
+  CheckErrorTable::Record &data = record();
+  const CheckErrorTable::Record &otherData = other->record();
+  Q_ASSERT( data.layerIndex == otherData.layerIndex );
+  Q_ASSERT( data.featureId == otherData.featureId );
+  data.x = otherData.x;
+  data.y = otherData.y;
+  data.part = otherData.part;
+  data.ring = otherData.ring;
+  data.vertex = otherData.vertex;
+  data.vertexType = otherData.vertexType;
+  data.valueKind = otherData.valueKind;
+  data.integer = otherData.integer;
+  data.geometry = otherData.geometry;
 }
 
 Check::LayerFeatureIds::LayerFeatureIds( const QMap<QString, QgsFeatureIds> &idsIn )
@@ -22,6 +22,7 @@
 
 #include "check.h"
 #include "checkerutils.h"
+#include "checkerrortable.h"
 
 class QgsPointXY;
 
@@ -99,12 +100,12 @@ class CheckError
     /**
      * The id of the layer on which this error has been detected.
      */
-    const QString &layerId() const { return mLayerId; }
+    const QString &layerId() const;
 
     /**
      * The id of the feature on which this error has been detected.
      */
-    QgsFeatureId featureId() const { return mFeatureId; }
+    QgsFeatureId featureId() const { return record().featureId; }
 
     /**
      * The geometry of the error in map units.
@@ -135,36 +136,36 @@ class CheckError
     /**
      * The location of the error in map units.
      */
-    const QgsPointXY &location() const { return mErrorLocation; }
+    QgsPointXY location() const { return record().location(); }
 
     /**
      * An additional value for the error.
      * Lengths and areas are provided in map units.
      * \see valueType()
      */
-    QVariant value() const { return mValue; }
+    QVariant value() const;
 
     /**
      * The type of the value.
      * \see value()
      */
-    ValueType valueType() const { return mValueType; }
+    ValueType valueType() const { return static_cast<ValueType>( record().valueType ); }
 
     /**
      * The id of the affected vertex. May be valid or not, depending on the
      * check.
      */
-    const QgsVertexId &vidx() const { return mVidx; }
+    QgsVertexId vidx() const { return record().vidx(); }
 
     /**
      * The status of the error.
      */
-    Status status() const { return mStatus; }
+    Status status() const { return static_cast<Status>( record().status ); }
 
     /**
      * A message with details, how the error has been resolved.
      */
-    QString resolutionMessage() const { return mResolutionMessage; }
+    QString resolutionMessage() const;
 
     /**
      * Set the status to fixed and specify the \a method that has been used to
@@ -180,7 +181,7 @@ class CheckError
     /**
      * Set the error status to obsolete.
      */
-    void setObsolete() { mStatus = StatusObsolete; }
+    void setObsolete() { record().status = StatusObsolete; }
 
     /**
      * Check if this error is equal to \a other.
@@ -224,15 +225,18 @@ class CheckError
   protected:
 
     const Check *mCheck = nullptr;
-    QString mLayerId;
-    QgsFeatureId mFeatureId;
-    QgsGeometry mGeometry;
-    QgsPointXY mErrorLocation;
-    QgsVertexId mVidx;
-    QVariant mValue;
-    ValueType mValueType;
-    Status mStatus;
-    QString mResolutionMessage;
+    //! The index of the data of this error in the error table
+    int mRecord = -1;
+
+    /**
+     * The storage of the data of this error.
+     */
+    CheckErrorTable *errorTable() const;
+
+    /**
+     * The data of this error in the error table.
+     */
+    CheckErrorTable::Record &record() const { return errorTable()->record( mRecord ); }
 
   private:
 
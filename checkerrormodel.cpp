@@ -0,0 +1,415 @@
+﻿#include "checkerrormodel.h"
+#include "featurepool.h"
+#include <QColor>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+CheckErrorModel::CheckErrorModel(Checker *checker, QObject *parent)
+    : QAbstractTableModel(parent), mChecker(checker)
+{
+    const QList<Check *> checks = mChecker->getChecks();
+    for (int i = 0; i < checks.size(); ++i)
+    {
+        mCheckIndex.insert(checks[i], i);
+    }
+    for (const FeaturePool *featurePool : mChecker->featurePools())
+    {
+        mLayerNames.insert(featurePool->layerId(), featurePool->layerName());
+    }
+
+    connect(checker, &Checker::errorsAdded, this, &CheckErrorModel::addErrors);
+    connect(checker, &Checker::errorUpdated, this, &CheckErrorModel::updateError);
+    connect(&mOrderWatcher, &QFutureWatcher<Order>::finished, this, &CheckErrorModel::applyOrder);
+}
+
+CheckErrorModel::~CheckErrorModel()
+{
+    mOrderWatcher.waitForFinished();
+}
+
+int CheckErrorModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : mRows.size();
+}
+
+int CheckErrorModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant CheckErrorModel::data(const QModelIndex &index, int role) const
+{
+    CheckError *error = this->error(index.row());
+    if (!error)
+    {
+        return QVariant();
+    }
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        switch (index.column())
+        {
+        case ColumnLayer:
+            return mLayerNames.value(error->layerId());
+        case ColumnFeatureId:
+            return error->featureId() != FID_NULL ? QVariant(error->featureId()) : QVariant();
+        case ColumnDescription:
+            return error->description();
+        case ColumnLocation:
+            return locationText(error->location());
+        case ColumnValue:
+            return error->value();
+        case ColumnResolution:
+            if (error->status() == CheckError::StatusFixed)
+                return tr("Fixed: %1").arg(error->resolutionMessage());
+            if (error->status() == CheckError::StatusFixFailed)
+                return tr("Fix failed: %1").arg(error->resolutionMessage());
+            if (error->status() == CheckError::StatusObsolete)
+                return tr("Obsolete");
+            return QString();
+        }
+        break;
+    case Qt::BackgroundRole:
+        if (error->status() == CheckError::StatusFixed)
+            return QColor(Qt::green);
+        if (error->status() == CheckError::StatusFixFailed)
+            return QColor(Qt::red);
+        if (error->status() == CheckError::StatusObsolete)
+            return QColor(Qt::gray);
+        break;
+    case Qt::ForegroundRole:
+        if (error->status() == CheckError::StatusObsolete)
+            return QColor(Qt::lightGray);
+        break;
+    case Qt::UserRole:
+        return QVariant::fromValue(error);
+    }
+    return QVariant();
+}
+
+QVariant CheckErrorModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section)
+    {
+    case ColumnLayer:
+        return QStringLiteral("图层");
+    case ColumnFeatureId:
+        return QStringLiteral("序号");
+    case ColumnDescription:
+        return QStringLiteral("错误原因");
+    case ColumnLocation:
+        return QStringLiteral("坐标");
+    case ColumnValue:
+        return QStringLiteral("对象信息");
+    case ColumnResolution:
+        return QStringLiteral("修复");
+    }
+    return QVariant();
+}
+
+Qt::ItemFlags CheckErrorModel::flags(const QModelIndex &index) const
+{
+    CheckError *error = this->error(index.row());
+    if (error && error->status() == CheckError::StatusObsolete)
+    {
+        return Qt::ItemIsEnabled;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+void CheckErrorModel::sort(int column, Qt::SortOrder order)
+{
+    mSortColumn = column;
+    mSortOrder = order;
+    startOrder();
+}
+
+CheckError *CheckErrorModel::error(int row) const
+{
+    if (row < 0 || row >= mRows.size())
+    {
+        return nullptr;
+    }
+    return mChecker->errors().at(mRows[row]);
+}
+
+int CheckErrorModel::row(CheckError *error) const
+{
+    const int source = mSourceIndex.value(error, -1);
+    return source >= 0 ? mSourceRows[source] : -1;
+}
+
+void CheckErrorModel::setCheckFilter(const QStringList &checkDescriptions)
+{
+    mVisibleChecks.clear();
+    for (auto it = mCheckIndex.constBegin(); it != mCheckIndex.constEnd(); ++it)
+    {
+        if (checkDescriptions.contains(it.key()->description()))
+        {
+            mVisibleChecks.insert(it.value());
+        }
+    }
+    mFiltered = true;
+    startOrder();
+}
+
+int CheckErrorModel::errorCount() const
+{
+    return mRows.size() - mStatusCounts[CheckError::StatusObsolete];
+}
+
+int CheckErrorModel::fixedCount() const
+{
+    return mStatusCounts[CheckError::StatusFixed];
+}
+
+bool CheckErrorModel::isVisible(int source) const
+{
+    return !mFiltered || mVisibleChecks.contains(mSourceCheck[source]);
+}
+
+void CheckErrorModel::countStatus(int source, int delta)
+{
+    if (mSourceRows[source] >= 0)
+    {
+        mStatusCounts[mSourceStatus[source]] += delta;
+    }
+}
+
+void CheckErrorModel::addErrors(const QList<CheckError *> &errors)
+{
+    // The checker appends to its error list before emitting errorsAdded,
+    // so the new errors are the last ones of the list
+    const QList<CheckError *> &allErrors = mChecker->errors();
+    int source = allErrors.size() - errors.size();
+
+    QVector<int> newRows;
+    newRows.reserve(errors.size());
+    for (CheckError *error : errors)
+    {
+        mSourceIndex.insert(error, source);
+        mSourceStatus.append(static_cast<quint8>(error->status()));
+        mSourceCheck.append(static_cast<quint16>(mCheckIndex.value(error->check())));
+        mSourceRows.append(-1);
+        if (isVisible(source))
+        {
+            newRows.append(source);
+        }
+        ++source;
+    }
+    if (newRows.isEmpty())
+    {
+        return;
+    }
+
+    // New errors are appended unsorted, until the next sort
+    const int first = mRows.size();
+    beginInsertRows(QModelIndex(), first, first + newRows.size() - 1);
+    for (int i = 0; i < newRows.size(); ++i)
+    {
+        mSourceRows[newRows[i]] = first + i;
+        mRows.append(newRows[i]);
+        countStatus(newRows[i], 1);
+    }
+    endInsertRows();
+    emit countsChanged();
+}
+
+void CheckErrorModel::updateError(CheckError *error, bool statusChanged)
+{
+    const int source = mSourceIndex.value(error, -1);
+    if (source < 0)
+    {
+        return;
+    }
+    if (statusChanged)
+    {
+        countStatus(source, -1);
+        mSourceStatus[source] = static_cast<quint8>(error->status());
+        countStatus(source, 1);
+        emit countsChanged();
+    }
+    const int row = mSourceRows[source];
+    if (row >= 0)
+    {
+        emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+    }
+}
+
+void CheckErrorModel::startOrder()
+{
+    // Collect the keys of the visible errors here, only ranking and sorting is
+    // done in the background. Texts are implicitly shared and safe to hand over.
+    const QList<CheckError *> &errors = mChecker->errors();
+    QVector<RowKey> keys;
+    QVector<QString> texts;
+    keys.reserve(errors.size());
+    for (int source = 0; source < errors.size(); ++source)
+    {
+        if (!isVisible(source))
+        {
+            continue;
+        }
+        const CheckError *error = errors[source];
+        RowKey key;
+        key.source = source;
+        switch (mSortColumn)
+        {
+        case ColumnLayer:
+            key.text = texts.size();
+            texts.append(mLayerNames.value(error->layerId()));
+            break;
+        case ColumnFeatureId:
+            key.primary = error->featureId();
+            break;
+        case ColumnDescription:
+            key.text = texts.size();
+            texts.append(error->description());
+            break;
+        case ColumnLocation:
+            key.primary = error->location().x();
+            key.secondary = error->location().y();
+            break;
+        case ColumnValue:
+        {
+            bool ok = false;
+            const double value = error->value().toDouble(&ok);
+            if (ok)
+            {
+                key.secondary = value;
+            }
+            else
+            {
+                // Non numeric values after the numeric ones
+                key.primary = 1.;
+                key.text = texts.size();
+                texts.append(error->value().toString());
+            }
+            break;
+        }
+        case ColumnResolution:
+            key.primary = error->status();
+            key.text = texts.size();
+            texts.append(error->resolutionMessage());
+            break;
+        default:
+            key.primary = source;
+            break;
+        }
+        keys.append(key);
+    }
+
+    // A running computation is not interrupted, its result is dropped instead
+    mOrderWatcher.setFuture(QtConcurrent::run(&CheckErrorModel::computeOrder, keys, texts, ++mGeneration, errors.size(), mSortOrder));
+}
+
+CheckErrorModel::Order CheckErrorModel::computeOrder(QVector<RowKey> keys, const QVector<QString> &texts, int generation, int sourceCount, Qt::SortOrder order)
+{
+    if (!texts.isEmpty())
+    {
+        QStringList distinct = texts.toList().toSet().toList();
+        std::sort(distinct.begin(), distinct.end());
+        QHash<QString, int> ranks;
+        ranks.reserve(distinct.size());
+        for (int i = 0; i < distinct.size(); ++i)
+        {
+            ranks.insert(distinct[i], i);
+        }
+        for (RowKey &key : keys)
+        {
+            if (key.text >= 0)
+            {
+                key.secondary = ranks.value(texts[key.text]);
+            }
+        }
+    }
+
+    auto lessThan = [](const RowKey &a, const RowKey &b)
+    {
+        return a.primary < b.primary || (a.primary == b.primary && a.secondary < b.secondary);
+    };
+    if (order == Qt::AscendingOrder)
+    {
+        std::stable_sort(keys.begin(), keys.end(), lessThan);
+    }
+    else
+    {
+        std::stable_sort(keys.begin(), keys.end(), [&lessThan](const RowKey &a, const RowKey &b) { return lessThan(b, a); });
+    }
+
+    Order result;
+    result.generation = generation;
+    result.sourceCount = sourceCount;
+    result.rows.reserve(keys.size());
+    for (const RowKey &key : qgis::as_const(keys))
+    {
+        result.rows.append(key.source);
+    }
+    return result;
+}
+
+void CheckErrorModel::applyOrder()
+{
+    Order result = mOrderWatcher.result();
+    if (result.generation != mGeneration)
+    {
+        return;
+    }
+
+    // Errors added while computing keep their place at the end
+    const QList<CheckError *> &errors = mChecker->errors();
+    for (int source = result.sourceCount; source < errors.size(); ++source)
+    {
+        if (isVisible(source))
+        {
+            result.rows.append(source);
+        }
+    }
+
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+    const QModelIndexList oldIndexes = persistentIndexList();
+    QVector<int> oldSources;
+    oldSources.reserve(oldIndexes.size());
+    for (const QModelIndex &idx : oldIndexes)
+    {
+        oldSources.append(mRows.value(idx.row(), -1));
+    }
+
+    mRows = result.rows;
+    mSourceRows.fill(-1);
+    for (int row = 0; row < mRows.size(); ++row)
+    {
+        mSourceRows[mRows[row]] = row;
+    }
+    std::fill(std::begin(mStatusCounts), std::end(mStatusCounts), 0);
+    for (int source : qgis::as_const(mRows))
+    {
+        ++mStatusCounts[mSourceStatus[source]];
+    }
+
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+    for (int i = 0; i < oldIndexes.size(); ++i)
+    {
+        const int row = oldSources[i] >= 0 ? mSourceRows[oldSources[i]] : -1;
+        newIndexes.append(row >= 0 ? index(row, oldIndexes[i].column()) : QModelIndex());
+    }
+    changePersistentIndexList(oldIndexes, newIndexes);
+    emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+
+    emit countsChanged();
+    emit orderChanged();
+}
+
+QString CheckErrorModel::locationText(const QgsPointXY &location)
+{
+    int prec = 7 - std::floor(std::max(0., std::log10(std::max(location.x(), location.y()))));
+    return QStringLiteral("%1, %2").arg(location.x(), 0, 'f', prec).arg(location.y(), 0, 'f', prec);
+}
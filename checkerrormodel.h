@@ -0,0 +1,109 @@
+﻿#ifndef CHECKERRORMODEL_H
+#define CHECKERRORMODEL_H
+
+#include <QAbstractTableModel>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include "checker.h"
+#include "checkerror.h"
+
+// Table model over the error list of a checker.
+// Rows only store the index of their error in Checker::errors(), all cell texts are
+// formatted on demand. Sorting and filtering run on compact keys in a background thread.
+class CheckErrorModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        ColumnLayer,
+        ColumnFeatureId,
+        ColumnDescription,
+        ColumnLocation,
+        ColumnValue,
+        ColumnResolution,
+        ColumnCount
+    };
+
+    CheckErrorModel(Checker *checker, QObject *parent = nullptr);
+    ~CheckErrorModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // Returns the error shown in row, or nullptr if row is out of range
+    CheckError *error(int row) const;
+    // Returns the row of error, or -1 if it is filtered out
+    int row(CheckError *error) const;
+
+    // Only shows the errors of the checks with the given descriptions
+    void setCheckFilter(const QStringList &checkDescriptions);
+
+    // Number of shown errors which are not obsolete
+    int errorCount() const;
+    // Number of shown errors which have been fixed
+    int fixedCount() const;
+
+signals:
+    void countsChanged();
+    // Emitted once a sort or filter has been applied
+    void orderChanged();
+
+private:
+    struct RowKey
+    {
+        double primary = 0.;
+        double secondary = 0.;
+        int source = 0;
+        // Index into the texts whose rank replaces secondary, -1 if none
+        int text = -1;
+    };
+
+    struct Order
+    {
+        QVector<int> rows;
+        int sourceCount = 0;
+        int generation = 0;
+    };
+
+    Checker *mChecker = nullptr;
+    QHash<const Check *, int> mCheckIndex;
+    QMap<QString, QString> mLayerNames;
+
+    // Row -> index in Checker::errors()
+    QVector<int> mRows;
+    // Index in Checker::errors() -> row, -1 if filtered out
+    QVector<int> mSourceRows;
+    QHash<CheckError *, int> mSourceIndex;
+    QVector<quint8> mSourceStatus;
+    QVector<quint16> mSourceCheck;
+
+    QSet<int> mVisibleChecks;
+    bool mFiltered = false;
+    int mSortColumn = -1;
+    Qt::SortOrder mSortOrder = Qt::AscendingOrder;
+    int mGeneration = 0;
+    QFutureWatcher<Order> mOrderWatcher;
+
+    int mStatusCounts[CheckError::StatusObsolete + 1] = {};
+
+    bool isVisible(int source) const;
+    void countStatus(int source, int delta);
+    void startOrder();
+    static Order computeOrder(QVector<RowKey> keys, const QVector<QString> &texts, int generation, int sourceCount, Qt::SortOrder order);
+    static QString locationText(const QgsPointXY &location);
+
+private slots:
+    void addErrors(const QList<CheckError *> &errors);
+    void updateError(CheckError *error, bool statusChanged);
+    void applyOrder();
+};
+
+#endif // CHECKERRORMODEL_H
@@ -0,0 +1,174 @@
+#include "checkerrorsink.h"
+#include "checkerror.h"
+#include "qgsvectorfilewriter.h"
+
+#include <QMutexLocker>
+#include <cmath>
+
+CheckErrorListSink::~CheckErrorListSink()
+{
+  qDeleteAll( mErrors );
+}
+
+QList<CheckError *> CheckErrorListSink::takeErrors()
+{
+  QList<CheckError *> errors;
+  errors.swap( mErrors );
+  return errors;
+}
+
+
+CheckErrorQueue::CheckErrorQueue( int capacity )
+  : mCapacity( capacity )
+{
+}
+
+CheckErrorQueue::~CheckErrorQueue()
+{
+  qDeleteAll( mErrors );
+}
+
+void CheckErrorQueue::append( CheckError *error )
+{
+  mLockWait.lock( mMutex );
+  while ( mErrors.size() >= mCapacity )
+  {
+    mNotFull.wait( &mMutex );
+  }
+  mErrors.append( error );
+  const bool batchReady = mBatchCallback && mErrors.size() == mBatchSize;
+  mMutex.unlock();
+
+  if ( batchReady )
+  {
+    mBatchCallback();
+  }
+}
+
+void CheckErrorQueue::setBatchCallback( int batchSize, const std::function<void()> &callback )
+{
+  QMutexLocker locker( &mMutex );
+  mBatchSize = batchSize;
+  mBatchCallback = callback;
+}
+
+void CheckErrorQueue::appendAll( const QList<CheckError *> &errors )
+{
+  QMutexLocker locker( &mMutex );
+  mErrors.append( errors );
+}
+
+QList<CheckError *> CheckErrorQueue::takeAll()
+{
+  QList<CheckError *> errors;
+  QMutexLocker locker( &mMutex );
+  errors.swap( mErrors );
+  mNotFull.wakeAll();
+  return errors;
+}
+
+const LockWaitCounter &CheckErrorQueue::lockWait() const
+{
+  return mLockWait;
+}
+
+int CheckErrorQueue::size() const
+{
+  QMutexLocker locker( &mMutex );
+  return mErrors.size();
+}
+
+
+CheckErrorFileSink::CheckErrorFileSink( const QString &fileName,
+                                        const QgsCoordinateReferenceSystem &crs,
+                                        const QgsCoordinateTransformContext &transformContext,
+                                        const QMap<QString, QString> &layerNames,
+                                        const QString &driver )
+  : mFileName( fileName )
+  , mLayerNames( layerNames )
+{
+  mFields.append( QgsField( QStringLiteral( "layer" ), QVariant::String, QString(), 30 ) );
+  mFields.append( QgsField( QStringLiteral( "FeatureID" ), QVariant::String, QString(), 20 ) );
+  mFields.append( QgsField( QStringLiteral( "Error" ), QVariant::String, QString(), 80 ) );
+  mFields.append( QgsField( QStringLiteral( "coordinate" ), QVariant::String, QString(), 80 ) );
+  mFields.append( QgsField( QStringLiteral( "value" ), QVariant::String, QString(), 80 ) );
+  mFields.append( QgsField( QStringLiteral( "resolution" ), QVariant::String, QString(), 80 ) );
+
+  QgsVectorFileWriter::SaveVectorOptions options;
+  options.driverName = driver;
+  options.fileEncoding = QStringLiteral( "UTF-8" );
+  mWriter = QgsVectorFileWriter::create( fileName, mFields, QgsWkbTypes::Point, crs, transformContext, options );
+  if ( !mWriter )
+  {
+    mErrorMessage = QStringLiteral( "Could not create %1" ).arg( fileName );
+  }
+  else if ( mWriter->hasError() )
+  {
+    mErrorMessage = mWriter->errorMessage();
+  }
+}
+
+CheckErrorFileSink::~CheckErrorFileSink()
+{
+  // Deleting the writer flushes and closes the file
+  delete mWriter;
+}
+
+void CheckErrorFileSink::append( CheckError *error )
+{
+  QgsFeature feature( mFields );
+  feature.setGeometry( QgsGeometry::fromPointXY( error->location() ) );
+  feature.setAttribute( 0, mLayerNames.value( error->layerId(), error->layerId() ) );
+  feature.setAttribute( 1, error->featureId() );
+  feature.setAttribute( 2, error->description() );
+  int prec = 7 - std::floor( std::max( 0., std::log10( std::max( error->location().x(), error->location().y() ) ) ) );
+  feature.setAttribute( 3, QStringLiteral( "%1, %2" ).arg( error->location().x(), 0, 'f', prec ).arg( error->location().y(), 0, 'f', prec ) );
+  feature.setAttribute( 4, error->value().toString() );
+  feature.setAttribute( 5, error->resolutionMessage() );
+  delete error;
+
+  QMutexLocker locker( &mMutex );
+  if ( !mWriter || !mErrorMessage.isEmpty() )
+  {
+    ++mLostCount;
+    return;
+  }
+  if ( !mWriter->addFeature( feature ) )
+  {
+    mErrorMessage = mWriter->errorMessage();
+    ++mLostCount;
+    return;
+  }
+  ++mCount;
+}
+
+void CheckErrorFileSink::close()
+{
+  QMutexLocker locker( &mMutex );
+  delete mWriter;
+  mWriter = nullptr;
+}
+
+bool CheckErrorFileSink::hasError() const
+{
+  QMutexLocker locker( &mMutex );
+  return !mErrorMessage.isEmpty();
+}
+
+QString CheckErrorFileSink::errorMessage() const
+{
+  QMutexLocker locker( &mMutex );
+  return mErrorMessage;
+}
+
+int CheckErrorFileSink::count() const
+{
+  QMutexLocker locker( &mMutex );
+  return mCount;
+}
+
+int CheckErrorFileSink::lostCount() const
+{
+  QMutexLocker locker( &mMutex );
+  return mLostCount;
+}
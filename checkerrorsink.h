@@ -0,0 +1,178 @@
+#ifndef CHECKERRORSINK_H
+#define CHECKERRORSINK_H
+
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QWaitCondition>
+#include <functional>
+
+#include "qgsfields.h"
+#include "qgscoordinatereferencesystem.h"
+#include "qgscoordinatetransformcontext.h"
+#include "lockwaitcounter.h"
+
+class CheckError;
+class QgsVectorFileWriter;
+
+/**
+ * \ingroup analysis
+ * Receives the errors found by a check as soon as they are found.
+ *
+ * Checks report their errors through a sink instead of collecting them,
+ * so that errors can be handed on while the check is still running.
+ * Implementations must be thread safe unless documented otherwise.
+ */
+class CheckErrorSink
+{
+  public:
+    virtual ~CheckErrorSink() = default;
+
+    /**
+     * Reports a new \a error. The sink takes ownership of the error.
+     * This may block the calling check until the sink is ready to accept more errors.
+     */
+    virtual void append( CheckError *error ) = 0;
+};
+
+/**
+ * \ingroup analysis
+ * A sink which keeps all errors in a list.
+ * Ownership of the errors is passed on with takeErrors(). Not thread safe.
+ */
+class CheckErrorListSink : public CheckErrorSink
+{
+  public:
+    ~CheckErrorListSink() override;
+
+    void append( CheckError *error ) override { mErrors.append( error ); }
+
+    /**
+     * Returns the errors received so far and passes their ownership to the caller.
+     */
+    QList<CheckError *> takeErrors();
+
+  private:
+    QList<CheckError *> mErrors;
+};
+
+/**
+ * \ingroup analysis
+ * A bounded queue between the check threads and a consumer.
+ *
+ * append() blocks while the queue holds \a capacity errors, which slows
+ * down the checks until the consumer has taken the errors with takeAll().
+ */
+class CheckErrorQueue : public CheckErrorSink
+{
+  public:
+    explicit CheckErrorQueue( int capacity = 10000 );
+    ~CheckErrorQueue() override;
+
+    void append( CheckError *error ) override;
+
+    /**
+     * Adds \a errors without waiting for free capacity.
+     * To be used by the consumer side, which would otherwise wait for itself.
+     */
+    void appendAll( const QList<CheckError *> &errors );
+
+    /**
+     * Sets a \a callback which is called whenever \a batchSize errors are queued,
+     * to let the consumer take them without waiting for its next poll.
+     * The callback is called from the appending thread.
+     */
+    void setBatchCallback( int batchSize, const std::function<void()> &callback );
+
+    /**
+     * Takes all queued errors and wakes up the waiting checks.
+     */
+    QList<CheckError *> takeAll();
+
+    /**
+     * Returns the number of queued errors.
+     */
+    int size() const;
+
+    /**
+     * Returns the time the checks waited for the queue in append(), not counting
+     * the time they waited for free capacity.
+     */
+    const LockWaitCounter &lockWait() const;
+
+  private:
+    const int mCapacity;
+    int mBatchSize = 0;
+    std::function<void()> mBatchCallback;
+    mutable QMutex mMutex;
+    LockWaitCounter mLockWait;
+    QWaitCondition mNotFull;
+    QList<CheckError *> mErrors;
+};
+
+/**
+ * \ingroup analysis
+ * A sink which writes errors to a vector file, GeoPackage by default,
+ * and releases them right away.
+ *
+ * The file has the same fields as an exported error list.
+ */
+class CheckErrorFileSink : public CheckErrorSink
+{
+  public:
+
+    /**
+     * Creates the file \a fileName with the \a driver.
+     * Error locations are in \a crs, \a layerNames maps layer ids to the names written to the file.
+     */
+    CheckErrorFileSink( const QString &fileName,
+                        const QgsCoordinateReferenceSystem &crs,
+                        const QgsCoordinateTransformContext &transformContext,
+                        const QMap<QString, QString> &layerNames,
+                        const QString &driver = QStringLiteral( "GPKG" ) );
+    ~CheckErrorFileSink() override;
+
+    void append( CheckError *error ) override;
+
+    /**
+     * Flushes and closes the file. Errors appended afterwards are discarded.
+     */
+    void close();
+
+    /**
+     * Returns TRUE if the file could not be created or written.
+     */
+    bool hasError() const;
+
+    /**
+     * Returns the reason why the file could not be created or written.
+     */
+    QString errorMessage() const;
+
+    /**
+     * Returns the number of errors written to the file.
+     */
+    int count() const;
+
+    /**
+     * Returns the number of errors which could not be written, because of hasError().
+     */
+    int lostCount() const;
+
+    /**
+     * Returns the name of the file errors are written to.
+     */
+    QString fileName() const { return mFileName; }
+
+  private:
+    QString mFileName;
+    QMap<QString, QString> mLayerNames;
+    QgsFields mFields;
+    QgsVectorFileWriter *mWriter = nullptr;
+    mutable QMutex mMutex;
+    QString mErrorMessage;
+    int mCount = 0;
+    int mLostCount = 0;
+};
+
+#endif // CHECKERRORSINK_H
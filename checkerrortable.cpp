@@ -0,0 +1,193 @@
+#include "checkerrortable.h"
+#include "qgsreadwritelocker.h"
+
+#include <QMutexLocker>
+#include <cstring>
+
+int CheckErrorTable::intern( const QString &string )
+{
+  QgsReadWriteLocker locker( mStringLock, QgsReadWriteLocker::Read );
+  auto it = mStringIndex.constFind( string );
+  if ( it != mStringIndex.constEnd() )
+  {
+    return it.value();
+  }
+  locker.changeMode( QgsReadWriteLocker::Write );
+  // Another thread may have added it in between
+  it = mStringIndex.constFind( string );
+  if ( it != mStringIndex.constEnd() )
+  {
+    return it.value();
+  }
+  const int index = static_cast<int>( mStrings.size() );
+  mStrings.push_back( string );
+  mStringIndex.insert( string, index );
+  return index;
+}
+
+const QString &CheckErrorTable::string( int index ) const
+{
+  static const QString sEmpty;
+  if ( index < 0 )
+  {
+    return sEmpty;
+  }
+  QgsReadWriteLocker locker( mStringLock, QgsReadWriteLocker::Read );
+  return mStrings[index];
+}
+
+CheckErrorTable::GeometryRef CheckErrorTable::storeGeometry( const QgsGeometry &geometry )
+{
+  GeometryRef ref;
+  if ( geometry.isNull() )
+  {
+    return ref;
+  }
+  const QByteArray wkb = geometry.asWkb();
+  const quint32 size = static_cast<quint32>( wkb.size() );
+
+  QgsReadWriteLocker locker( mArenaLock, QgsReadWriteLocker::Write );
+  if ( mChunks.empty() || mChunks.back().capacity - mChunks.back().used < size )
+  {
+    // Large geometries get a chunk of their own
+    Chunk chunk;
+    chunk.capacity = size > CHUNK_SIZE ? size : CHUNK_SIZE;
+    chunk.data.reset( new char[chunk.capacity] );
+    mChunks.push_back( std::move( chunk ) );
+    mGeometryBytes += mChunks.back().capacity;
+  }
+  Chunk &chunk = mChunks.back();
+  std::memcpy( chunk.data.get() + chunk.used, wkb.constData(), size );
+  ref.chunk = static_cast<qint32>( mChunks.size() - 1 );
+  ref.offset = chunk.used;
+  ref.size = size;
+  chunk.used += size;
+  return ref;
+}
+
+QgsGeometry CheckErrorTable::geometry( const GeometryRef &ref ) const
+{
+  if ( ref.isNull() )
+  {
+    return QgsGeometry();
+  }
+  QgsReadWriteLocker locker( mArenaLock, QgsReadWriteLocker::Read );
+  QgsGeometry geometry;
+  geometry.fromWkb( QByteArray( mChunks[ref.chunk].data.get() + ref.offset, static_cast<int>( ref.size ) ) );
+  return geometry;
+}
+
+CheckErrorTable::FeatureList CheckErrorTable::compactFeatures( const QMap<QString, QList<QgsFeatureId> > &features )
+{
+  FeatureList list;
+  for ( auto it = features.constBegin(); it != features.constEnd(); ++it )
+  {
+    const int layerIndex = intern( it.key() );
+    for ( QgsFeatureId fid : it.value() )
+    {
+      list.append( qMakePair( layerIndex, fid ) );
+    }
+  }
+  list.squeeze();
+  return list;
+}
+
+QMap<QString, QList<QgsFeatureId> > CheckErrorTable::expandFeatures( const FeatureList &features ) const
+{
+  QMap<QString, QList<QgsFeatureId> > map;
+  for ( const QPair<int, QgsFeatureId> &feature : features )
+  {
+    map[string( feature.first )].append( feature.second );
+  }
+  return map;
+}
+
+qint64 CheckErrorTable::geometryBytes() const
+{
+  QgsReadWriteLocker locker( mArenaLock, QgsReadWriteLocker::Read );
+  return mGeometryBytes;
+}
+
+QgsVertexId CheckErrorTable::Record::vidx() const
+{
+  return QgsVertexId( part, ring, vertex, static_cast<decltype( QgsVertexId::type )>( vertexType ) );
+}
+
+void CheckErrorTable::Record::setVidx( const QgsVertexId &vidx )
+{
+  part = vidx.part;
+  ring = vidx.ring;
+  vertex = vidx.vertex;
+  vertexType = static_cast<quint8>( vidx.type );
+}
+
+int CheckErrorTable::addRecord( const Record &record )
+{
+  QMutexLocker locker( &mRecordMutex );
+  const int block = mRecordCount >> RECORD_BLOCK_BITS;
+  Q_ASSERT( block < MAX_RECORD_BLOCKS );
+  if ( !mRecordBlocks[block] )
+  {
+    mRecordBlocks[block].reset( new Record[RECORD_BLOCK_MASK + 1] );
+  }
+  mRecordBlocks[block][mRecordCount & RECORD_BLOCK_MASK] = record;
+  return mRecordCount++;
+}
+
+void CheckErrorTable::setValue( Record &record, const QVariant &value )
+{
+  switch ( value.type() )
+  {
+    case QVariant::Invalid:
+      record.valueKind = ValueNull;
+      record.integer = 0;
+      break;
+    case QVariant::Double:
+      record.valueKind = ValueNumber;
+      record.number = value.toDouble();
+      break;
+    case QVariant::Int:
+    case QVariant::LongLong:
+      record.valueKind = ValueInteger;
+      record.integer = value.toLongLong();
+      break;
+    case QVariant::String:
+      record.valueKind = ValueString;
+      record.index = intern( value.toString() );
+      break;
+    default:
+    {
+      QgsReadWriteLocker locker( mVariantLock, QgsReadWriteLocker::Write );
+      record.valueKind = ValueVariant;
+      record.index = static_cast<qint32>( mVariants.size() );
+      mVariants.push_back( value );
+      break;
+    }
+  }
+}
+
+QVariant CheckErrorTable::value( const Record &record ) const
+{
+  switch ( record.valueKind )
+  {
+    case ValueNumber:
+      return record.number;
+    case ValueInteger:
+      return record.integer;
+    case ValueString:
+      return string( record.index );
+    case ValueVariant:
+    {
+      QgsReadWriteLocker locker( mVariantLock, QgsReadWriteLocker::Read );
+      return mVariants[record.index];
+    }
+  }
+  return QVariant();
+}
+
+qint64 CheckErrorTable::recordBytes() const
+{
+  QMutexLocker locker( &mRecordMutex );
+  const int blocks = ( mRecordCount + RECORD_BLOCK_MASK ) >> RECORD_BLOCK_BITS;
+  return static_cast<qint64>( blocks ) * ( RECORD_BLOCK_MASK + 1 ) * sizeof( Record );
+}
@@ -0,0 +1,197 @@
+#ifndef CHECKERRORTABLE_H
+#define CHECKERRORTABLE_H
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "qgsfeatureid.h"
+#include "qgsgeometry.h"
+#include "qgsabstractgeometry.h"
+
+/**
+ * \ingroup analysis
+ * Shared storage for the data of all errors of a checker run.
+ *
+ * The data every error has, like its feature id, location and status, is kept
+ * in fixed-size records, CheckError only holds the index of its record.
+ * Strings which are the same for many errors, like layer ids and resolution
+ * messages, are stored once and referenced by index. Error geometries are
+ * kept as WKB in an append-only arena and only turned into a QgsGeometry
+ * when they are requested.
+ *
+ * All methods are thread safe. Stored data is never released before the table
+ * is destroyed, references stay valid for the whole lifetime of the table.
+ */
+class CheckErrorTable
+{
+  public:
+
+    /**
+     * Refers to a geometry stored in the arena.
+     */
+    struct GeometryRef
+    {
+      qint32 chunk = -1;
+      quint32 offset = 0;
+      quint32 size = 0;
+
+      bool isNull() const { return chunk < 0; }
+    };
+
+    /**
+     * How the value of a record is stored.
+     */
+    enum ValueKind
+    {
+      ValueNull, //!< No value
+      ValueNumber, //!< A double in Record::number
+      ValueInteger, //!< An integer in Record::integer
+      ValueString, //!< An interned string, its index in Record::index
+      ValueVariant //!< Any other variant, its index in Record::index
+    };
+
+    /**
+     * The fixed-size data of an error.
+     */
+    struct Record
+    {
+      QgsFeatureId featureId = FID_NULL;
+      double x = 0;
+      double y = 0;
+      union
+      {
+        double number;
+        qint64 integer;
+        qint32 index;
+      };
+      GeometryRef geometry;
+      qint32 layerIndex = -1;
+      qint32 resolutionMessageIndex = -1;
+      qint32 part = -1;
+      qint32 ring = -1;
+      qint32 vertex = -1;
+      quint8 vertexType = 0;
+      quint8 valueKind = ValueNull;
+      quint8 valueType = 0;
+      quint8 status = 0;
+
+      Record() : integer( 0 ) {}
+
+      QgsPointXY location() const { return QgsPointXY( x, y ); }
+      void setLocation( const QgsPointXY &point ) { x = point.x(); y = point.y(); }
+      QgsVertexId vidx() const;
+      void setVidx( const QgsVertexId &vidx );
+    };
+
+    /**
+     * A compact list of features, as pairs of interned layer id and feature id.
+     */
+    typedef QVector<QPair<int, QgsFeatureId> > FeatureList;
+
+    CheckErrorTable() = default;
+    CheckErrorTable( const CheckErrorTable & ) = delete;
+    CheckErrorTable &operator=( const CheckErrorTable & ) = delete;
+
+    /**
+     * Returns the index of \a string, adding it to the table if needed.
+     */
+    int intern( const QString &string );
+
+    /**
+     * Returns the string at \a index, or an empty string if \a index is -1.
+     */
+    const QString &string( int index ) const;
+
+    /**
+     * Stores the WKB of \a geometry in the arena.
+     */
+    GeometryRef storeGeometry( const QgsGeometry &geometry );
+
+    /**
+     * Creates the geometry stored at \a ref.
+     */
+    QgsGeometry geometry( const GeometryRef &ref ) const;
+
+    /**
+     * Converts a map of layer ids to feature ids to a compact list.
+     */
+    FeatureList compactFeatures( const QMap<QString, QList<QgsFeatureId> > &features );
+
+    /**
+     * Converts a compact list back to a map of layer ids to feature ids.
+     */
+    QMap<QString, QList<QgsFeatureId> > expandFeatures( const FeatureList &features ) const;
+
+    /**
+     * Adds \a record to the table and returns its index.
+     */
+    int addRecord( const Record &record );
+
+    /**
+     * Returns the record at \a index. The reference stays valid for the lifetime of the table.
+     * Reading and writing the same record from several threads must be synchronized by the caller,
+     * like for any other object.
+     */
+    Record &record( int index ) { return mRecordBlocks[index >> RECORD_BLOCK_BITS][index & RECORD_BLOCK_MASK]; }
+    const Record &record( int index ) const { return mRecordBlocks[index >> RECORD_BLOCK_BITS][index & RECORD_BLOCK_MASK]; }
+
+    /**
+     * Stores \a value in \a record, strings and other types than numbers in the table.
+     */
+    void setValue( Record &record, const QVariant &value );
+
+    /**
+     * Returns the value of \a record.
+     */
+    QVariant value( const Record &record ) const;
+
+    /**
+     * Returns the number of bytes used by the geometry arena.
+     */
+    qint64 geometryBytes() const;
+
+    /**
+     * Returns the number of bytes used by the records.
+     */
+    qint64 recordBytes() const;
+
+  private:
+    static const quint32 CHUNK_SIZE = 4 * 1024 * 1024;
+    //! 65536 records per block
+    static const int RECORD_BLOCK_BITS = 16;
+    static const int RECORD_BLOCK_MASK = ( 1 << RECORD_BLOCK_BITS ) - 1;
+    //! The block pointers are allocated up front and never move, records are read without locking
+    static const int MAX_RECORD_BLOCKS = 1 << 12;
+
+    struct Chunk
+    {
+      std::unique_ptr<char[]> data;
+      quint32 capacity = 0;
+      quint32 used = 0;
+    };
+
+    mutable QReadWriteLock mStringLock;
+    QHash<QString, int> mStringIndex;
+    std::deque<QString> mStrings;
+
+    mutable QReadWriteLock mArenaLock;
+    std::vector<Chunk> mChunks;
+    qint64 mGeometryBytes = 0;
+
+    mutable QMutex mRecordMutex;
+    std::unique_ptr<std::unique_ptr<Record[]>[]> mRecordBlocks{ new std::unique_ptr<Record[]>[MAX_RECORD_BLOCKS] };
+    int mRecordCount = 0;
+
+    mutable QReadWriteLock mVariantLock;
+    std::deque<QVariant> mVariants;
+};
+
+#endif // CHECKERRORTABLE_H
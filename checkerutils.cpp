@@ -26,7 +26,10 @@
 #include "qgsvectorlayer.h"
 #include "check.h"
 #include "qgsfeedback.h"
+#include "checkprofile.h"
+#include "checktracer.h"
 
+#include <QElapsedTimer>
 #include <qmath.h>
 
 CheckerUtils::LayerFeature::LayerFeature( const FeaturePool *pool,
@@ -41,6 +44,8 @@ CheckerUtils::LayerFeature::LayerFeature( const FeaturePool *pool,
   const QgsCoordinateTransform transform( pool->crs(), context->mapCrs, context->transformContext );
   if ( useMapCrs && context->mapCrs.isValid() && !transform.isShortCircuited() )
   {
+    QElapsedTimer timer;
+    timer.start();
     try
     {
       mGeometry.transform( transform );
@@ -49,6 +54,10 @@ CheckerUtils::LayerFeature::LayerFeature( const FeaturePool *pool,
     {
       QgsDebugMsg( QStringLiteral( "Shrug. What shall we do with a geometry that cannot be converted?" ) );
     }
+    if ( CheckProfile::Counters *counters = CheckProfile::Recorder::counters( pool->layerId() ) )
+    {
+      counters->reprojectionTime += timer.nsecsElapsed();
+    }
   }
 }
 
@@ -91,7 +100,7 @@ bool CheckerUtils::LayerFeature::operator!=( const LayerFeature &other ) const
 
 CheckerUtils::LayerFeatures::iterator::iterator( const QStringList::const_iterator &layerIt, const LayerFeatures *parent )
   : mLayerIt( layerIt )
-  , mFeatureIt( QgsFeatureIds::const_iterator() )
+  , mFeatureIt( QList<QgsFeatureId>::const_iterator() )
   , mParent( parent )
 {
   nextLayerFeature( true );
@@ -138,6 +147,14 @@ const CheckerUtils::LayerFeatures::iterator &CheckerUtils::LayerFeatures::iterat
 }
 bool CheckerUtils::LayerFeatures::iterator::nextLayerFeature( bool begin )
 {
+  // A canceled run ends the iteration, which ends the loops of the checks over their features
+  if ( mParent->mFeedback && mParent->mFeedback->isCanceled() )
+  {
+    mLayerIt = mParent->mLayerIds.constEnd();
+    mFeatureIt = QList<QgsFeatureId>::const_iterator();
+    mCurrentFeature.reset();
+    return false;
+  }
   if ( !begin && nextFeature( false ) )
   {
     return true;
@@ -151,7 +168,7 @@ bool CheckerUtils::LayerFeatures::iterator::nextLayerFeature( bool begin )
     }
   }
   // End
-  mFeatureIt = QgsFeatureIds::const_iterator();
+  mFeatureIt = QList<QgsFeatureId>::const_iterator();
   mCurrentFeature.reset();
   return false;
 }
@@ -181,7 +198,7 @@ bool CheckerUtils::LayerFeatures::iterator::nextLayer( bool begin )
 bool CheckerUtils::LayerFeatures::iterator::nextFeature( bool begin )
 {
   FeaturePool *featurePool = mParent->mFeaturePools[*mLayerIt];
-  const QgsFeatureIds &featureIds = mParent->mFeatureIds[*mLayerIt];
+  const QList<QgsFeatureId> &featureIds = mParent->mFeatureIds[*mLayerIt];
   if ( !begin )
   {
     ++mFeatureIt;
@@ -194,10 +211,16 @@ bool CheckerUtils::LayerFeatures::iterator::nextFeature( bool begin )
     }
     if ( mParent->mFeedback )
       mParent->mFeedback->setProgress( mParent->mFeedback->progress() + 1.0 );
+    CheckTracer::Span span( "nextFeature", "iteration" );
     QgsFeature feature;
     if ( featurePool->getFeature( *mFeatureIt, feature ) && !feature.geometry().isNull() )
     {
       mCurrentFeature = qgis::make_unique<LayerFeature>( featurePool, feature, mParent->mContext, mParent->mUseMapCrs );
+      if ( !mParent->mNeighbours )
+      {
+        if ( CheckProfile::Counters *counters = CheckProfile::Recorder::counters( *mLayerIt ) )
+          ++counters->featuresVisited;
+      }
       return true;
     }
     ++mFeatureIt;
@@ -214,13 +237,22 @@ CheckerUtils::LayerFeatures::LayerFeatures( const QMap<QString, FeaturePool *> &
     const CheckContext *context,
     bool useMapCrs )
   : mFeaturePools( featurePools )
-  , mFeatureIds( featureIds )
   , mLayerIds( featurePools.keys() )
   , mGeometryTypes( geometryTypes )
   , mFeedback( feedback )
   , mContext( context )
   , mUseMapCrs( useMapCrs )
-{}
+{
+  // Visit neighbouring features one after the other, their neighbours are then likely still cached
+  for ( auto it = featureIds.constBegin(); it != featureIds.constEnd(); ++it )
+  {
+    const FeaturePool *featurePool = featurePools.value( it.key() );
+    if ( featurePool && geometryTypes.contains( featurePool->geometryType() ) )
+    {
+      mFeatureIds.insert( it.key(), featurePool->spatiallyOrdered( it.value() ) );
+    }
+  }
+}
 
 CheckerUtils::LayerFeatures::LayerFeatures( const QMap<QString, FeaturePool *> &featurePools,
     const QList<QString> &layerIds, const QgsRectangle &extent,
@@ -232,6 +264,7 @@ CheckerUtils::LayerFeatures::LayerFeatures( const QMap<QString, FeaturePool *> &
   , mGeometryTypes( geometryTypes )
   , mContext( context )
   , mUseMapCrs( true )
+  , mNeighbours( true )
 {
   for ( const QString &layerId : layerIds )
   {
@@ -239,11 +272,15 @@ CheckerUtils::LayerFeatures::LayerFeatures( const QMap<QString, FeaturePool *> &
     if ( geometryTypes.contains( featurePool->geometryType() ) )
     {
       QgsCoordinateTransform ct( featurePool->crs(), context->mapCrs, context->transformContext );
-      mFeatureIds.insert( layerId, featurePool->getIntersects( ct.transform( extent, QgsCoordinateTransform::ReverseTransform ) ) );
+      mFeatureIds.insert( layerId, featurePool->spatiallyOrdered( featurePool->getIntersects( ct.transform( extent, QgsCoordinateTransform::ReverseTransform ) ) ) );
+      if ( CheckProfile::Counters *counters = CheckProfile::Recorder::counters( layerId ) )
+      {
+        counters->candidatePairs += mFeatureIds.value( layerId ).size();
+      }
     }
     else
     {
-      mFeatureIds.insert( layerId, QgsFeatureIds() );
+      mFeatureIds.insert( layerId, QList<QgsFeatureId>() );
     }
   }
 }
@@ -260,8 +297,132 @@ CheckerUtils::LayerFeatures::iterator CheckerUtils::LayerFeatures::end() const
 
 /////////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+  /**
+   * Counts a call to GEOS and its time for the check being profiled on the current thread,
+   * and traces it as span named \a name.
+   */
+  class GeosCall
+  {
+    public:
+      explicit GeosCall( const char *name )
+        : mSpan( name, "geos" )
+      {
+        mTimer.start();
+      }
+
+      ~GeosCall()
+      {
+        if ( CheckProfile::Counters *counters = CheckProfile::Recorder::counters( QString() ) )
+        {
+          ++counters->geosCalls;
+          counters->geosTime += mTimer.nsecsElapsed();
+        }
+      }
+
+    private:
+      CheckTracer::Span mSpan;
+      QElapsedTimer mTimer;
+  };
+
+  /**
+   * A GEOS engine which counts the calls the checks make in their inner loops.
+   */
+  class ProfiledGeos : public QgsGeos
+  {
+    public:
+      ProfiledGeos( const QgsAbstractGeometry *geometry, double precision )
+        : QgsGeos( geometry, precision )
+      {}
+
+      void prepareGeometry() override
+      {
+        GeosCall call( "prepareGeometry" );
+        QgsGeos::prepareGeometry();
+      }
+
+      QgsAbstractGeometry *intersection( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override
+      {
+        GeosCall call( "intersection" );
+        return QgsGeos::intersection( geom, errorMsg );
+      }
+
+      QgsAbstractGeometry *difference( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override
+      {
+        GeosCall call( "difference" );
+        return QgsGeos::difference( geom, errorMsg );
+      }
+
+      bool intersects( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override
+      {
+        GeosCall call( "intersects" );
+        return QgsGeos::intersects( geom, errorMsg );
+      }
+
+      bool touches( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override
+      {
+        GeosCall call( "touches" );
+        return QgsGeos::touches( geom, errorMsg );
+      }
+
+      bool crosses( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override
+      {
+        GeosCall call( "crosses" );
+        return QgsGeos::crosses( geom, errorMsg );
+      }
+
+      bool within( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override
+      {
+        GeosCall call( "within" );
+        return QgsGeos::within( geom, errorMsg );
+      }
+
+      bool overlaps( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override
+      {
+        GeosCall call( "overlaps" );
+        return QgsGeos::overlaps( geom, errorMsg );
+      }
+
+      bool contains( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override
+      {
+        GeosCall call( "contains" );
+        return QgsGeos::contains( geom, errorMsg );
+      }
+
+      bool disjoint( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override
+      {
+        GeosCall call( "disjoint" );
+        return QgsGeos::disjoint( geom, errorMsg );
+      }
+
+      QString relate( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override
+      {
+        GeosCall call( "relate" );
+        return QgsGeos::relate( geom, errorMsg );
+      }
+
+      bool relatePattern( const QgsAbstractGeometry *geom, const QString &pattern, QString *errorMsg = nullptr ) const override
+      {
+        GeosCall call( "relatePattern" );
+        return QgsGeos::relatePattern( geom, pattern, errorMsg );
+      }
+
+      bool isEqual( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override
+      {
+        GeosCall call( "isEqual" );
+        return QgsGeos::isEqual( geom, errorMsg );
+      }
+  };
+}
+
 std::unique_ptr<QgsGeometryEngine> CheckerUtils::createGeomEngine( const QgsAbstractGeometry *geometry, double tolerance )
 {
+  // Only pay for counting when a check is being profiled or traced
+  if ( CheckProfile::Recorder::isRecording() || CheckTracer::isEnabled() )
+  {
+    return qgis::make_unique<ProfiledGeos>( geometry, tolerance );
+  }
   return qgis::make_unique<QgsGeos>( geometry, tolerance );
 }
 
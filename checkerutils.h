@@ -117,6 +117,7 @@ class CheckerUtils
 
         /**
          * Creates a new set of layer and features.
+         * The features of each layer are visited in the spatial order of FeaturePool::spatiallyOrdered().
          */
         LayerFeatures( const QMap<QString, FeaturePool *> &featurePools,
                        const QMap<QString, QgsFeatureIds> &featureIds,
@@ -178,7 +179,7 @@ class CheckerUtils
             bool nextLayer( bool begin );
             bool nextFeature( bool begin );
             QList<QString>::const_iterator mLayerIt;
-            QgsFeatureIds::const_iterator mFeatureIt;
+            QList<QgsFeatureId>::const_iterator mFeatureIt;
             const LayerFeatures *mParent = nullptr;
             std::unique_ptr<CheckerUtils::LayerFeature> mCurrentFeature;
 
@@ -202,13 +203,15 @@ class CheckerUtils
         LayerFeatures();
 #endif
         QMap<QString, FeaturePool *> mFeaturePools;
-        QMap<QString, QgsFeatureIds> mFeatureIds;
+        QMap<QString, QList<QgsFeatureId> > mFeatureIds;
         QList<QString> mLayerIds;
         QgsRectangle mExtent;
         QList<QgsWkbTypes::GeometryType> mGeometryTypes;
         QgsFeedback *mFeedback = nullptr;
         const CheckContext *mContext = nullptr;
         bool mUseMapCrs = true;
+        //! TRUE for the features of a spatial query, which are candidates rather than visited features
+        bool mNeighbours = false;
     };
 
 #ifndef SIP_RUN
@@ -0,0 +1,223 @@
+﻿#include "checkfactory.h"
+#include "pointonlinecheck.h"
+#include "pointonlineendcheck.h"
+#include "pointonlinenodecheck.h"
+#include "duplicatecheck.h"
+#include "pointonboundarycheck.h"
+#include "pointinpolygoncheck.h"
+#include "linelayerintersectioncheck.h"
+#include "lineintersectioncheck.h"
+#include "lineselfintersectioncheck.h"
+#include "linelayeroverlapcheck.h"
+#include "lineoverlapcheck.h"
+#include "lineselfoverlapcheck.h"
+#include "danglecheck.h"
+#include "linecoveredbylinecheck.h"
+#include "linecoveredbyboundarycheck.h"
+#include "lineendonpointcheck.h"
+#include "lineinpolygoncheck.h"
+#include "turnbackcheck.h"
+#include "segmentlengthcheck.h"
+#include "lengthcheck.h"
+#include "polygonoverlapcheck.h"
+#include "gapcheck.h"
+#include "polygonlayeroverlapcheck.h"
+#include "polygoncoveredbypolygoncheck.h"
+#include "polygoninpolygoncheck.h"
+#include "holecheck.h"
+#include "convexhullcheck.h"
+#include "areacheck.h"
+#include "clockwisecheck.h"
+#include "anglecheck.h"
+#include "isvalidcheck.h"
+#include "samecheck.h"
+#include "collinearcheck.h"
+#include "duplicatenodecheck.h"
+#include "attrvalidcheck.h"
+#include "uniqueattrcheck.h"
+#include "pseudoscheck.h"
+
+namespace
+{
+    typedef Check *(*CreateFunction)(CheckContext *context, QVariantMap &configuration, const CheckSet &set);
+
+    struct CheckEntry
+    {
+        QString name;
+        CreateFunction create;
+    };
+
+    // The names are the ones shown on the buttons of CheckItemDialog
+    const QVector<CheckEntry> &checkEntries()
+    {
+        static const QVector<CheckEntry> sEntries =
+        {
+            {QStringLiteral("点必须在线上"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new PointOnLineCheck(context, configuration);
+             }},
+            {QStringLiteral("点必须被线端点覆盖"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new PointOnLineEndCheck(context, configuration);
+             }},
+            {QStringLiteral("点必须被线节点覆盖"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new PointOnLineNodeCheck(context, configuration);
+             }},
+            {QStringLiteral("无重复点"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 configuration.insert("type", QVariant::fromValue(QgsWkbTypes::PointGeometry));
+                 return new DuplicateCheck(context, configuration);
+             }},
+            {QStringLiteral("线与线不重复"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 configuration.insert("type", QVariant::fromValue(QgsWkbTypes::LineGeometry));
+                 return new DuplicateCheck(context, configuration);
+             }},
+            {QStringLiteral("面斑不重复"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 configuration.insert("type", QVariant::fromValue(QgsWkbTypes::PolygonGeometry));
+                 return new DuplicateCheck(context, configuration);
+             }},
+            {QStringLiteral("点必须在面边界上"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new PointOnBoundaryCheck(context, configuration);
+             }},
+            {QStringLiteral("点被面完全包含"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new PointInPolygonCheck(context, configuration);
+             }},
+            {QStringLiteral("线与线无相交"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new LineLayerIntersectionCheck(context, configuration);
+             }},
+            {QStringLiteral("线内无相交"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new LineIntersectionCheck(context, configuration);
+             }},
+            {QStringLiteral("线内无自相交"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new LineSelfIntersectionCheck(context, configuration);
+             }},
+            {QStringLiteral("线与线无重叠"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new LineLayerOverlapCheck(context, configuration);
+             }},
+            {QStringLiteral("线内无重叠"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new LineOverlapCheck(context, configuration);
+             }},
+            {QStringLiteral("线内无自交叠"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new LineSelfOverlapCheck(context, configuration);
+             }},
+            {QStringLiteral("线线悬挂"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new DangleCheck(context, configuration);
+             }},
+            {QStringLiteral("线被多条线完全覆盖"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new LineCoveredByLineCheck(context, configuration);
+             }},
+            {QStringLiteral("线被面边界覆盖"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new LineCoveredByBoundaryCheck(context, configuration);
+             }},
+            {QStringLiteral("线端点必须被点覆盖"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new LineEndOnPointCheck(context, configuration);
+             }},
+            {QStringLiteral("线不能和面相交或包含"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new LineInPolygonCheck(context, configuration);
+             }},
+            {QStringLiteral("线内无打折"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &set) -> Check * {
+                 configuration.insert("minAngle", set.angle);
+                 return new TurnbackCheck(context, configuration);
+             }},
+            {QStringLiteral("线段长度"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &set) -> Check * {
+                 configuration.insert("lengthMax", set.upperLimit);
+                 configuration.insert("lengthMin", set.lowerLimit);
+                 return new SegmentLengthCheck(context, configuration);
+             }},
+            {QStringLiteral("长度"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &set) -> Check * {
+                 configuration.insert("lengthMax", set.upperLimit);
+                 configuration.insert("lengthMin", set.lowerLimit);
+                 return new LengthCheck(context, configuration);
+             }},
+            {QStringLiteral("面内无重叠"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &set) -> Check * {
+                 configuration.insert("areaMax", set.upperLimit);
+                 return new PolygonOverlapCheck(context, configuration);
+             }},
+            {QStringLiteral("面内无缝隙"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &set) -> Check * {
+                 configuration.insert("areaMax", set.upperLimit);
+                 configuration.insert("areaMin", set.lowerLimit);
+                 return new GapCheck(context, configuration);
+             }},
+            {QStringLiteral("面与面无重叠"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &set) -> Check * {
+                 configuration.insert("areaMax", set.upperLimit);
+                 return new PolygonLayerOverlapCheck(context, configuration);
+             }},
+            {QStringLiteral("面被多个面覆盖"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new PolygonCoveredByPolygonCheck(context, configuration);
+             }},
+            {QStringLiteral("面被面包含"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new PolygonInPolygonCheck(context, configuration);
+             }},
+            {QStringLiteral("面内无岛"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new HoleCheck(context, configuration);
+             }},
+            {QStringLiteral("凸包图斑"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new ConvexHullCheck(context, configuration);
+             }},
+            {QStringLiteral("面积"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &set) -> Check * {
+                 configuration.insert("areaMax", set.upperLimit);
+                 configuration.insert("areaMin", set.lowerLimit);
+                 return new AreaCheck(context, configuration);
+             }},
+            {QStringLiteral("时针方向"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new ClockwiseCheck(context, configuration);
+             }},
+            {QStringLiteral("面内无锐角"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &set) -> Check * {
+                 configuration.insert("minAngle", set.angle);
+                 return new AngleCheck(context, configuration);
+             }},
+            {QStringLiteral("无效地物"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &set) -> Check * {
+                 configuration.insert("GEOS", set.oneToOne);
+                 return new IsValidCheck(context, configuration);
+             }},
+            {QStringLiteral("重叠对象"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &set) -> Check * {
+                 configuration.insert("sameNode", set.oneToOne);
+                 return new SameCheck(context, configuration);
+             }},
+            {QStringLiteral("线或面边界无冗余节点"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new CollinearCheck(context, configuration);
+             }},
+            {QStringLiteral("线或面边界无重复节点"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new DuplicateNodeCheck(context, configuration);
+             }},
+            {QStringLiteral("属性无效检查"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &set) -> Check * {
+                 configuration.insert("attr", set.attr);
+                 return new AttrValidCheck(context, configuration);
+             }},
+            {QStringLiteral("检查唯一标识码"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &set) -> Check * {
+                 configuration.insert("attr", set.attr);
+                 return new UniqueAttrCheck(context, configuration);
+             }},
+            {QStringLiteral("线内无假结点"), [](CheckContext *context, QVariantMap &configuration, const CheckSet &) -> Check * {
+                 return new PseudosCheck(context, configuration);
+             }},
+        };
+        return sEntries;
+    }
+}
+
+QStringList CheckFactory::checkNames()
+{
+    QStringList names;
+    for (const CheckEntry &entry : checkEntries())
+    {
+        names.append(entry.name);
+    }
+    return names;
+}
+
+Check *CheckFactory::createCheck(const CheckSet &set, CheckContext *context)
+{
+    for (const CheckEntry &entry : checkEntries())
+    {
+        if (entry.name != set.name)
+            continue;
+
+        QVariantMap configuration;
+        QVariant var;
+        var.setValue(set.layersA);
+        configuration.insert("layersA", var);
+        var.setValue(set.layersB);
+        configuration.insert("layersB", var);
+        configuration.insert("excludeEndpoint", set.excludeEndpoint);
+        return entry.create(context, configuration, set);
+    }
+    return nullptr;
+}
@@ -0,0 +1,22 @@
+﻿#ifndef CHECKFACTORY_H
+#define CHECKFACTORY_H
+
+#include <QStringList>
+#include "checkset.h"
+
+class Check;
+class CheckContext;
+
+// Creates configured checks from check sets without any widgets.
+// The name of a check set selects the check, its parameters the configuration.
+class CheckFactory
+{
+public:
+    // Returns the names of all check sets a check can be created for
+    static QStringList checkNames();
+
+    // Creates the check for set, or returns nullptr if the name of set is unknown
+    static Check *createCheck(const CheckSet &set, CheckContext *context);
+};
+
+#endif // CHECKFACTORY_H
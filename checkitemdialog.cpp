@@ -502,156 +502,14 @@ void CheckItemDialog::run()
     });
 }
 
-#include "pointonlinecheck.h"
-#include "pointonlineendcheck.h"
-#include "pointonlinenodecheck.h"
-#include "duplicatecheck.h"
-#include "pointonboundarycheck.h"
-#include "pointinpolygoncheck.h"
-#include "linelayerintersectioncheck.h"
-#include "lineintersectioncheck.h"
-#include "lineselfintersectioncheck.h"
-#include "linelayeroverlapcheck.h"
-#include "lineoverlapcheck.h"
-#include "lineselfoverlapcheck.h"
-#include "danglecheck.h"
-#include "linecoveredbylinecheck.h"
-#include "linecoveredbyboundarycheck.h"
-#include "lineendonpointcheck.h"
-#include "lineinpolygoncheck.h"
-#include "turnbackcheck.h"
-#include "segmentlengthcheck.h"
-#include "lengthcheck.h"
-#include "polygonoverlapcheck.h"
-#include "gapcheck.h"
-#include "polygonlayeroverlapcheck.h"
-#include "polygoncoveredbypolygoncheck.h"
-#include "polygoninpolygoncheck.h"
-#include "holecheck.h"
-#include "convexhullcheck.h"
-#include "areacheck.h"
-#include "clockwisecheck.h"
-#include "anglecheck.h"
-#include "isvalidcheck.h"
-#include "samecheck.h"
-#include "collinearcheck.h"
-#include "duplicatenodecheck.h"
-#include "attrvalidcheck.h"
-#include "uniqueattrcheck.h"
-#include "pseudoscheck.h"
+#include "checkfactory.h"
 QList<Check *> CheckItemDialog::getChecks(CheckContext *context)
 {
     QList<Check *> checks;
     for (auto &checkset : as_const(mcheckItem->sets))
     {
-        QVariantMap configuration;
-        QVariant var;
-        var.setValue(checkset.layersA);
-        configuration.insert("layersA", var);
-        var.setValue(checkset.layersB);
-        configuration.insert("layersB", var);
-        configuration.insert( "excludeEndpoint", checkset.excludeEndpoint );
-        if (checkset.name == ui->btnPointOnLine->text()) {
-            checks.append(new PointOnLineCheck(context, configuration));
-        }else if(checkset.name == ui->btnPointOnLineEnd->text()){
-            checks.append(new PointOnLineEndCheck(context, configuration));
-        }else if(checkset.name == ui->btnPointOnLineNode->text()){
-            checks.append(new PointOnLineNodeCheck(context, configuration));
-        }else if(checkset.name == ui->btnPointDuplicate->text()){
-            var.setValue(QgsWkbTypes::PointGeometry);
-            configuration.insert("type", var);
-            checks.append(new DuplicateCheck(context, configuration));
-        }else if(checkset.name == ui->btnLineDuplicate->text()){
-            var.setValue(QgsWkbTypes::LineGeometry);
-            configuration.insert("type", var);
-            checks.append(new DuplicateCheck(context, configuration));
-        }else if(checkset.name == ui->btnPolygonDuplicate->text()){
-            var.setValue(QgsWkbTypes::PolygonGeometry);
-            configuration.insert("type", var);
-            checks.append(new DuplicateCheck(context, configuration));
-        }else if(checkset.name == ui->btnPointOnBoundary->text()){
-            checks.append(new PointOnBoundaryCheck(context, configuration));
-        }else if(checkset.name == ui->btnPointInPolygon->text()){
-            checks.append(new PointInPolygonCheck(context, configuration));
-        }else if(checkset.name == ui->btnLineLayerIntersection->text()){
-            checks.append(new LineLayerIntersectionCheck(context, configuration));
-        }else if(checkset.name == ui->btnLineIntersection->text()){
-            checks.append(new LineIntersectionCheck(context, configuration));
-        }else if(checkset.name == ui->btnLineSelfIntersection->text()){
-            checks.append(new LineSelfIntersectionCheck(context, configuration));
-        }else if(checkset.name == ui->btnLineLayerOverlap->text()){
-            checks.append(new LineLayerOverlapCheck(context, configuration));
-        }else if(checkset.name == ui->btnLineOverlap->text()){
-            checks.append(new LineOverlapCheck(context, configuration));
-        }else if(checkset.name == ui->btnLineSelfOverlap->text()){
-            checks.append(new LineSelfOverlapCheck(context, configuration));
-        }else if(checkset.name == ui->btnDangle->text()){
-            checks.append(new DangleCheck(context, configuration));
-        }else if(checkset.name == ui->btnLineCoveredByLine->text()){
-            checks.append(new LineCoveredByLineCheck(context, configuration));
-        }else if(checkset.name == ui->btnLineCoveredByBoundary->text()){
-            checks.append(new LineCoveredByBoundaryCheck(context, configuration));
-        }else if(checkset.name == ui->btnLineEndOnPoint->text()){
-            checks.append(new LineEndOnPointCheck(context, configuration));
-        }else if(checkset.name == ui->btnLineInPolygon->text()){
-            checks.append(new LineInPolygonCheck(context, configuration));
-        }else if(checkset.name == ui->btnTurnback->text()){
-            configuration.insert( "minAngle", checkset.angle );
-            checks.append(new TurnbackCheck(context, configuration));
-        }else if(checkset.name == ui->btnSegmentLength->text()){
-            configuration.insert( "lengthMax", checkset.upperLimit );
-            configuration.insert( "lengthMin", checkset.lowerLimit );
-            checks.append(new SegmentLengthCheck(context, configuration));
-        }else if(checkset.name == ui->btnLength->text()){
-            configuration.insert( "lengthMax", checkset.upperLimit );
-            configuration.insert( "lengthMin", checkset.lowerLimit );
-            checks.append(new LengthCheck(context, configuration));
-        }else if(checkset.name == ui->btnPolygonOverlap->text()){
-            configuration.insert( "areaMax", checkset.upperLimit );
-            checks.append(new PolygonOverlapCheck(context, configuration));
-        }else if(checkset.name == ui->btnGap->text()){
-            configuration.insert( "areaMax", checkset.upperLimit );
-            configuration.insert( "areaMin", checkset.lowerLimit );
-            checks.append(new GapCheck(context, configuration));
-        }else if(checkset.name == ui->btnPolygonLayerOverlap->text()){
-            configuration.insert( "areaMax", checkset.upperLimit );
-            checks.append(new PolygonLayerOverlapCheck(context, configuration));
-        }else if(checkset.name == ui->btnPolygonCoveredByPolygon->text()){
-            checks.append(new PolygonCoveredByPolygonCheck(context, configuration));
-        }else if(checkset.name == ui->btnPolygonInPolygon->text()){
-            checks.append(new PolygonInPolygonCheck(context, configuration));
-        }else if(checkset.name == ui->btnHole->text()){
-            checks.append(new HoleCheck(context, configuration));
-        }else if(checkset.name == ui->btnConvexhull->text()){
-            checks.append(new ConvexHullCheck(context, configuration));
-        }else if(checkset.name == ui->btnArea->text()){
-            configuration.insert( "areaMax", checkset.upperLimit );
-            configuration.insert( "areaMin", checkset.lowerLimit );
-            checks.append(new AreaCheck(context, configuration));
-        }else if(checkset.name == ui->btnClockwise->text()){
-            checks.append(new ClockwiseCheck(context, configuration));
-        }else if(checkset.name == ui->btnAngle->text()){
-            configuration.insert( "minAngle", checkset.angle );
-            checks.append(new AngleCheck(context, configuration));
-        }else if(checkset.name == ui->btnInvalid->text()){
-            configuration.insert( "GEOS", checkset.oneToOne );
-            checks.append(new IsValidCheck(context, configuration));
-        }else if(checkset.name == ui->btnDuplicate->text()){
-            configuration.insert( "sameNode", checkset.oneToOne );
-            checks.append(new SameCheck(context, configuration));
-        }else if(checkset.name == ui->btnCollinear->text()){
-            checks.append(new CollinearCheck(context, configuration));
-        }else if(checkset.name == ui->btnDuplicateNode->text()){
-            checks.append(new DuplicateNodeCheck(context, configuration));
-        }else if(checkset.name == ui->btnInvalidAttr->text()){
-            configuration.insert( "attr", checkset.attr );
-            checks.append(new AttrValidCheck(context, configuration));
-        }else if(checkset.name == ui->btnUniqueAttr->text()){
-            configuration.insert( "attr", checkset.attr );
-            checks.append(new UniqueAttrCheck(context, configuration));
-        }else if(checkset.name == ui->btnPseudos->text()){
-            checks.append(new PseudosCheck(context, configuration));
-        }
+        if (Check *check = CheckFactory::createCheck(checkset, context))
+            checks.append(check);
     }
 
     return checks;
@@ -0,0 +1,151 @@
+﻿#include "checkplancompiler.h"
+#include "checkfactory.h"
+#include "checksnapshot.h"
+#include "check.h"
+
+CheckPlanCompiler::CheckPlanCompiler(const CheckList &list)
+    : mList(list)
+{
+}
+
+CheckPlanCompiler::~CheckPlanCompiler()
+{
+    qDeleteAll(mChecks);
+}
+
+bool CheckPlanCompiler::compile(CheckContext *context)
+{
+    qDeleteAll(mChecks);
+    mChecks.clear();
+    mLayers.clear();
+    mErrors.clear();
+    mWarnings.clear();
+    mDuplicateCount = 0;
+
+    const QStringList checkNames = CheckFactory::checkNames();
+    QSet<QString> checkKeys;
+    for (const CheckGroup &group : mList.groups)
+    {
+        for (const CheckItem &item : group.items)
+        {
+            for (const CheckSet &set : item.sets)
+            {
+                const QString location = QStringLiteral("%1/%2/%3").arg(group.name, item.name, set.name);
+                if (!checkNames.contains(set.name))
+                {
+                    mWarnings.append(QStringLiteral("%1：未知的检查，已跳过").arg(location));
+                    continue;
+                }
+                if (!validateSet(set, location))
+                    continue;
+
+                Check *check = CheckFactory::createCheck(set, context);
+                if (!validateCheck(check, set, location))
+                {
+                    delete check;
+                    continue;
+                }
+
+                // The key covers the check, its layers and all parameters
+                const QString key = CheckSnapshot::checkKey(check);
+                if (checkKeys.contains(key))
+                {
+                    ++mDuplicateCount;
+                    delete check;
+                    continue;
+                }
+                checkKeys.insert(key);
+                mChecks.append(check);
+                mLayers.unite(set.layersA);
+                mLayers.unite(set.layersB);
+            }
+        }
+    }
+
+    if (!mErrors.isEmpty())
+    {
+        qDeleteAll(mChecks);
+        mChecks.clear();
+        mLayers.clear();
+        return false;
+    }
+    return true;
+}
+
+QList<Check *> CheckPlanCompiler::takeChecks()
+{
+    QList<Check *> checks;
+    checks.swap(mChecks);
+    return checks;
+}
+
+bool CheckPlanCompiler::validateSet(const CheckSet &set, const QString &location)
+{
+    bool valid = true;
+    auto checkLayerNames = [&](const QStringList &names, const QSet<QgsVectorLayer *> &layers)
+    {
+        for (const QString &name : names)
+        {
+            bool found = false;
+            for (const QgsVectorLayer *layer : layers)
+            {
+                if (layer->name() == name)
+                {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+            {
+                mErrors.append(QStringLiteral("%1：图层 %2 不存在").arg(location, name));
+                valid = false;
+            }
+        }
+    };
+    checkLayerNames(set.layersAStr, set.layersA);
+    checkLayerNames(set.layersBStr, set.layersB);
+
+    if (valid && set.layersA.isEmpty())
+    {
+        mWarnings.append(QStringLiteral("%1：未选择图层，已跳过").arg(location));
+        return false;
+    }
+    if (set.upperLimit > 0 && set.lowerLimit > set.upperLimit)
+    {
+        mErrors.append(QStringLiteral("%1：下限 %2 大于上限 %3").arg(location).arg(set.lowerLimit).arg(set.upperLimit));
+        valid = false;
+    }
+    return valid;
+}
+
+bool CheckPlanCompiler::validateCheck(const Check *check, const CheckSet &set, const QString &location)
+{
+    bool valid = true;
+    const QList<QgsWkbTypes::GeometryType> geometryTypes = check->compatibleGeometryTypes();
+    for (const QgsVectorLayer *layer : set.layersA)
+    {
+        if (!geometryTypes.contains(layer->geometryType()))
+        {
+            mErrors.append(QStringLiteral("%1：图层 %2 的几何类型不适用于该检查").arg(location, layer->name()));
+            valid = false;
+        }
+    }
+
+    if (check->configuration().contains(QStringLiteral("attr")))
+    {
+        if (set.attr.isEmpty())
+        {
+            mErrors.append(QStringLiteral("%1：未指定属性").arg(location));
+            return false;
+        }
+        for (const QgsVectorLayer *layer : set.layersA)
+        {
+            if (layer->fields().lookupField(set.attr) < 0)
+            {
+                mErrors.append(QStringLiteral("%1：图层 %2 没有属性 %3").arg(location, layer->name(), set.attr));
+                valid = false;
+            }
+        }
+    }
+    return valid;
+}
@@ -0,0 +1,51 @@
+﻿#ifndef CHECKPLANCOMPILER_H
+#define CHECKPLANCOMPILER_H
+
+#include <QSet>
+#include <QStringList>
+#include "checkset.h"
+
+class Check;
+class CheckContext;
+
+// Turns a check list into configured checks without creating any widgets.
+//
+// The plan is validated while compiling: unknown layers, incompatible geometry types,
+// invalid limits and missing attributes are errors, check sets which cannot be run
+// at all are skipped with a warning. Check sets with the same check, layers and
+// parameters only result in a single check.
+class CheckPlanCompiler
+{
+public:
+    explicit CheckPlanCompiler(const CheckList &list);
+    ~CheckPlanCompiler();
+
+    // Creates the checks of the plan with context.
+    // Returns false if the plan contains errors, in which case no checks are kept.
+    bool compile(CheckContext *context);
+
+    // Returns the compiled checks and passes their ownership to the caller
+    QList<Check *> takeChecks();
+
+    // Returns the layers used by the compiled checks
+    QSet<QgsVectorLayer *> layers() const { return mLayers; }
+
+    QStringList errors() const { return mErrors; }
+    QStringList warnings() const { return mWarnings; }
+
+    // Returns the number of check sets which were dropped as duplicates
+    int duplicateCount() const { return mDuplicateCount; }
+
+private:
+    const CheckList mList;
+    QList<Check *> mChecks;
+    QSet<QgsVectorLayer *> mLayers;
+    QStringList mErrors;
+    QStringList mWarnings;
+    int mDuplicateCount = 0;
+
+    bool validateSet(const CheckSet &set, const QString &location);
+    bool validateCheck(const Check *check, const CheckSet &set, const QString &location);
+};
+
+#endif // CHECKPLANCOMPILER_H
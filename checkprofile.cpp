@@ -0,0 +1,160 @@
+#include "checkprofile.h"
+#include "check.h"
+
+#include <QJsonArray>
+
+namespace
+{
+  thread_local CheckProfile::Recorder *sCurrentRecorder = nullptr;
+
+  double toMs( qint64 nsecs )
+  {
+    return nsecs / 1e6;
+  }
+
+  QJsonObject countersToJson( const CheckProfile::Counters &counters )
+  {
+    QJsonObject json;
+    json.insert( QStringLiteral( "wall_ms" ), toMs( counters.wallTime ) );
+    json.insert( QStringLiteral( "features_visited" ), counters.featuresVisited );
+    json.insert( QStringLiteral( "candidate_pairs" ), counters.candidatePairs );
+    json.insert( QStringLiteral( "geos_calls" ), counters.geosCalls );
+    json.insert( QStringLiteral( "geos_ms" ), toMs( counters.geosTime ) );
+    json.insert( QStringLiteral( "fetch_ms" ), toMs( counters.fetchTime ) );
+    json.insert( QStringLiteral( "cache_misses" ), counters.cacheMisses );
+    json.insert( QStringLiteral( "reprojection_ms" ), toMs( counters.reprojectionTime ) );
+    json.insert( QStringLiteral( "errors" ), counters.errors );
+    return json;
+  }
+}
+
+CheckProfile::Counters &CheckProfile::Counters::operator+=( const CheckProfile::Counters &other )
+{
+  wallTime += other.wallTime;
+  featuresVisited += other.featuresVisited;
+  candidatePairs += other.candidatePairs;
+  geosCalls += other.geosCalls;
+  geosTime += other.geosTime;
+  fetchTime += other.fetchTime;
+  cacheMisses += other.cacheMisses;
+  reprojectionTime += other.reprojectionTime;
+  errors += other.errors;
+  return *this;
+}
+
+CheckProfile::Recorder::Recorder( CheckProfile *profile )
+  : mProfile( profile )
+{
+  if ( mProfile )
+  {
+    mPrevious = sCurrentRecorder;
+    sCurrentRecorder = this;
+  }
+}
+
+CheckProfile::Recorder::~Recorder()
+{
+  if ( !mProfile )
+  {
+    return;
+  }
+  sCurrentRecorder = mPrevious;
+  for ( auto it = mCounters.constBegin(); it != mCounters.constEnd(); ++it )
+  {
+    mProfile->add( it.key().first, it.key().second, it.value() );
+  }
+}
+
+void CheckProfile::Recorder::setCheck( const Check *check )
+{
+  if ( sCurrentRecorder )
+  {
+    sCurrentRecorder->mCheck = check;
+  }
+}
+
+CheckProfile::Counters *CheckProfile::Recorder::counters( const QString &layerId )
+{
+  // The pointer is only used right away, before the hash can grow again
+  if ( !sCurrentRecorder )
+  {
+    return nullptr;
+  }
+  return &sCurrentRecorder->mCounters[qMakePair( sCurrentRecorder->mCheck, layerId )];
+}
+
+bool CheckProfile::Recorder::isRecording()
+{
+  return sCurrentRecorder != nullptr;
+}
+
+void CheckProfile::clear()
+{
+  QMutexLocker locker( &mMutex );
+  mChecks.clear();
+  mCounters.clear();
+}
+
+void CheckProfile::add( const Check *check, const QString &layerId, const Counters &counters )
+{
+  QMutexLocker locker( &mMutex );
+  auto it = mCounters.find( check );
+  if ( it == mCounters.end() )
+  {
+    mChecks.append( check );
+    it = mCounters.insert( check, QMap<QString, Counters>() );
+  }
+  it.value()[layerId] += counters;
+}
+
+QList<const Check *> CheckProfile::checks() const
+{
+  QMutexLocker locker( &mMutex );
+  return mChecks;
+}
+
+QMap<QString, CheckProfile::Counters> CheckProfile::layerCounters( const Check *check ) const
+{
+  QMutexLocker locker( &mMutex );
+  return mCounters.value( check );
+}
+
+CheckProfile::Counters CheckProfile::total( const Check *check ) const
+{
+  Counters sum;
+  const QMap<QString, Counters> layers = layerCounters( check );
+  for ( const Counters &counters : layers )
+  {
+    sum += counters;
+  }
+  return sum;
+}
+
+QJsonObject CheckProfile::toJson( const QMap<QString, QString> &layerNames ) const
+{
+  QJsonArray checksJson;
+  const QList<const Check *> profiledChecks = checks();
+  for ( const Check *check : profiledChecks )
+  {
+    QJsonArray layersJson;
+    const QMap<QString, Counters> layers = layerCounters( check );
+    for ( auto it = layers.constBegin(); it != layers.constEnd(); ++it )
+    {
+      QJsonObject layerJson = countersToJson( it.value() );
+      layerJson.insert( QStringLiteral( "layer_id" ), it.key() );
+      layerJson.insert( QStringLiteral( "layer" ), layerNames.value( it.key() ) );
+      layersJson.append( layerJson );
+    }
+
+    QJsonObject checkJson;
+    checkJson.insert( QStringLiteral( "check" ), check ? check->description() : QStringLiteral( "shared feature pass" ) );
+    checkJson.insert( QStringLiteral( "id" ), check ? check->id() : QString() );
+    checkJson.insert( QStringLiteral( "total" ), countersToJson( total( check ) ) );
+    checkJson.insert( QStringLiteral( "layers" ), layersJson );
+    checksJson.append( checkJson );
+  }
+
+  QJsonObject json;
+  json.insert( QStringLiteral( "checks" ), checksJson );
+  return json;
+}
@@ -0,0 +1,135 @@
+#ifndef CHECKPROFILE_H
+#define CHECKPROFILE_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+
+class Check;
+
+/**
+ * \ingroup analysis
+ * Where the time of a check run went, per check and per layer.
+ *
+ * The check threads record into a Recorder of their own, which is merged into the
+ * profile when the thread is done with a run, so recording does not contend on a
+ * lock. Code deep down in the feature pools and geometry utilities reports through
+ * the static functions of Recorder, which do nothing on threads without a recorder.
+ */
+class CheckProfile
+{
+  public:
+
+    /**
+     * What was counted for one check and layer. Times are in nanoseconds.
+     */
+    struct Counters
+    {
+      //! Time of the runs, feature local checks of a layer share the time of their pass
+      qint64 wallTime = 0;
+      //! Features handed to the check
+      qint64 featuresVisited = 0;
+      //! Neighbouring features found by spatial queries, each of them is tested against a feature
+      qint64 candidatePairs = 0;
+      //! Calls to GEOS through a geometry engine
+      qint64 geosCalls = 0;
+      qint64 geosTime = 0;
+      //! Time spent getting features from the pools, including the reads from the layers
+      qint64 fetchTime = 0;
+      qint64 cacheMisses = 0;
+      //! Time spent transforming geometries to the map crs
+      qint64 reprojectionTime = 0;
+      //! Errors reported
+      qint64 errors = 0;
+
+      Counters &operator+=( const Counters &other );
+    };
+
+    /**
+     * Records the counters of the runs on the current thread while it exists.
+     */
+    class Recorder
+    {
+      public:
+
+        /**
+         * Starts recording into \a profile on the current thread. Does nothing if \a profile is NULLPTR.
+         */
+        explicit Recorder( CheckProfile *profile );
+
+        /**
+         * Adds the recorded counters to the profile and stops recording.
+         */
+        ~Recorder();
+
+        Recorder( const Recorder & ) = delete;
+        Recorder &operator=( const Recorder & ) = delete;
+
+        /**
+         * Attributes everything recorded on the current thread from now on to \a check.
+         * NULLPTR stands for work shared by several checks, like a pass over the features
+         * of a layer for the feature local checks.
+         */
+        static void setCheck( const Check *check );
+
+        /**
+         * Returns the counters of the current check for \a layerId, or NULLPTR if the current
+         * thread does not record. An empty \a layerId stands for work not tied to a layer.
+         */
+        static Counters *counters( const QString &layerId );
+
+        /**
+         * Returns TRUE if the current thread records.
+         */
+        static bool isRecording();
+
+      private:
+        CheckProfile *mProfile = nullptr;
+        Recorder *mPrevious = nullptr;
+        const Check *mCheck = nullptr;
+        QHash<QPair<const Check *, QString>, Counters> mCounters;
+    };
+
+    /**
+     * Removes everything recorded.
+     */
+    void clear();
+
+    /**
+     * Adds \a counters to those of \a check and \a layerId. Thread safe.
+     */
+    void add( const Check *check, const QString &layerId, const Counters &counters );
+
+    /**
+     * Returns the checks with counters, in the order they were first recorded.
+     * NULLPTR stands for the work shared by several checks.
+     */
+    QList<const Check *> checks() const;
+
+    /**
+     * Returns the counters of \a check for each layer id, an empty id for work not tied to a layer.
+     */
+    QMap<QString, Counters> layerCounters( const Check *check ) const;
+
+    /**
+     * Returns the counters of \a check over all layers.
+     */
+    Counters total( const Check *check ) const;
+
+    /**
+     * Returns the profile as JSON, with the names of the layers taken from \a layerNames.
+     * Must be called from the main thread, the descriptions of the checks are translated.
+     */
+    QJsonObject toJson( const QMap<QString, QString> &layerNames ) const;
+
+  private:
+    mutable QMutex mMutex;
+    QList<const Check *> mChecks;
+    QHash<const Check *, QMap<QString, Counters> > mCounters;
+};
+
+#endif // CHECKPROFILE_H
@@ -0,0 +1,118 @@
+#include "checkset.h"
+#include <QJsonObject>
+
+QJsonArray CheckList::toJson() const
+{
+    QJsonArray groupArray;
+    for (const CheckGroup &group : groups)
+    {
+        QJsonArray itemArray;
+        for (const CheckItem &item : group.items)
+        {
+            QJsonArray setArray;
+            for (const CheckSet &set : item.sets)
+            {
+                QJsonObject object({{"name", set.name}});
+                object.insert("layersA", QJsonArray::fromStringList(set.layersAStr));
+                object.insert("layersB", QJsonArray::fromStringList(set.layersBStr));
+                object.insert("angle", set.angle);
+                object.insert("upperLimit", set.upperLimit);
+                object.insert("lowerLimit", set.lowerLimit);
+                object.insert("excludeEndpoint", set.excludeEndpoint);
+                object.insert("oneToOne", set.oneToOne);
+                object.insert("attr", set.attr);
+                setArray.append(object);
+            }
+
+            QJsonObject itemObj;
+            itemObj.insert("name", item.name);
+            itemObj.insert("sets", setArray);
+            itemArray.append(itemObj);
+        }
+
+        QJsonObject groupObj;
+        groupObj.insert("name", group.name);
+        groupObj.insert("items", itemArray);
+        groupArray.append(groupObj);
+    }
+    return groupArray;
+}
+
+CheckList CheckList::fromJson(const QString &name, const QJsonArray &groups)
+{
+    CheckList list(name);
+    for (const QJsonValue &groupVal : groups)
+    {
+        QJsonObject obj = groupVal.toObject();
+        CheckGroup group(obj["name"].toString());
+
+        QJsonArray items = obj["items"].toArray();
+        for (const QJsonValue &itemVal : items)
+        {
+            obj = itemVal.toObject();
+            CheckItem item(obj["name"].toString());
+
+            QJsonArray sets = obj["sets"].toArray();
+            for (const QJsonValue &setVal : sets)
+            {
+                obj = setVal.toObject();
+
+                CheckSet set(obj["name"].toString());
+                for (auto it : obj["layersA"].toArray())
+                    set.layersAStr.append(it.toString());
+                for (auto it : obj["layersB"].toArray())
+                    set.layersBStr.append(it.toString());
+                set.angle = obj["angle"].toDouble();
+                set.upperLimit = obj["upperLimit"].toDouble();
+                set.lowerLimit = obj["lowerLimit"].toDouble();
+                set.excludeEndpoint = obj["excludeEndpoint"].toBool();
+                set.oneToOne = obj["oneToOne"].toBool();
+                set.attr = obj["attr"].toString();
+
+                item.sets.push_back(set);
+            }
+
+            group.items.push_back(item);
+        }
+
+        list.groups.push_back(group);
+    }
+    return list;
+}
+
+void CheckList::resolveLayers(const QSet<QgsVectorLayer *> &layers)
+{
+    for (auto &group : groups)
+    {
+        for (auto &item : group.items)
+        {
+            for (auto &set : item.sets)
+            {
+                set.layersA.clear();
+                set.layersB.clear();
+                for (const QString &layerName : as_const(set.layersAStr))
+                {
+                    for (auto layer : layers)
+                    {
+                        if (layer->name() == layerName)
+                        {
+                            set.layersA.insert(layer);
+                            break;
+                        }
+                    }
+                }
+                for (const QString &layerName : as_const(set.layersBStr))
+                {
+                    for (auto layer : layers)
+                    {
+                        if (layer->name() == layerName)
+                        {
+                            set.layersB.insert(layer);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
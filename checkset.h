@@ -3,6 +3,7 @@
 #include <QString>
 #include <qgsvectorlayer.h>
 #include <QVector>
+#include <QJsonArray>
 using namespace std;
 
 class CheckSet
@@ -94,4 +95,11 @@ public:
 
     QString name;
     QVector<CheckGroup> groups;
+
+    // Converts the groups to the array stored in a check list file
+    QJsonArray toJson() const;
+    // Reads the groups from the array stored in a check list file, layers are only known by name
+    static CheckList fromJson(const QString &name, const QJsonArray &groups);
+    // Sets the layers of all check sets from their layer names
+    void resolveLayers(const QSet<QgsVectorLayer *> &layers);
 };
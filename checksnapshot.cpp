@@ -0,0 +1,190 @@
+#include "checksnapshot.h"
+#include "check.h"
+#include "qgsvectorlayer.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+static const quint32 SNAPSHOT_MAGIC = 0x54435353; // "TCSS"
+static const quint32 SNAPSHOT_VERSION = 1;
+
+CheckSnapshot::CheckSnapshot( const QString &mapCrsWkt, double tolerance )
+  : mMapCrs( mapCrsWkt )
+  , mTolerance( tolerance )
+{
+}
+
+bool CheckSnapshot::read( const QString &path )
+{
+  QFile file( path );
+  if ( !file.open( QIODevice::ReadOnly ) )
+  {
+    return false;
+  }
+  QDataStream in( &file );
+  in.setVersion( QDataStream::Qt_5_9 );
+
+  quint32 magic = 0;
+  quint32 version = 0;
+  in >> magic >> version;
+  if ( magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION )
+  {
+    return false;
+  }
+  in >> mMapCrs >> mTolerance;
+
+  mLayers.clear();
+  mErrors.clear();
+
+  qint32 layerCount = 0;
+  in >> layerCount;
+  for ( qint32 i = 0; i < layerCount && in.status() == QDataStream::Ok; ++i )
+  {
+    QString layerKey;
+    qint32 featureCount = 0;
+    in >> layerKey >> featureCount;
+    QHash<QgsFeatureId, FeaturePool::FeatureFingerprint> &fingerprints = mLayers[layerKey];
+    fingerprints.reserve( featureCount );
+    for ( qint32 j = 0; j < featureCount && in.status() == QDataStream::Ok; ++j )
+    {
+      qint64 fid = 0;
+      FeaturePool::FeatureFingerprint fingerprint;
+      in >> fid >> fingerprint.hash >> fingerprint.bbox;
+      fingerprints.insert( fid, fingerprint );
+    }
+  }
+
+  qint32 checkCount = 0;
+  in >> checkCount;
+  for ( qint32 i = 0; i < checkCount && in.status() == QDataStream::Ok; ++i )
+  {
+    QString checkKey;
+    qint32 errorCount = 0;
+    in >> checkKey >> errorCount;
+    QList<StoredError> &errors = mErrors[checkKey];
+    errors.reserve( errorCount );
+    for ( qint32 j = 0; j < errorCount && in.status() == QDataStream::Ok; ++j )
+    {
+      StoredError error;
+      qint64 fid = 0;
+      qint32 part = -1, ring = -1, vertex = -1;
+      in >> error.layerKey >> fid >> error.geometry >> error.location >> part >> ring >> vertex
+         >> error.value >> error.valueType >> error.description >> error.affectedArea;
+      error.featureId = fid;
+      error.vidx = QgsVertexId( part, ring, vertex );
+      errors.append( error );
+    }
+  }
+
+  if ( in.status() != QDataStream::Ok )
+  {
+    mLayers.clear();
+    mErrors.clear();
+    return false;
+  }
+  return true;
+}
+
+bool CheckSnapshot::write( const QString &path ) const
+{
+  // Write to a temporary file first, an interrupted write must not destroy the previous snapshot
+  QSaveFile file( path );
+  if ( !file.open( QIODevice::WriteOnly ) )
+  {
+    return false;
+  }
+  QDataStream out( &file );
+  out.setVersion( QDataStream::Qt_5_9 );
+
+  out << SNAPSHOT_MAGIC << SNAPSHOT_VERSION << mMapCrs << mTolerance;
+
+  out << static_cast<qint32>( mLayers.size() );
+  for ( auto it = mLayers.constBegin(); it != mLayers.constEnd(); ++it )
+  {
+    out << it.key() << static_cast<qint32>( it.value().size() );
+    for ( auto fit = it.value().constBegin(); fit != it.value().constEnd(); ++fit )
+    {
+      out << static_cast<qint64>( fit.key() ) << fit.value().hash << fit.value().bbox;
+    }
+  }
+
+  out << static_cast<qint32>( mErrors.size() );
+  for ( auto it = mErrors.constBegin(); it != mErrors.constEnd(); ++it )
+  {
+    out << it.key() << static_cast<qint32>( it.value().size() );
+    for ( const StoredError &error : it.value() )
+    {
+      out << error.layerKey << static_cast<qint64>( error.featureId ) << error.geometry << error.location
+          << static_cast<qint32>( error.vidx.part ) << static_cast<qint32>( error.vidx.ring ) << static_cast<qint32>( error.vidx.vertex )
+          << error.value << error.valueType << error.description << error.affectedArea;
+    }
+  }
+
+  return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool CheckSnapshot::isCompatible( const CheckSnapshot &other ) const
+{
+  return mMapCrs == other.mMapCrs && qgsDoubleNear( mTolerance, other.mTolerance );
+}
+
+void CheckSnapshot::addError( const QString &checkKey, const QString &layerKey, const CheckError *error )
+{
+  StoredError stored;
+  stored.layerKey = layerKey;
+  stored.featureId = error->featureId();
+  stored.geometry = error->geometry();
+  stored.location = error->location();
+  stored.vidx = error->vidx();
+  stored.value = error->value();
+  stored.valueType = error->valueType();
+  stored.description = error->description();
+  stored.affectedArea = error->affectedAreaBBox();
+  mErrors[checkKey].append( stored );
+}
+
+QString CheckSnapshot::layerKey( const QgsVectorLayer *layer )
+{
+  return layer ? layer->source() : QString();
+}
+
+QString CheckSnapshot::checkKey( const Check *check )
+{
+  QStringList parts;
+  parts << check->id();
+  const QVariantMap configuration = check->configuration();
+  for ( auto it = configuration.constBegin(); it != configuration.constEnd(); ++it )
+  {
+    QString value;
+    if ( it.value().userType() == qMetaTypeId<QSet<QgsVectorLayer *> >() )
+    {
+      QStringList layerKeys;
+      const QSet<QgsVectorLayer *> layers = it.value().value<QSet<QgsVectorLayer *> >();
+      for ( const QgsVectorLayer *layer : layers )
+      {
+        layerKeys << layerKey( layer );
+      }
+      layerKeys.sort();
+      value = layerKeys.join( QLatin1Char( ';' ) );
+    }
+    else
+    {
+      value = it.value().toString();
+      if ( value.isEmpty() && it.value().canConvert<int>() )
+      {
+        value = QString::number( it.value().toInt() );
+      }
+    }
+    parts << it.key() + QLatin1Char( '=' ) + value;
+  }
+  return parts.join( QLatin1Char( '|' ) );
+}
+
+
+SnapshotCheckError::SnapshotCheckError( const Check *check, const QString &layerId, const CheckSnapshot::StoredError &stored )
+  : CheckError( check, layerId, stored.featureId, stored.geometry, stored.location, stored.vidx, stored.value, static_cast<ValueType>( stored.valueType ) )
+  , mDescriptionIndex( errorTable()->intern( stored.description ) )
+  , mAffectedArea( stored.affectedArea )
+{
+}
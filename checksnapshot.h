@@ -0,0 +1,146 @@
+#ifndef CHECKSNAPSHOT_H
+#define CHECKSNAPSHOT_H
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+
+#include "qgsgeometry.h"
+#include "qgspointxy.h"
+#include "qgsrectangle.h"
+#include "featurepool.h"
+#include "checkerror.h"
+
+class Check;
+class QgsVectorLayer;
+
+/**
+ * \ingroup analysis
+ * The result of a previous checker run, persisted on disk.
+ *
+ * A snapshot stores the fingerprint of every feature which has been checked
+ * and the errors found by every check. It allows a later run on the same
+ * layers to recheck only the features that changed in between and reuse
+ * the stored errors for all the others.
+ *
+ * Layers are identified by their data source and checks by their id and
+ * configuration, so that a snapshot remains valid across sessions.
+ */
+class CheckSnapshot
+{
+  public:
+
+    /**
+     * An error as stored in the snapshot, all coordinates in the map crs.
+     */
+    struct StoredError
+    {
+      QString layerKey;
+      QgsFeatureId featureId = FID_NULL;
+      QgsGeometry geometry;
+      QgsPointXY location;
+      QgsVertexId vidx;
+      QVariant value;
+      int valueType = CheckError::ValueOther;
+      QString description;
+      QgsRectangle affectedArea;
+    };
+
+    /**
+     * Creates an empty snapshot for a run with the given map crs \a mapCrsWkt and \a tolerance.
+     */
+    CheckSnapshot( const QString &mapCrsWkt = QString(), double tolerance = 0 );
+
+    /**
+     * Reads the snapshot from \a path. Returns FALSE if the file does not exist or is not a valid snapshot.
+     */
+    bool read( const QString &path );
+
+    /**
+     * Writes the snapshot to \a path. Returns FALSE if the file could not be written.
+     */
+    bool write( const QString &path ) const;
+
+    /**
+     * Returns TRUE if the snapshot was taken with the same map crs and tolerance,
+     * i.e. if its errors can be reused by a run with \a other settings.
+     */
+    bool isCompatible( const CheckSnapshot &other ) const;
+
+    /**
+     * Returns TRUE if the snapshot contains the features of the layer \a layerKey.
+     */
+    bool hasLayer( const QString &layerKey ) const { return mLayers.contains( layerKey ); }
+
+    /**
+     * Returns the feature fingerprints stored for the layer \a layerKey.
+     */
+    QHash<QgsFeatureId, FeaturePool::FeatureFingerprint> fingerprints( const QString &layerKey ) const { return mLayers.value( layerKey ); }
+
+    /**
+     * Sets the feature fingerprints of the layer \a layerKey.
+     */
+    void setFingerprints( const QString &layerKey, const QHash<QgsFeatureId, FeaturePool::FeatureFingerprint> &fingerprints ) { mLayers.insert( layerKey, fingerprints ); }
+
+    /**
+     * Returns TRUE if the snapshot contains the results of the check \a checkKey.
+     */
+    bool hasCheck( const QString &checkKey ) const { return mErrors.contains( checkKey ); }
+
+    /**
+     * Returns the errors stored for the check \a checkKey.
+     */
+    QList<StoredError> errors( const QString &checkKey ) const { return mErrors.value( checkKey ); }
+
+    /**
+     * Stores the \a error found by the check \a checkKey on the layer \a layerKey.
+     */
+    void addError( const QString &checkKey, const QString &layerKey, const CheckError *error );
+
+    /**
+     * Marks the check \a checkKey as run, even if it did not find any error.
+     */
+    void addCheck( const QString &checkKey ) { mErrors[checkKey]; }
+
+    /**
+     * Returns the key identifying \a layer in a snapshot.
+     * Must be called from the main thread.
+     */
+    static QString layerKey( const QgsVectorLayer *layer );
+
+    /**
+     * Returns the key identifying \a check in a snapshot.
+     * It is derived from the check id and its configuration, layers are identified by their key.
+     * Must be called from the main thread.
+     */
+    static QString checkKey( const Check *check );
+
+  private:
+    QString mMapCrs;
+    double mTolerance = 0;
+    QHash<QString, QHash<QgsFeatureId, FeaturePool::FeatureFingerprint> > mLayers;
+    QMap<QString, QList<StoredError> > mErrors;
+};
+
+/**
+ * \ingroup analysis
+ * An error restored from a CheckSnapshot.
+ *
+ * It keeps what is needed to list, locate and export the error. Before it can be
+ * fixed the checker needs to find the live error again, \see Checker::fixError().
+ */
+class SnapshotCheckError : public CheckError
+{
+  public:
+    SnapshotCheckError( const Check *check, const QString &layerId, const CheckSnapshot::StoredError &stored );
+
+    QString description() const override { return errorTable()->string( mDescriptionIndex ); }
+
+    QgsRectangle affectedAreaBBox() const override { return mAffectedArea; }
+
+  private:
+    int mDescriptionIndex = -1;
+    QgsRectangle mAffectedArea;
+};
+
+#endif // CHECKSNAPSHOT_H
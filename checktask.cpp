@@ -6,6 +6,13 @@ CheckTask::CheckTask(Checker *checker)
 {
 }
 
+void CheckTask::cancel()
+{
+    // Stops the checks, run() returns once they have noticed
+    checker->cancel();
+    QgsTask::cancel();
+}
+
 bool CheckTask::run()
 {
     // Run
@@ -22,5 +29,11 @@ bool CheckTask::run()
     futureWatcher.setFuture( checker->execute( &maxSteps ) );
     evLoop.exec();
 
+    checker->flushErrors();
+    // The errors of a canceled run are incomplete, they must not be restored by the next run
+    if ( checker->isCanceled() )
+        return false;
+    checker->saveSnapshot();
+
     return true;
 }
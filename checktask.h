@@ -11,6 +11,8 @@ public:
 
     CheckTask( Checker * checker );
 
+    void cancel() override;
+
 
 protected:
 
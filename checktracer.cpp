@@ -0,0 +1,104 @@
+#include "checktracer.h"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <algorithm>
+
+std::atomic<bool> CheckTracer::sEnabled( false );
+qint64 CheckTracer::sNext = 0;
+QElapsedTimer CheckTracer::sClock;
+std::vector<CheckTracer::Event> CheckTracer::sEvents;
+QMutex CheckTracer::sMutex;
+
+namespace
+{
+  std::atomic<int> sThreadCount( 0 );
+
+  // Small ids are easier to read in the trace viewers than native thread handles
+  int currentThreadNumber()
+  {
+    thread_local const int sThread = ++sThreadCount;
+    return sThread;
+  }
+}
+
+void CheckTracer::start( int capacity )
+{
+  QMutexLocker locker( &sMutex );
+  sEnabled.store( false );
+  std::vector<Event>( capacity > 0 ? capacity : 1 ).swap( sEvents );
+  sNext = 0;
+  sClock.start();
+  sEnabled.store( true );
+}
+
+void CheckTracer::stop()
+{
+  QMutexLocker locker( &sMutex );
+  sEnabled.store( false );
+}
+
+qint64 CheckTracer::droppedCount()
+{
+  QMutexLocker locker( &sMutex );
+  const qint64 count = sNext - static_cast<qint64>( sEvents.size() );
+  return count > 0 ? count : 0;
+}
+
+void CheckTracer::record( const char *name, const char *category, const QString &detail, qint64 start, qint64 duration )
+{
+  // Threads wrapping around the ring write the same slots, and stop() must not return
+  // while a span is half written. Checked again under the lock, the span may end after stop().
+  QMutexLocker locker( &sMutex );
+  if ( !sEnabled.load( std::memory_order_relaxed ) )
+  {
+    return;
+  }
+  const qint64 index = sNext++;
+  Event &event = sEvents[static_cast<size_t>( index % static_cast<qint64>( sEvents.size() ) )];
+  event.name = name;
+  event.category = category;
+  event.detail = detail;
+  event.start = start;
+  event.duration = duration;
+  event.thread = currentThreadNumber();
+}
+
+bool CheckTracer::write( const QString &fileName )
+{
+  QMutexLocker locker( &sMutex );
+  QFile file( fileName );
+  if ( !file.open( QFile::WriteOnly | QFile::Truncate ) )
+  {
+    return false;
+  }
+
+  // Written event by event, a full buffer holds a million of them
+  const qint64 count = std::min<qint64>( sNext, static_cast<qint64>( sEvents.size() ) );
+  const qint64 first = sNext - count;
+  file.write( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+  for ( qint64 i = 0; i < count; ++i )
+  {
+    const Event &event = sEvents[static_cast<size_t>( ( first + i ) % static_cast<qint64>( sEvents.size() ) )];
+    QJsonObject json;
+    json.insert( QStringLiteral( "name" ), QString::fromLatin1( event.name ) );
+    json.insert( QStringLiteral( "cat" ), QString::fromLatin1( event.category ) );
+    json.insert( QStringLiteral( "ph" ), QStringLiteral( "X" ) );
+    json.insert( QStringLiteral( "ts" ), event.start / 1000.0 );
+    json.insert( QStringLiteral( "dur" ), event.duration / 1000.0 );
+    json.insert( QStringLiteral( "pid" ), 1 );
+    json.insert( QStringLiteral( "tid" ), event.thread );
+    if ( !event.detail.isEmpty() )
+    {
+      QJsonObject args;
+      args.insert( QStringLiteral( "detail" ), event.detail );
+      json.insert( QStringLiteral( "args" ), args );
+    }
+    file.write( QJsonDocument( json ).toJson( QJsonDocument::Compact ) );
+    file.write( i + 1 < count ? ",\n" : "\n" );
+  }
+  file.write( "]}\n" );
+  return file.error() == QFile::NoError;
+}
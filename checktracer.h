@@ -0,0 +1,114 @@
+#ifndef CHECKTRACER_H
+#define CHECKTRACER_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <vector>
+
+/**
+ * \ingroup analysis
+ * Records spans of the work done by the checks, to be viewed in chrome://tracing or Perfetto.
+ *
+ * Tracing is off by default. While it is off a span costs one atomic load. While it
+ * is on, each span takes a slot in a ring buffer under a lock when it ends, so the buffer
+ * keeps the most recent spans and a long run does not grow without bounds. All functions
+ * are thread safe, spans can be recorded from any thread. Once stop() has returned no span
+ * is written anymore.
+ */
+class CheckTracer
+{
+  public:
+
+    /**
+     * Times the work from its construction to its destruction, if tracing is on.
+     * \a name and \a category must be string literals, they are kept as pointers.
+     */
+    class Span
+    {
+      public:
+        Span( const char *name, const char *category )
+          : mName( name )
+          , mCategory( category )
+        {
+          if ( isEnabled() )
+            mStart = elapsed();
+        }
+
+        ~Span()
+        {
+          if ( mStart >= 0 && isEnabled() )
+            record( mName, mCategory, mDetail, mStart, elapsed() - mStart );
+        }
+
+        Span( const Span & ) = delete;
+        Span &operator=( const Span & ) = delete;
+
+        /**
+         * Returns TRUE if the span is recorded. Details should only be built then.
+         */
+        bool isRecording() const { return mStart >= 0; }
+
+        /**
+         * Sets a \a detail shown with the span, like the check or layer it belongs to.
+         */
+        void setDetail( const QString &detail ) { mDetail = detail; }
+
+      private:
+        const char *mName = nullptr;
+        const char *mCategory = nullptr;
+        QString mDetail;
+        qint64 mStart = -1;
+    };
+
+    /**
+     * Starts recording, dropping the spans recorded so far.
+     * The buffer keeps the last \a capacity spans.
+     */
+    static void start( int capacity = 1 << 20 );
+
+    /**
+     * Stops recording. The recorded spans are kept until write() or the next start().
+     */
+    static void stop();
+
+    /**
+     * Returns TRUE while spans are recorded.
+     */
+    static bool isEnabled() { return sEnabled.load( std::memory_order_relaxed ); }
+
+    /**
+     * Writes the recorded spans as Chrome trace event JSON to \a fileName.
+     * Spans still being recorded may be missing, stop() should be called first.
+     */
+    static bool write( const QString &fileName );
+
+    /**
+     * Returns the number of spans which did not fit into the buffer and were overwritten.
+     */
+    static qint64 droppedCount();
+
+  private:
+    struct Event
+    {
+      const char *name = nullptr;
+      const char *category = nullptr;
+      QString detail;
+      qint64 start = 0;
+      qint64 duration = 0;
+      int thread = 0;
+    };
+
+    static qint64 elapsed() { return sClock.nsecsElapsed(); }
+    static void record( const char *name, const char *category, const QString &detail, qint64 start, qint64 duration );
+
+    static std::atomic<bool> sEnabled;
+    //! Guarded by sMutex like the buffer
+    static qint64 sNext;
+    static QElapsedTimer sClock;
+    static std::vector<Event> sEvents;
+    static QMutex sMutex;
+};
+
+#endif // CHECKTRACER_H
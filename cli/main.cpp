@@ -0,0 +1,285 @@
+// Runs a check list on datasets without QGIS desktop, for batch validation.
+//
+//   TopologyCheckerCli --plan list.json --output errors.gpkg [--precision 8]
+//                      [--profile profile.json] [--trace trace.json] dataset...
+//
+// Layers are matched with the layer names of the check list: the table name for
+// datasets with several tables (e.g. GeoPackage), otherwise the file base name.
+// Exit code 0 means no errors were found, 1 that errors were written to the
+// output file and 2 that the run failed. An existing output file is replaced,
+// a run without errors leaves none behind.
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <memory>
+
+#include <qgsapplication.h>
+#include <qgsproject.h>
+#include <qgsvectorlayer.h>
+
+#include "checkcontext.h"
+#include "checker.h"
+#include "checkplancompiler.h"
+#include "checkset.h"
+#include "checktracer.h"
+#include "vectordataproviderfeaturepool.h"
+
+namespace
+{
+    enum ExitCode
+    {
+        ExitClean = 0,
+        ExitErrorsFound = 1,
+        ExitFailed = 2
+    };
+
+    QTextStream &err()
+    {
+        static QTextStream sStream(stderr);
+        return sStream;
+    }
+
+    bool isCheckable(const QgsVectorLayer *layer)
+    {
+        return layer->isValid() &&
+               (layer->geometryType() == QgsWkbTypes::PointGeometry ||
+                layer->geometryType() == QgsWkbTypes::LineGeometry ||
+                layer->geometryType() == QgsWkbTypes::PolygonGeometry);
+    }
+
+    // Opens all tables of a dataset, or the dataset itself if it has only one
+    QList<QgsVectorLayer *> openDataset(const QString &path)
+    {
+        QList<QgsVectorLayer *> layers;
+        const QgsVectorLayer::LayerOptions options{QgsCoordinateTransformContext()};
+        QgsVectorLayer *dataset = new QgsVectorLayer(path, QFileInfo(path).completeBaseName(), QStringLiteral("ogr"), options);
+        if (!dataset->isValid())
+        {
+            delete dataset;
+            return layers;
+        }
+
+        const QStringList subLayers = dataset->dataProvider()->subLayers();
+        if (subLayers.size() <= 1)
+        {
+            layers.append(dataset);
+            return layers;
+        }
+        delete dataset;
+
+        for (const QString &subLayer : subLayers)
+        {
+            // index, name, feature count, geometry type
+            const QStringList parts = subLayer.split(QStringLiteral("!!::!!"));
+            if (parts.size() < 2)
+                continue;
+            const QString uri = QStringLiteral("%1|layername=%2").arg(path, parts[1]);
+            layers.append(new QgsVectorLayer(uri, parts[1], QStringLiteral("ogr"), options));
+        }
+        return layers;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QgsApplication app(argc, argv, false);
+    QCoreApplication::setApplicationName(QStringLiteral("TopologyCheckerCli"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Runs a topology check list on vector datasets."));
+    parser.addHelpOption();
+    QCommandLineOption planOption({QStringLiteral("p"), QStringLiteral("plan")}, QStringLiteral("Check list file saved from the plugin."), QStringLiteral("file"));
+    QCommandLineOption outputOption({QStringLiteral("o"), QStringLiteral("output")}, QStringLiteral("GeoPackage the errors are written to."), QStringLiteral("file"));
+    QCommandLineOption precisionOption(QStringLiteral("precision"), QStringLiteral("Tolerance as number of decimal digits (default 8)."), QStringLiteral("digits"), QStringLiteral("8"));
+    parser.addOption(planOption);
+    parser.addOption(outputOption);
+    QCommandLineOption memoryOption(QStringLiteral("memory-budget"), QStringLiteral("Check tile by tile, holding features for about this many megabytes at a time, tiles read ahead included."), QStringLiteral("MB"));
+    QCommandLineOption prefetchOption(QStringLiteral("prefetch"), QStringLiteral("Number of tiles read ahead in a tiled run (default 1)."), QStringLiteral("tiles"), QStringLiteral("1"));
+    QCommandLineOption statsOption(QStringLiteral("stats"), QStringLiteral("Print the feature cache and reading statistics of every layer and the thread utilisation."));
+    QCommandLineOption noSpatialOrderOption(QStringLiteral("no-spatial-order"), QStringLiteral("Visit the features in id hash order instead of along a Hilbert curve, to compare the cache hit rates."));
+    QCommandLineOption profileOption(QStringLiteral("profile"), QStringLiteral("Write where the time went per check and layer to a JSON file."), QStringLiteral("file"));
+    parser.addOption(precisionOption);
+    parser.addOption(memoryOption);
+    parser.addOption(prefetchOption);
+    parser.addOption(statsOption);
+    parser.addOption(noSpatialOrderOption);
+    QCommandLineOption traceOption(QStringLiteral("trace"), QStringLiteral("Write the spans of the run as Chrome trace events, for chrome://tracing or Perfetto."), QStringLiteral("file"));
+    parser.addOption(profileOption);
+    parser.addOption(traceOption);
+    parser.addPositionalArgument(QStringLiteral("datasets"), QStringLiteral("Vector datasets to check."), QStringLiteral("dataset..."));
+    parser.process(app);
+
+    if (!parser.isSet(planOption) || !parser.isSet(outputOption) || parser.positionalArguments().isEmpty())
+    {
+        err() << "A check list, an output file and at least one dataset are required." << endl;
+        return ExitFailed;
+    }
+
+    QgsApplication::initQgis();
+    int exitCode = ExitFailed;
+    {
+        QFile planFile(parser.value(planOption));
+        if (!planFile.open(QFile::ReadOnly | QFile::Text))
+        {
+            err() << "Could not open " << planFile.fileName() << endl;
+            QgsApplication::exitQgis();
+            return ExitFailed;
+        }
+        const QJsonDocument doc = QJsonDocument::fromJson(planFile.readAll());
+        CheckList list = CheckList::fromJson(QFileInfo(planFile.fileName()).completeBaseName(), doc.array());
+
+        QSet<QgsVectorLayer *> layers;
+        for (const QString &path : parser.positionalArguments())
+        {
+            const QList<QgsVectorLayer *> datasetLayers = openDataset(path);
+            if (datasetLayers.isEmpty())
+            {
+                err() << "Could not open " << path << endl;
+                qDeleteAll(layers);
+                QgsApplication::exitQgis();
+                return ExitFailed;
+            }
+            for (QgsVectorLayer *layer : datasetLayers)
+            {
+                if (isCheckable(layer))
+                    layers.insert(layer);
+                else
+                    delete layer;
+            }
+        }
+        list.resolveLayers(layers);
+
+        QgsCoordinateReferenceSystem crs;
+        for (QgsVectorLayer *layer : qgis::as_const(layers))
+        {
+            crs = layer->crs();
+            break;
+        }
+        CheckContext *context = new CheckContext(parser.value(precisionOption).toInt(), crs, QgsCoordinateTransformContext(), QgsProject::instance());
+
+        // Validate the whole plan before any feature is read
+        CheckPlanCompiler compiler(list);
+        const bool compiled = compiler.compile(context);
+        for (const QString &warning : compiler.warnings())
+        {
+            err() << warning << endl;
+        }
+        for (const QString &error : compiler.errors())
+        {
+            err() << error << endl;
+        }
+        const QSet<QgsVectorLayer *> processLayers = compiler.layers();
+        if (!compiled || processLayers.isEmpty())
+        {
+            if (compiled)
+                err() << "No layer of the check list was found in the datasets." << endl;
+            delete context;
+            qDeleteAll(layers);
+            QgsApplication::exitQgis();
+            return ExitFailed;
+        }
+
+        // A tiled run loads the features of each tile when it gets there
+        const qint64 memoryBudget = parser.value(memoryOption).toLongLong() * 1024 * 1024;
+        QMap<QString, FeaturePool *> featurePools;
+        for (QgsVectorLayer *layer : processLayers)
+        {
+            FeaturePool *featurePool = new VectorDataProviderFeaturePool(layer, false, memoryBudget <= 0);
+            featurePool->setSpatialOrderingEnabled(!parser.isSet(noSpatialOrderOption));
+            featurePools.insert(layer->id(), featurePool);
+        }
+        QList<Check *> checks = compiler.takeChecks();
+
+        std::unique_ptr<Checker> checker(new Checker(checks, context, featurePools));
+        // Nothing is kept in memory, every error goes to the output file. It is only created
+        // once there is an error, the errors of a previous run must not be taken for this one's.
+        const QString outputFile = parser.value(outputOption);
+        if (QFileInfo::exists(outputFile) && !QFile::remove(outputFile))
+        {
+            err() << "Could not replace " << outputFile << endl;
+            checker.reset();
+            qDeleteAll(layers);
+            QgsApplication::exitQgis();
+            return ExitFailed;
+        }
+        checker->setErrorSpill(0, outputFile);
+        if (memoryBudget > 0)
+        {
+            checker->setMemoryBudget(memoryBudget);
+            checker->setPrefetchDepth(parser.value(prefetchOption).toInt());
+            err() << "Checking in " << checker->tileCount() << " tiles" << endl;
+        }
+        checker->setProfilingEnabled(parser.isSet(profileOption));
+        if (parser.isSet(traceOption))
+            CheckTracer::start();
+
+        QEventLoop evLoop;
+        QFutureWatcher<void> futureWatcher;
+        QObject::connect(&futureWatcher, &QFutureWatcherBase::finished, &evLoop, &QEventLoop::quit);
+        futureWatcher.setFuture(checker->execute());
+        evLoop.exec();
+        checker->flushErrors();
+
+        if (parser.isSet(traceOption))
+        {
+            CheckTracer::stop();
+            if (!CheckTracer::write(parser.value(traceOption)))
+                err() << "Could not write " << parser.value(traceOption) << endl;
+            else if (CheckTracer::droppedCount() > 0)
+                err() << "The trace lacks the first " << CheckTracer::droppedCount() << " spans" << endl;
+        }
+
+        const QStringList messages = checker->getMessages();
+        for (const QString &message : messages)
+        {
+            err() << message << endl;
+        }
+
+        if (parser.isSet(statsOption))
+        {
+            const QMap<QString, FeaturePool *> pools = checker->featurePools();
+            for (const FeaturePool *pool : pools)
+            {
+                const FeaturePool::Statistics stats = pool->statistics();
+                const qint64 total = stats.cacheHits + stats.cacheMisses;
+                err() << pool->layerName() << ": " << stats.cacheHits << " of " << total << " features from the cache ("
+                      << QString::number(total > 0 ? 100.0 * stats.cacheHits / total : 0.0, 'f', 1) << "%), "
+                      << stats.evictions << " evicted" << endl;
+                err() << "  " << stats.providerFetches << " features read from the provider ("
+                      << QString::number(stats.bytesDecoded / 1048576.0, 'f', 1) << " MB), "
+                      << stats.indexQueries << " index queries returning " << QString::number(stats.averageIndexResultSize(), 'f', 1) << " ids on average, "
+                      << QString::number(stats.lockWaitTime / 1e6, 'f', 1) << " ms waited for the cache" << endl;
+            }
+            err() << "Threads were busy checking " << QString::number(100.0 * checker->utilisation(), 'f', 1) << "% of the time" << endl;
+            if (memoryBudget > 0)
+                err() << "Waited " << checker->prefetchStallTime() << " ms for tiles to be read" << endl;
+        }
+
+        if (parser.isSet(profileOption))
+        {
+            QFile profileFile(parser.value(profileOption));
+            if (!profileFile.open(QFile::WriteOnly | QFile::Truncate) || profileFile.write(QJsonDocument(checker->profileToJson()).toJson()) < 0)
+                err() << "Could not write " << profileFile.fileName() << endl;
+        }
+
+        const int errorCount = checker->spilledErrorCount();
+        QTextStream(stdout) << errorCount << " errors found" << (errorCount > 0 ? QStringLiteral(", written to %1").arg(QDir::toNativeSeparators(checker->spillFileName())) : QString()) << endl;
+
+        if (!messages.isEmpty() || checker->spillFailed())
+            exitCode = ExitFailed;
+        else
+            exitCode = errorCount > 0 ? ExitErrorsFound : ExitClean;
+
+        // The checker owns the checks, context and feature pools, which refer to the layers
+        checker.reset();
+        qDeleteAll(layers);
+    }
+    QgsApplication::exitQgis();
+    return exitCode;
+}
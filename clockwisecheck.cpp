@@ -11,32 +11,37 @@ QList<QgsWkbTypes::GeometryType> ClockwiseCheck::compatibleGeometryTypes() const
     return factoryCompatibleGeometryTypes();
 }
 
-void ClockwiseCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void ClockwiseCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, context());
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
-        const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
-        for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+        collectFeatureErrors(layerFeature, errors);
+    }
+}
+
+void ClockwiseCheck::collectFeatureErrors(const CheckerUtils::LayerFeature &layerFeature, CheckErrorSink &errors) const
+{
+    const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
+    for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+    {
+        const QgsAbstractGeometry *part = CheckerUtils::getGeomPart(geom, iPart);
+        const QgsLineString *line = dynamic_cast<const QgsLineString *>(part);
+        if (!line)
         {
-            const QgsAbstractGeometry *part = CheckerUtils::getGeomPart(geom, iPart);
-            const QgsLineString *line = dynamic_cast<const QgsLineString *>(part);
-            if (!line)
-            {
-                QgsLineString l;
-                for(auto it  = part->vertices_begin(); it != part->vertices_end(); ++it){
-                    l.addVertex(*it);
-                }
-                line = &l;
-            }
-            if( (line->orientation() == QgsLineString::Clockwise && reverse)
-                || (line->orientation() == QgsLineString::CounterClockwise && !reverse) ){
-                errors.append(new CheckError(this, layerFeature, part->centroid(), QgsVertexId(iPart)));
+            QgsLineString l;
+            for(auto it  = part->vertices_begin(); it != part->vertices_end(); ++it){
+                l.addVertex(*it);
             }
+            line = &l;
+        }
+        if( (line->orientation() == QgsLineString::Clockwise && reverse)
+            || (line->orientation() == QgsLineString::CounterClockwise && !reverse) ){
+            errors.append(new CheckError(this, layerFeature, part->centroid(), QgsVertexId(iPart)));
         }
     }
 }
@@ -5,14 +5,14 @@
 
 bool ConvexHullCheck::reverse = false;
 
-void ConvexHullCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void ConvexHullCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext);
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
         const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
         std::unique_ptr<QgsGeometryEngine> geomEngine = CheckerUtils::createGeomEngine(geom, mContext->tolerance);
@@ -1,4 +1,5 @@
 ﻿#include "duplicatecheck.h"
+#include "candidatepairs.h"
 #include "checkcontext.h"
 #include "qgsgeometryengine.h"
 #include "qgsspatialindex.h"
@@ -23,20 +24,21 @@ QString DuplicateCheckError::duplicatesString(const QMap<QString, FeaturePool *>
     return str.join(QLatin1String("; "));
 }
 
-void DuplicateCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void DuplicateCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, types, feedback, mContext, true);
     QList<QString> layerIds = featureIds.keys();
+    // The same pairs are compared by the other checks of the run on these layers
+    CandidatePairCache *candidatePairs = mContext->candidatePairs();
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeatureA.layer()) == layers.end())
+        if (!layers.contains(layerFeatureA.layer()))
             continue;
         // Ensure each pair of layers only gets compared once: remove the current layer from the layerIds, but add it to the layerList for layerFeaturesB
         layerIds.removeOne(layerFeatureA.layer()->id());
 
         QgsGeometry geomA = layerFeatureA.geometry();
-        QgsRectangle bboxA = geomA.boundingBox();
         std::unique_ptr<QgsGeometryEngine> geomEngineA = CheckerUtils::createGeomEngine(geomA.constGet(), mContext->tolerance);
         if (!geomEngineA->isValid())
         {
@@ -46,27 +48,31 @@ void DuplicateCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePo
         QMap<QString, QList<QgsFeatureId>> duplicates;
 
         QgsWkbTypes::GeometryType geomType = geomA.type();
-        CheckerUtils::LayerFeatures layerFeaturesB(featurePools, QList<QString>() << layerFeatureA.layer()->id() << layerIds, bboxA, {geomType}, mContext);
-        for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
+        for (const QString &layerIdB : QList<QString>() << layerFeatureA.layerId() << layerIds)
         {
-            if (std::find(layers.begin(), layers.end(), layerFeatureB.layer()) == layers.end())
+            FeaturePool *featurePoolB = featurePools.value(layerIdB);
+            if (featurePoolB->geometryType() != geomType || !layers.contains(featurePoolB->layerPtr().data()))
                 continue;
-            // > : only report overlaps within same layer once
-            if (layerFeatureA.layer()->id() == layerFeatureB.layer()->id() && layerFeatureB.feature().id() >= layerFeatureA.feature().id())
+            for (QgsFeatureId idB : candidatePairs->candidates(featurePools, layerFeatureA, layerIdB, mContext->tolerance, mContext))
             {
-                continue;
-            }
+                // > : only report overlaps within same layer once, the candidates are sorted
+                if (layerIdB == layerFeatureA.layerId() && idB >= layerFeatureA.feature().id())
+                    break;
+                CheckerUtils::LayerFeature layerFeatureB;
+                if (!candidatePairs->layerFeature(featurePoolB, idB, mContext, layerFeatureB))
+                    continue;
 
-            const QgsGeometry geomB = layerFeatureB.geometry();
-            QString errMsg;
-            const bool equal = geomEngineA->isEqual( geomB.constGet(), &errMsg );
-            if (equal && errMsg.isEmpty())
-            {
-                duplicates[layerFeatureB.layer()->id()].append(layerFeatureB.feature().id());
-            }
-            else if (!errMsg.isEmpty())
-            {
-                messages.append(tr("Duplicate check failed for (%1, %2): %3").arg(layerFeatureA.id(), layerFeatureB.id(), errMsg));
+                const QgsGeometry geomB = layerFeatureB.geometry();
+                QString errMsg;
+                const bool equal = geomEngineA->isEqual( geomB.constGet(), &errMsg );
+                if (equal && errMsg.isEmpty())
+                {
+                    duplicates[layerIdB].append(idB);
+                }
+                else if (!errMsg.isEmpty())
+                {
+                    messages.append(tr("Duplicate check failed for (%1, %2): %3").arg(layerFeatureA.id(), layerFeatureB.id(), errMsg));
+                }
             }
         }
         if (!duplicates.isEmpty())
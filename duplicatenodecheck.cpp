@@ -4,7 +4,7 @@
 #include "featurepool.h"
 #include "checkerror.h"
 
-void DuplicateNodeCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void DuplicateNodeCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
 
@@ -12,24 +12,29 @@ void DuplicateNodeCheck::collectErrors(const QMap<QString, FeaturePool *> &featu
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext);
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
-        const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
-        for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+        collectFeatureErrors(layerFeature, errors);
+    }
+}
+
+void DuplicateNodeCheck::collectFeatureErrors(const CheckerUtils::LayerFeature &layerFeature, CheckErrorSink &errors) const
+{
+    const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
+    for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+    {
+        for (int iRing = 0, nRings = geom->ringCount(iPart); iRing < nRings; ++iRing)
         {
-            for (int iRing = 0, nRings = geom->ringCount(iPart); iRing < nRings; ++iRing)
+            int nVerts = CheckerUtils::polyLineSize(geom, iPart, iRing);
+            if (nVerts < 2)
+                continue;
+            for (int iVert = nVerts - 1, jVert = 0; jVert < nVerts; iVert = jVert++)
             {
-                int nVerts = CheckerUtils::polyLineSize(geom, iPart, iRing);
-                if (nVerts < 2)
-                    continue;
-                for (int iVert = nVerts - 1, jVert = 0; jVert < nVerts; iVert = jVert++)
+                QgsPoint pi = geom->vertexAt(QgsVertexId(iPart, iRing, iVert));
+                QgsPoint pj = geom->vertexAt(QgsVertexId(iPart, iRing, jVert));
+                if (QgsGeometryUtils::sqrDistance2D(pi, pj) < mContext->tolerance)
                 {
-                    QgsPoint pi = geom->vertexAt(QgsVertexId(iPart, iRing, iVert));
-                    QgsPoint pj = geom->vertexAt(QgsVertexId(iPart, iRing, jVert));
-                    if (QgsGeometryUtils::sqrDistance2D(pi, pj) < mContext->tolerance)
-                    {
-                        errors.append(new CheckError(this, layerFeature, pj, QgsVertexId(iPart, iRing, jVert)));
-                    }
+                    errors.append(new CheckError(this, layerFeature, pj, QgsVertexId(iPart, iRing, jVert)));
                 }
             }
         }
@@ -22,9 +22,32 @@
 #include "qgsvectordataprovider.h"
 #include "qgsvectorlayerutils.h"
 #include "qgsreadwritelocker.h"
+#include "checkprofile.h"
+#include "checktracer.h"
 
+#include <QElapsedTimer>
 #include <QMutexLocker>
+#include <algorithm>
 
+namespace
+{
+  // Size of the coordinates and attribute values of a feature read from a data provider
+  qint64 decodedSize( const QgsFeature &feature )
+  {
+    qint64 bytes = 0;
+    if ( const QgsAbstractGeometry *geometry = feature.geometry().constGet() )
+    {
+      const int dimensions = 2 + ( geometry->is3D() ? 1 : 0 ) + ( geometry->isMeasure() ? 1 : 0 );
+      bytes += static_cast<qint64>( geometry->nCoordinates() ) * dimensions * static_cast<qint64>( sizeof( double ) );
+    }
+    const QgsAttributes attributes = feature.attributes();
+    for ( const QVariant &attribute : attributes )
+    {
+      bytes += attribute.type() == QVariant::String ? 2 * attribute.toString().size() : 8;
+    }
+    return bytes;
+  }
+}
 
 FeaturePool::FeaturePool( QgsVectorLayer *layer )
   : mFeatureCache( CACHE_SIZE )
@@ -32,6 +55,7 @@ FeaturePool::FeaturePool( QgsVectorLayer *layer )
   , mGeometryType( layer->geometryType() )
   , mFeatureSource( qgis::make_unique<QgsVectorLayerFeatureSource>( layer ) )
   , mLayerName( layer->name() )
+  , mLayerId( layer->id() )
 {
 
 }
@@ -46,36 +70,59 @@ bool FeaturePool::getFeature( QgsFeatureId id, QgsFeature &feature )
   //
   // https://bugreports.qt.io/browse/QTBUG-19794
 
-  QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Write );
+  CheckTracer::Span span( "getFeature", "pool" );
+  QElapsedTimer timer;
+  const bool profiling = CheckProfile::Recorder::isRecording();
+  if ( profiling )
+    timer.start();
+
+  // This is the lock all check threads meet at, count how long they wait for it
+  mCacheLockWait.lockForWrite( mCacheLock );
+  bool found = true;
+  bool cached = true;
   QgsFeature *cachedFeature = mFeatureCache.object( id );
   if ( cachedFeature )
   {
     //feature was cached
     feature = *cachedFeature;
+    mCacheHits.fetch_add( 1, std::memory_order_relaxed );
   }
   else
   {
     // Feature not in cache, retrieve from layer
     // TODO: avoid always querying all attributes (attribute values are needed when merging by attribute)
-    if ( !mFeatureSource->getFeatures( QgsFeatureRequest( id ) ).nextFeature( feature ) )
+    mCacheMisses.fetch_add( 1, std::memory_order_relaxed );
+    cached = false;
+    found = mFeatureSource->getFeatures( QgsFeatureRequest( id ) ).nextFeature( feature );
+    if ( found )
     {
-      return false;
+      countProviderFetch( feature );
+      cacheFeature( feature );
+      mIndex.addFeature( feature );
     }
-    locker.changeMode( QgsReadWriteLocker::Write );
-    mFeatureCache.insert( id, new QgsFeature( feature ) );
-    mIndex.addFeature( feature );
   }
-  return true;
+  mCacheLock.unlock();
+
+  if ( profiling )
+  {
+    CheckProfile::Counters *counters = CheckProfile::Recorder::counters( mLayerId );
+    counters->fetchTime += timer.nsecsElapsed();
+    counters->cacheMisses += cached ? 0 : 1;
+  }
+  return found;
 }
 
 QgsFeatureIds FeaturePool::getFeatures( const QgsFeatureRequest &request, QgsFeedback *feedback )
 {
+  CheckTracer::Span span( "getFeatures", "pool" );
   QgsReadWriteLocker( mCacheLock, QgsReadWriteLocker::Write );
   Q_UNUSED( feedback )
   Q_ASSERT( QThread::currentThread() == qApp->thread() );
 
   mFeatureCache.clear();
   mIndex = QgsSpatialIndex();
+  mInsertedFeatures.store( 0 );
+  mInsertedVertices.store( 0 );
 
   QgsFeatureIds fids;
 
@@ -85,6 +132,7 @@ QgsFeatureIds FeaturePool::getFeatures( const QgsFeatureRequest &request, QgsFee
   QgsFeature feature;
   while ( it.nextFeature( feature ) )
   {
+    countProviderFetch( feature );
     insertFeature( feature, true );
     fids << feature.id();
   }
@@ -99,8 +147,12 @@ QgsFeatureIds FeaturePool::allFeatureIds() const
 
 QgsFeatureIds FeaturePool::getIntersects( const QgsRectangle &rect ) const
 {
-  QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Read );
+  CheckTracer::Span span( "getIntersects", "index" );
+  mCacheLockWait.lockForRead( mCacheLock );
   QgsFeatureIds ids = qgis::listToSet( mIndex.intersects( rect ) );
+  mCacheLock.unlock();
+  mIndexQueries.fetch_add( 1, std::memory_order_relaxed );
+  mIndexResults.fetch_add( ids.size(), std::memory_order_relaxed );
   return ids;
 }
 
@@ -121,9 +173,27 @@ void FeaturePool::insertFeature( const QgsFeature &feature, bool skipLock )
   QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Unlocked );
   if ( !skipLock )
     locker.changeMode( QgsReadWriteLocker::Write );
-  mFeatureCache.insert( feature.id(), new QgsFeature( feature ) );
+  cacheFeature( feature );
   QgsFeature indexFeature( feature );
   mIndex.addFeature( indexFeature );
+  FeatureFingerprint &fingerprint = mFingerprints[feature.id()];
+  fingerprint.hash = 0;
+  fingerprint.bbox = feature.geometry().boundingBox();
+  mInsertedFeatures.fetch_add( 1, std::memory_order_relaxed );
+  if ( const QgsAbstractGeometry *geometry = feature.geometry().constGet() )
+  {
+    mInsertedVertices.fetch_add( geometry->nCoordinates(), std::memory_order_relaxed );
+  }
+}
+
+void FeaturePool::cacheFeature( const QgsFeature &feature )
+{
+  // QCache silently drops the least recently used features when it is full
+  if ( mFeatureCache.totalCost() >= mFeatureCache.maxCost() && !mFeatureCache.contains( feature.id() ) )
+  {
+    mEvictions.fetch_add( 1, std::memory_order_relaxed );
+  }
+  mFeatureCache.insert( feature.id(), new QgsFeature( feature ) );
 }
 
 void FeaturePool::refreshCache( const QgsFeature &feature )
@@ -134,7 +204,13 @@ void FeaturePool::refreshCache( const QgsFeature &feature )
   locker.unlock();
 
   QgsFeature tempFeature;
-  getFeature( feature.id(), tempFeature );
+  if ( getFeature( feature.id(), tempFeature ) )
+  {
+    locker.changeMode( QgsReadWriteLocker::Write );
+    FeatureFingerprint &fingerprint = mFingerprints[tempFeature.id()];
+    fingerprint.hash = 0;
+    fingerprint.bbox = tempFeature.geometry().boundingBox();
+  }
 }
 
 void FeaturePool::removeFeature( const QgsFeatureId featureId )
@@ -148,11 +224,270 @@ void FeaturePool::removeFeature( const QgsFeatureId featureId )
   }
   locker.changeMode( QgsReadWriteLocker::Write );
   mFeatureCache.remove( origFeature.id() );
+  mFingerprints.remove( featureId );
 }
 
 void FeaturePool::setFeatureIds( const QgsFeatureIds &ids )
 {
   mFeatureIds = ids;
+
+  // Sort the features along a Hilbert curve over the extent of the layer
+  QgsRectangle extent;
+  for ( QgsFeatureId id : ids )
+  {
+    const FeatureFingerprint fingerprint = mFingerprints.value( id );
+    if ( !fingerprint.bbox.isNull() )
+    {
+      extent.combineExtentWith( fingerprint.bbox );
+    }
+  }
+  const double width = extent.width() > 0 ? extent.width() : 1.;
+  const double height = extent.height() > 0 ? extent.height() : 1.;
+
+  QVector<QPair<quint64, QgsFeatureId> > keys;
+  keys.reserve( ids.size() );
+  mSpatialKeys.clear();
+  mSpatialKeys.reserve( ids.size() );
+  for ( QgsFeatureId id : ids )
+  {
+    const QgsPointXY center = mFingerprints.value( id ).bbox.center();
+    const quint32 x = static_cast<quint32>( qBound( 0., ( center.x() - extent.xMinimum() ) / width, 1. ) * HILBERT_MAX );
+    const quint32 y = static_cast<quint32>( qBound( 0., ( center.y() - extent.yMinimum() ) / height, 1. ) * HILBERT_MAX );
+    const quint64 key = hilbertIndex( x, y );
+    keys.append( qMakePair( key, id ) );
+    mSpatialKeys.insert( id, key );
+  }
+  std::sort( keys.begin(), keys.end() );
+
+  mSpatialOrder.clear();
+  mSpatialOrder.reserve( keys.size() );
+  for ( const QPair<quint64, QgsFeatureId> &key : qgis::as_const( keys ) )
+  {
+    mSpatialOrder.append( key.second );
+  }
+}
+
+quint64 FeaturePool::hilbertIndex( quint32 x, quint32 y )
+{
+  quint64 index = 0;
+  for ( quint32 s = ( HILBERT_MAX + 1 ) / 2; s > 0; s /= 2 )
+  {
+    const quint32 rx = ( x & s ) > 0;
+    const quint32 ry = ( y & s ) > 0;
+    index += static_cast<quint64>( s ) * s * ( ( 3 * rx ) ^ ry );
+    // Rotate the quadrant so that the curve stays continuous
+    if ( ry == 0 )
+    {
+      if ( rx == 1 )
+      {
+        x = HILBERT_MAX - x;
+        y = HILBERT_MAX - y;
+      }
+      std::swap( x, y );
+    }
+  }
+  return index;
+}
+
+QList<QgsFeatureId> FeaturePool::spatiallyOrdered( const QgsFeatureIds &ids ) const
+{
+  QList<QgsFeatureId> ordered;
+  ordered.reserve( ids.size() );
+  if ( !mSpatialOrderingEnabled )
+  {
+    for ( QgsFeatureId id : ids )
+    {
+      ordered.append( id );
+    }
+    return ordered;
+  }
+  QList<QgsFeatureId> unordered;
+  if ( ids.size() * 4 >= mSpatialOrder.size() )
+  {
+    // Most features are requested, filter the full order
+    for ( QgsFeatureId id : mSpatialOrder )
+    {
+      if ( ids.contains( id ) )
+      {
+        ordered.append( id );
+      }
+    }
+    if ( ordered.size() < ids.size() )
+    {
+      for ( QgsFeatureId id : ids )
+      {
+        if ( !mSpatialKeys.contains( id ) )
+        {
+          unordered.append( id );
+        }
+      }
+    }
+  }
+  else
+  {
+    QVector<QPair<quint64, QgsFeatureId> > keys;
+    keys.reserve( ids.size() );
+    for ( QgsFeatureId id : ids )
+    {
+      auto it = mSpatialKeys.constFind( id );
+      if ( it != mSpatialKeys.constEnd() )
+      {
+        keys.append( qMakePair( it.value(), id ) );
+      }
+      else
+      {
+        unordered.append( id );
+      }
+    }
+    std::sort( keys.begin(), keys.end() );
+    for ( const QPair<quint64, QgsFeatureId> &key : qgis::as_const( keys ) )
+    {
+      ordered.append( key.second );
+    }
+  }
+  ordered.append( unordered );
+  return ordered;
+}
+
+QgsFeatureIds FeaturePool::loadExtent( const QgsRectangle &extent )
+{
+  return loadFeatures( fetchExtent( extent ) );
+}
+
+QgsFeatureList FeaturePool::fetchExtent( const QgsRectangle &extent ) const
+{
+  QgsFeatureList features;
+  // A null rectangle would not filter at all
+  if ( extent.isNull() )
+  {
+    return features;
+  }
+  QgsFeatureIterator it = mFeatureSource->getFeatures( QgsFeatureRequest().setFilterRect( extent ) );
+  QgsFeature feature;
+  while ( it.nextFeature( feature ) )
+  {
+    if ( feature.hasGeometry() )
+    {
+      // Parse the geometry here instead of on the check threads
+      feature.geometry().constGet();
+      countProviderFetch( feature );
+      features.append( feature );
+    }
+  }
+  return features;
+}
+
+QgsFeatureIds FeaturePool::loadFeatures( const QgsFeatureList &features )
+{
+  QgsFeatureIds fids;
+  {
+    QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Write );
+    mFeatureCache.clear();
+    // Keep the whole tile cached, its size is bounded by the memory budget of the run
+    mFeatureCache.setMaxCost( features.size() > CACHE_SIZE ? features.size() : CACHE_SIZE );
+    mIndex = QgsSpatialIndex();
+    mFingerprints.clear();
+    mInsertedFeatures.store( 0 );
+    mInsertedVertices.store( 0 );
+    for ( const QgsFeature &feature : features )
+    {
+      insertFeature( feature, true );
+      fids.insert( feature.id() );
+    }
+  }
+  setFeatureIds( fids );
+  return fids;
+}
+
+void FeaturePool::releaseFeatures()
+{
+  QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Write );
+  mFeatureCache.clear();
+  mFeatureCache.setMaxCost( CACHE_SIZE );
+  mIndex = QgsSpatialIndex();
+  QHash<QgsFeatureId, FeatureFingerprint>().swap( mFingerprints );
+  QgsFeatureIds().swap( mFeatureIds );
+  QList<QgsFeatureId>().swap( mSpatialOrder );
+  QHash<QgsFeatureId, quint64>().swap( mSpatialKeys );
+  mInsertedFeatures.store( 0 );
+  mInsertedVertices.store( 0 );
+}
+
+qint64 FeaturePool::estimateFeatureSize( int sampleSize ) const
+{
+  // Cache entry, spatial index entry, fingerprint and ordering key of a feature
+  static const qint64 FEATURE_OVERHEAD = 512;
+
+  qint64 bytes = 0;
+  int count = 0;
+  QgsFeatureIterator it = mFeatureSource->getFeatures( QgsFeatureRequest().setLimit( sampleSize ) );
+  QgsFeature feature;
+  while ( it.nextFeature( feature ) )
+  {
+    // The geometry is held twice, parsed and as WKB when stored with an error
+    bytes += 2 * feature.geometry().asWkb().size();
+    const QgsAttributes attributes = feature.attributes();
+    for ( const QVariant &attribute : attributes )
+    {
+      bytes += 16 + attribute.toString().size() * 2;
+    }
+    ++count;
+  }
+  return count > 0 ? bytes / count + FEATURE_OVERHEAD : FEATURE_OVERHEAD;
+}
+
+double FeaturePool::averageVertexCount() const
+{
+  const qint64 features = mInsertedFeatures.load( std::memory_order_relaxed );
+  return features > 0 ? static_cast<double>( mInsertedVertices.load( std::memory_order_relaxed ) ) / features : 0.;
+}
+
+qint64 FeaturePool::cacheHits() const
+{
+  return mCacheHits.load( std::memory_order_relaxed );
+}
+
+qint64 FeaturePool::cacheMisses() const
+{
+  return mCacheMisses.load( std::memory_order_relaxed );
+}
+
+const LockWaitCounter &FeaturePool::cacheLockWait() const
+{
+  return mCacheLockWait;
+}
+
+FeaturePool::Statistics FeaturePool::statistics() const
+{
+  Statistics statistics;
+  statistics.cacheHits = mCacheHits.load( std::memory_order_relaxed );
+  statistics.cacheMisses = mCacheMisses.load( std::memory_order_relaxed );
+  statistics.evictions = mEvictions.load( std::memory_order_relaxed );
+  statistics.providerFetches = mProviderFetches.load( std::memory_order_relaxed );
+  statistics.bytesDecoded = mBytesDecoded.load( std::memory_order_relaxed );
+  statistics.indexQueries = mIndexQueries.load( std::memory_order_relaxed );
+  statistics.indexResults = mIndexResults.load( std::memory_order_relaxed );
+  statistics.lockWaitTime = mCacheLockWait.waitTime();
+  statistics.lockContentions = mCacheLockWait.contentionCount();
+  return statistics;
+}
+
+void FeaturePool::resetStatistics()
+{
+  mCacheHits.store( 0, std::memory_order_relaxed );
+  mCacheMisses.store( 0, std::memory_order_relaxed );
+  mEvictions.store( 0, std::memory_order_relaxed );
+  mProviderFetches.store( 0, std::memory_order_relaxed );
+  mBytesDecoded.store( 0, std::memory_order_relaxed );
+  mIndexQueries.store( 0, std::memory_order_relaxed );
+  mIndexResults.store( 0, std::memory_order_relaxed );
+  mCacheLockWait.reset();
+}
+
+void FeaturePool::countProviderFetch( const QgsFeature &feature ) const
+{
+  mProviderFetches.fetch_add( 1, std::memory_order_relaxed );
+  mBytesDecoded.fetch_add( decodedSize( feature ), std::memory_order_relaxed );
 }
 
 bool FeaturePool::isFeatureCached( QgsFeatureId fid )
@@ -166,6 +501,53 @@ QString FeaturePool::layerName() const
   return mLayerName;
 }
 
+QHash<QgsFeatureId, FeaturePool::FeatureFingerprint> FeaturePool::fingerprints()
+{
+  QgsReadWriteLocker locker( mCacheLock, QgsReadWriteLocker::Write );
+  QgsFeatureIds unhashed;
+  for ( auto it = mFingerprints.constBegin(); it != mFingerprints.constEnd(); ++it )
+  {
+    if ( it.value().hash == 0 )
+    {
+      unhashed.insert( it.key() );
+    }
+  }
+  if ( !unhashed.isEmpty() )
+  {
+    // Read in one request, most of the features have long left the cache
+    QgsFeatureIterator it = mFeatureSource->getFeatures( QgsFeatureRequest().setFilterFids( unhashed ) );
+    QgsFeature feature;
+    while ( it.nextFeature( feature ) )
+    {
+      countProviderFetch( feature );
+      mFingerprints[feature.id()].hash = featureHash( feature );
+    }
+  }
+  return mFingerprints;
+}
+
+quint64 FeaturePool::featureHash( const QgsFeature &feature )
+{
+  // FNV-1a over the geometry WKB and the attribute values
+  quint64 hash = Q_UINT64_C( 14695981039346656037 );
+  auto hashBytes = [&hash]( const QByteArray & bytes )
+  {
+    for ( const char c : bytes )
+    {
+      hash ^= static_cast<unsigned char>( c );
+      hash *= Q_UINT64_C( 1099511628211 );
+    }
+  };
+  hashBytes( feature.geometry().asWkb() );
+  const QgsAttributes attributes = feature.attributes();
+  for ( const QVariant &attribute : attributes )
+  {
+    hashBytes( attribute.isNull() ? QByteArray( 1, '\1' ) : attribute.toString().toUtf8() );
+    hashBytes( QByteArray( 1, '\0' ) );
+  }
+  return hash;
+}
+
 QgsCoordinateReferenceSystem FeaturePool::crs() const
 {
   QgsReadWriteLocker( mCacheLock, QgsReadWriteLocker::Read );
@@ -179,6 +561,5 @@ QgsWkbTypes::GeometryType FeaturePool::geometryType() const
 
 QString FeaturePool::layerId() const
 {
-  QgsReadWriteLocker( mCacheLock, QgsReadWriteLocker::Read );
-  return mFeatureSource->id();
+  return mLayerId;
 }
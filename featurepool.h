@@ -18,14 +18,17 @@
 #define FEATUREPOOL_H
 
 #include <QCache>
+#include <QHash>
 #include <QMutex>
 #include <QPointer>
+#include <atomic>
 
 
 #include "qgsfeature.h"
 #include "qgsspatialindex.h"
 #include "qgsfeaturesink.h"
 #include "qgsvectorlayerfeatureiterator.h"
+#include "lockwaitcounter.h"
 
 /**
  * \ingroup analysis
@@ -39,6 +42,47 @@ class FeaturePool : public QgsFeatureSink SIP_ABSTRACT
 
   public:
 
+    /**
+     * Identifies the state of a feature: a hash over its geometry and attributes
+     * and its bounding box in the layer crs.
+     * Used to detect the features which changed between two checker runs.
+     */
+    struct FeatureFingerprint
+    {
+      //! 0 until fingerprints() hashed the feature
+      quint64 hash = 0;
+      QgsRectangle bbox;
+    };
+
+    /**
+     * What the pool has done since it was created or its statistics were reset.
+     * Used to size the feature cache and to see whether reading ahead pays off.
+     */
+    struct Statistics
+    {
+      //! Features getFeature() found in the cache
+      qint64 cacheHits = 0;
+      //! Features getFeature() had to fetch from the layer
+      qint64 cacheMisses = 0;
+      //! Features the cache dropped to make room for others
+      qint64 evictions = 0;
+      //! Features read from the data provider, by getFeature() or in bulk
+      qint64 providerFetches = 0;
+      //! Approximate size of the geometries and attributes read from the data provider
+      qint64 bytesDecoded = 0;
+      //! Spatial index queries made by getIntersects() and the ids they returned
+      qint64 indexQueries = 0;
+      qint64 indexResults = 0;
+      //! Time in nanoseconds threads waited for the feature cache, and how often they did
+      qint64 lockWaitTime = 0;
+      qint64 lockContentions = 0;
+
+      /**
+       * Returns the average number of ids a spatial index query returned.
+       */
+      double averageIndexResultSize() const { return indexQueries > 0 ? static_cast<double>( indexResults ) / indexQueries : 0.; }
+    };
+
     /**
      * Creates a new feature pool for \a layer.
      */
@@ -84,6 +128,109 @@ class FeaturePool : public QgsFeatureSink SIP_ABSTRACT
      */
     QgsFeatureIds allFeatureIds() const SIP_SKIP;
 
+    /**
+     * Returns \a ids ordered along a Hilbert curve through the centres of the feature bounding boxes,
+     * so that features which are close on the map follow each other and their neighbours stay in the cache.
+     * Features added after the pool was filled are put last.
+     *
+     * \note not available in Python bindings
+     */
+    QList<QgsFeatureId> spatiallyOrdered( const QgsFeatureIds &ids ) const SIP_SKIP;
+
+    /**
+     * Sets whether spatiallyOrdered() sorts the features along the Hilbert curve, TRUE by default.
+     * Without it the ids are returned in the order of the set, to compare the cache hit rates of both.
+     * Must not be called while checks are running.
+     *
+     * \note not available in Python bindings
+     */
+    void setSpatialOrderingEnabled( bool enabled ) SIP_SKIP { mSpatialOrderingEnabled = enabled; }
+
+    /**
+     * Replaces the features of this pool with all features of the layer intersecting \a extent,
+     * given in the layer crs, and returns their ids. The feature source of the pool is read,
+     * this may be called from any thread while no check is running.
+     * Used to check the layer tile by tile.
+     *
+     * \note not available in Python bindings
+     */
+    QgsFeatureIds loadExtent( const QgsRectangle &extent ) SIP_SKIP;
+
+    /**
+     * Reads all features of the layer intersecting \a extent, given in the layer crs, without
+     * adding them to the pool. Geometries are parsed already. Thread safe, used to prefetch tiles.
+     *
+     * \note not available in Python bindings
+     */
+    QgsFeatureList fetchExtent( const QgsRectangle &extent ) const SIP_SKIP;
+
+    /**
+     * Replaces the features of this pool with \a features and returns their ids.
+     * May be called from any thread while no check is running.
+     *
+     * \note not available in Python bindings
+     */
+    QgsFeatureIds loadFeatures( const QgsFeatureList &features ) SIP_SKIP;
+
+    /**
+     * Releases all features of this pool, with the cache and the spatial index.
+     *
+     * \note not available in Python bindings
+     */
+    void releaseFeatures() SIP_SKIP;
+
+    /**
+     * Returns an estimate of the memory in bytes a feature of the layer takes in the pool,
+     * based on up to \a sampleSize features read from the layer.
+     *
+     * \note not available in Python bindings
+     */
+    qint64 estimateFeatureSize( int sampleSize = 100 ) const SIP_SKIP;
+
+    /**
+     * Returns the average number of vertices of the features loaded into the pool,
+     * 0 if no features have been loaded. Used to estimate the cost of checks.
+     *
+     * \note not available in Python bindings
+     */
+    double averageVertexCount() const SIP_SKIP;
+
+    /**
+     * Returns the number of features getFeature() found in the cache.
+     *
+     * \note not available in Python bindings
+     */
+    qint64 cacheHits() const SIP_SKIP;
+
+    /**
+     * Returns the number of features getFeature() had to fetch from the layer.
+     *
+     * \note not available in Python bindings
+     */
+    qint64 cacheMisses() const SIP_SKIP;
+
+    /**
+     * Returns the time threads waited for the feature cache in getFeature() and getIntersects().
+     *
+     * \note not available in Python bindings
+     */
+    const LockWaitCounter &cacheLockWait() const SIP_SKIP;
+
+    /**
+     * Returns the statistics of the pool. May be called from any thread, also while checks are running,
+     * the counters are then read one after the other.
+     *
+     * \note not available in Python bindings
+     */
+    Statistics statistics() const SIP_SKIP;
+
+    /**
+     * Sets all statistics back to 0, to count them for the next run.
+     *
+     * \note not available in Python bindings
+     */
+    void resetStatistics() SIP_SKIP;
+
     /**
      * Gets all feature ids in the bounding box \a rect. It will use a spatial index to
      * determine the ids.
@@ -133,6 +280,23 @@ class FeaturePool : public QgsFeatureSink SIP_ABSTRACT
      */
     QString layerName() const;
 
+    /**
+     * Returns the fingerprints of all the features which have been inserted into this pool.
+     * The features are only hashed here, runs without snapshots do not pay for it. The hashes
+     * are kept in the pool: a second call only reads and hashes the features inserted, changed
+     * or refreshed since the first one, the other fingerprints are returned as they are.
+     *
+     * \note not available in Python bindings
+     */
+    QHash<QgsFeatureId, FeaturePool::FeatureFingerprint> fingerprints() SIP_SKIP;
+
+    /**
+     * Computes the hash of the geometry and the attributes of \a feature.
+     *
+     * \note not available in Python bindings
+     */
+    static quint64 featureHash( const QgsFeature &feature ) SIP_SKIP;
+
   protected:
 
     /**
@@ -170,6 +334,14 @@ class FeaturePool : public QgsFeatureSink SIP_ABSTRACT
      */
     bool isFeatureCached( QgsFeatureId fid ) SIP_SKIP;
 
+    /**
+     * Counts \a feature as read from the data provider in the statistics.
+     * To be called by implementations for the features they read themselves.
+     *
+     * \note not available in Python bindings
+     */
+    void countProviderFetch( const QgsFeature &feature ) const SIP_SKIP;
+
   private:
 #ifdef SIP_RUN
     FeaturePool( const FeaturePool &other )
@@ -177,14 +349,42 @@ class FeaturePool : public QgsFeatureSink SIP_ABSTRACT
 #endif
 
     static const int CACHE_SIZE = 1000;
+    //! Largest grid coordinate of the Hilbert curve, 16 bits per axis
+    static const quint32 HILBERT_MAX = 0xFFFF;
+
+    static quint64 hilbertIndex( quint32 x, quint32 y );
+
+    /**
+     * Inserts \a feature into the cache, counting the feature the cache drops for it.
+     * The cache lock must be held for writing.
+     */
+    void cacheFeature( const QgsFeature &feature );
+
     QCache<QgsFeatureId, QgsFeature> mFeatureCache;
     QPointer<QgsVectorLayer> mLayer;
     mutable QReadWriteLock mCacheLock;
+    mutable LockWaitCounter mCacheLockWait;
     QgsFeatureIds mFeatureIds;
     QgsSpatialIndex mIndex;
+    QHash<QgsFeatureId, FeatureFingerprint> mFingerprints;
+    QList<QgsFeatureId> mSpatialOrder;
+    QHash<QgsFeatureId, quint64> mSpatialKeys;
+    bool mSpatialOrderingEnabled = true;
+    // Atomic, the statistics are read while the checks are running
+    std::atomic<qint64> mCacheHits{ 0 };
+    std::atomic<qint64> mCacheMisses{ 0 };
+    std::atomic<qint64> mEvictions{ 0 };
+    mutable std::atomic<qint64> mProviderFetches{ 0 };
+    mutable std::atomic<qint64> mBytesDecoded{ 0 };
+    mutable std::atomic<qint64> mIndexQueries{ 0 };
+    mutable std::atomic<qint64> mIndexResults{ 0 };
+    // Features inserted into the pool and their vertices
+    std::atomic<qint64> mInsertedFeatures{ 0 };
+    std::atomic<qint64> mInsertedVertices{ 0 };
     QgsWkbTypes::GeometryType mGeometryType;
     std::unique_ptr<QgsVectorLayerFeatureSource> mFeatureSource;
     QString mLayerName;
+    QString mLayerId;
 };
 
 #endif // FEATUREPOOL_H
@@ -10,8 +10,7 @@
 #include "qgsexpressioncontextutils.h"
 #include "qgspolygon.h"
 #include "qgscurve.h"
-
-#include "geos_c.h"
+#include "polygoncoverage.h"
 
 GapCheck::GapCheck(const CheckContext *context, const QVariantMap &configuration)
     : Check(context, configuration),
@@ -41,11 +40,8 @@ void GapCheck::prepare(const CheckContext *context, const QVariantMap &configura
     }
 }
 
-void GapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void GapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
-    if (feedback)
-        feedback->setProgress(feedback->progress() + 1.0);
-
     std::unique_ptr<QgsAbstractGeometry> allowedGapsGeom;
     std::unique_ptr<QgsGeometryEngine> allowedGapsGeomEngine;
 
@@ -59,6 +55,8 @@ void GapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, Q
 
         while (iterator.nextFeature(feature))
         {
+            if (feedback && feedback->isCanceled())
+                return;
             QgsGeometry geom = feature.geometry();
             QgsGeometry gg = geom.buffer(mAllowedGapsBuffer, 20);
             allowedGaps.append(gg);
@@ -73,75 +71,28 @@ void GapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, Q
         allowedGapsGeomEngine->prepareGeometry();
     }
 
-    QVector<QgsGeometry> geomList;
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
-    const CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), nullptr, mContext, true);
-    for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
-    {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
-            continue;
-        geomList.append(layerFeature.geometry());
-
-        if (feedback && feedback->isCanceled())
-        {
-            geomList.clear();
-            break;
-        }
-    }
-
-    if (geomList.isEmpty())
-    {
-        return;
-    }
-
-    std::unique_ptr<QgsGeometryEngine> geomEngine = CheckerUtils::createGeomEngine(nullptr, mContext->tolerance);
 
-    // Create union of geometry
-    QString errMsg;
-    std::unique_ptr<QgsAbstractGeometry> unionGeom(geomEngine->combine(geomList, &errMsg));
-    if (!unionGeom)
+    // Only the configured layers make up the coverage, gaps are its unclaimed faces. When only
+    // some features are checked, the polygons around them are added to close the coverage.
+    QSet<QString> coverageLayerIds;
+    for (auto it = featurePools.constBegin(); it != featurePools.constEnd(); ++it)
     {
-        messages.append(tr("Gap check: %1").arg(errMsg));
-        return;
+        if (layers.contains(it.value()->layerPtr().data()))
+            coverageLayerIds.insert(it.key());
     }
-
-    // Get envelope of union
-    geomEngine = CheckerUtils::createGeomEngine(unionGeom.get(), mContext->tolerance);
-    geomEngine->prepareGeometry();
-    std::unique_ptr<QgsAbstractGeometry> envelope(geomEngine->envelope(&errMsg));
-    if (!envelope)
+    const PolygonCoverage coverage(featurePools, PolygonCoverage::coverageFeatureIds(featurePools, featureIds, coverageLayerIds, mContext), mContext, feedback);
+    if (!coverage.isValid())
     {
-        messages.append(tr("Gap check: %1").arg(errMsg));
+        messages.append(tr("Gap check: %1").arg(coverage.errorMessage()));
         return;
     }
 
-    // Buffer envelope
-    geomEngine = CheckerUtils::createGeomEngine(envelope.get(), mContext->tolerance);
-    geomEngine->prepareGeometry();
-    QgsAbstractGeometry *bufEnvelope = geomEngine->buffer(2, 0, GEOSBUF_CAP_SQUARE, GEOSBUF_JOIN_MITRE, 4.); // #spellok  //#spellok
-    envelope.reset(bufEnvelope);
-
-    // Compute difference between envelope and union to obtain gap polygons
-    geomEngine = CheckerUtils::createGeomEngine(envelope.get(), mContext->tolerance);
-    geomEngine->prepareGeometry();
-    std::unique_ptr<QgsAbstractGeometry> diffGeom(geomEngine->difference(unionGeom.get(), &errMsg));
-    if (!diffGeom)
+    for (const PolygonCoverage::Face &gap : coverage.gaps())
     {
-        messages.append(tr("Gap check: %1").arg(errMsg));
-        return;
-    }
-
-    // For each gap polygon which does not lie on the boundary, get neighboring polygons and add error
-    QgsGeometryPartIterator parts = diffGeom->parts();
-    while (parts.hasNext())
-    {
-        const QgsAbstractGeometry *gapGeom = parts.next();
-        // Skip the gap between features and boundingbox
-        const double spacing = context()->tolerance;
-        if (gapGeom->boundingBox().snappedToGrid(spacing) == envelope->boundingBox().snappedToGrid(spacing))
-        {
-            continue;
-        }
+        if (feedback && feedback->isCanceled())
+            break;
+        const QgsAbstractGeometry *gapGeom = gap.geometry.constGet();
 
         // Skip gaps above threshold
         if (gapGeom->area() > mAreaMax || gapGeom->area() < mAreaMin)
@@ -153,6 +104,7 @@ void GapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, Q
 
         // Get neighboring polygons
         QMap<QString, QgsFeatureIds> neighboringIds;
+        bool checkedNeighbour = false;
         const CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds.keys(), gapAreaBBox, compatibleGeometryTypes(), mContext);
         for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
         {
@@ -161,10 +113,13 @@ void GapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, Q
             {
                 neighboringIds[layerFeature.layer()->id()].insert(layerFeature.feature().id());
                 gapAreaBBox.combineExtentWith(layerFeature.geometry().boundingBox());
+                checkedNeighbour = checkedNeighbour || featureIds.value(layerFeature.layerId()).contains(layerFeature.feature().id());
             }
         }
 
-        if (neighboringIds.isEmpty())
+        // Gaps between the polygons around the checked ones only are left to the runs checking them,
+        // the coverage may not be closed that far out
+        if (neighboringIds.isEmpty() || !checkedNeighbour)
         {
             continue;
         }
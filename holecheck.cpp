@@ -5,7 +5,7 @@
 #include "featurepool.h"
 #include "checkerror.h"
 
-void HoleCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void HoleCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
 
@@ -13,23 +13,28 @@ void HoleCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools,
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext);
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
-        const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
-        for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+        collectFeatureErrors(layerFeature, errors);
+    }
+}
+
+void HoleCheck::collectFeatureErrors(const CheckerUtils::LayerFeature &layerFeature, CheckErrorSink &errors) const
+{
+    const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
+    for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+    {
+        const QgsCurvePolygon *poly = dynamic_cast<const QgsCurvePolygon *>(CheckerUtils::getGeomPart(geom, iPart));
+        if (!poly)
+        {
+            continue;
+        }
+        // Rings after the first one are interiors
+        for (int iRing = 1, nRings = poly->ringCount(iPart); iRing < nRings; ++iRing)
         {
-            const QgsCurvePolygon *poly = dynamic_cast<const QgsCurvePolygon *>(CheckerUtils::getGeomPart(geom, iPart));
-            if (!poly)
-            {
-                continue;
-            }
-            // Rings after the first one are interiors
-            for (int iRing = 1, nRings = poly->ringCount(iPart); iRing < nRings; ++iRing)
-            {
 
-                QgsPoint pos = poly->interiorRing(iRing - 1)->centroid();
-                errors.append(new CheckError(this, layerFeature, pos, QgsVertexId(iPart, iRing)));
-            }
+            QgsPoint pos = poly->interiorRing(iRing - 1)->centroid();
+            errors.append(new CheckError(this, layerFeature, pos, QgsVertexId(iPart, iRing)));
         }
     }
 }
@@ -9,32 +9,36 @@ QList<QgsWkbTypes::GeometryType> IsValidCheck::compatibleGeometryTypes() const
     return factoryCompatibleGeometryTypes();
 }
 
-void IsValidCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void IsValidCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, context());
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
+        collectFeatureErrors(layerFeature, errors);
+    }
+}
 
-        QgsGeometry geometry = layerFeature.geometry();
-        QVector<QgsGeometry::Error> geoErrors;
+void IsValidCheck::collectFeatureErrors(const CheckerUtils::LayerFeature &layerFeature, CheckErrorSink &errors) const
+{
+    QgsGeometry geometry = layerFeature.geometry();
+    QVector<QgsGeometry::Error> geoErrors;
 
-        if(GEOS)
-            QgsGeometryValidator::validateGeometry(geometry, geoErrors, QgsGeometry::ValidatorGeos);
-        else
-            QgsGeometryValidator::validateGeometry(geometry, geoErrors, QgsGeometry::ValidatorQgisInternal);
+    if(GEOS)
+        QgsGeometryValidator::validateGeometry(geometry, geoErrors, QgsGeometry::ValidatorGeos);
+    else
+        QgsGeometryValidator::validateGeometry(geometry, geoErrors, QgsGeometry::ValidatorQgisInternal);
 
-        for ( const auto &error : qgis::as_const( geoErrors ) )
-        {
-            QgsGeometry errorGeometry;
-            if ( error.hasWhere() )
-                errorGeometry = QgsGeometry( qgis::make_unique<QgsPoint>( error.where() ) );
+    for ( const auto &error : qgis::as_const( geoErrors ) )
+    {
+        QgsGeometry errorGeometry;
+        if ( error.hasWhere() )
+            errorGeometry = QgsGeometry( qgis::make_unique<QgsPoint>( error.where() ) );
 
-            errors.append(new CheckError(this,layerFeature.layerId(),layerFeature.feature().id(),errorGeometry,errorGeometry.asPoint(),QgsVertexId(),error.what()));
-        }
+        errors.append(new CheckError(this,layerFeature.layerId(),layerFeature.feature().id(),errorGeometry,errorGeometry.asPoint(),QgsVertexId(),error.what()));
     }
 }
 
@@ -3,7 +3,7 @@
 #include "featurepool.h"
 #include "checkerror.h"
 
-void LengthCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void LengthCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
 
@@ -11,37 +11,42 @@ void LengthCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext);
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
-        double layerToMapUnits = scaleFactor(layerFeature.layer());
-        double minLength = mLengthMin / layerToMapUnits;
-        double maxLength = mLengthMax / layerToMapUnits;
+        collectFeatureErrors(layerFeature, errors);
+    }
+}
 
-        const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
-        for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+void LengthCheck::collectFeatureErrors(const CheckerUtils::LayerFeature &layerFeature, CheckErrorSink &errors) const
+{
+    double layerToMapUnits = scaleFactor(layerFeature.layer());
+    double minLength = mLengthMin / layerToMapUnits;
+    double maxLength = mLengthMax / layerToMapUnits;
+
+    const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
+    for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+    {
+        double dist = 0.00;
+        for (int iRing = 0, nRings = geom->ringCount(iPart); iRing < nRings; ++iRing)
         {
-            double dist = 0.00;
-            for (int iRing = 0, nRings = geom->ringCount(iPart); iRing < nRings; ++iRing)
+            bool isClosed = false;
+            int nVerts = CheckerUtils::polyLineSize(geom, iPart, iRing, &isClosed);
+            if (nVerts < 2)
             {
-                bool isClosed = false;
-                int nVerts = CheckerUtils::polyLineSize(geom, iPart, iRing, &isClosed);
-                if (nVerts < 2)
-                {
-                    continue;
-                }
-                for (int iVert = isClosed ? 0 : 1, jVert = isClosed ? nVerts - 1 : 0; iVert < nVerts; jVert = iVert++)
-                {
-                    QgsPoint pi = geom->vertexAt(QgsVertexId(iPart, iRing, iVert));
-                    QgsPoint pj = geom->vertexAt(QgsVertexId(iPart, iRing, jVert));
-                    dist += pi.distance(pj);
-                }
+                continue;
             }
-            if (dist >= minLength && dist <= maxLength)
+            for (int iVert = isClosed ? 0 : 1, jVert = isClosed ? nVerts - 1 : 0; iVert < nVerts; jVert = iVert++)
             {
-                const QgsAbstractGeometry *g = CheckerUtils::getGeomPart(geom, iPart);
-                errors.append(new CheckError(this, layerFeature, g->centroid(), QgsVertexId(iPart), dist * layerToMapUnits, CheckError::ValueLength));
+                QgsPoint pi = geom->vertexAt(QgsVertexId(iPart, iRing, iVert));
+                QgsPoint pj = geom->vertexAt(QgsVertexId(iPart, iRing, jVert));
+                dist += pi.distance(pj);
             }
         }
+        if (dist >= minLength && dist <= maxLength)
+        {
+            const QgsAbstractGeometry *g = CheckerUtils::getGeomPart(geom, iPart);
+            errors.append(new CheckError(this, layerFeature, g->centroid(), QgsVertexId(iPart), dist * layerToMapUnits, CheckError::ValueLength));
+        }
     }
 }
 
@@ -1,16 +1,17 @@
 ﻿#include "linecoveredbyboundarycheck.h"
 #include "checkerutils.h"
 #include "checkerror.h"
+#include "qgsfeedback.h"
 #include "checkerutils.h"
 
-void LineCoveredByBoundaryCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void LineCoveredByBoundaryCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(lineLayers.begin(), lineLayers.end(), layerFeatureA.layer()) == lineLayers.end())
+        if (!lineLayers.contains(layerFeatureA.layer()))
             continue;
 
         // TODO, use  QgsGeometryEngine
@@ -27,7 +28,10 @@ void LineCoveredByBoundaryCheck::collectErrors(const QMap<QString, FeaturePool *
             CheckerUtils::LayerFeatures layerFeaturesB(featurePools, featureIds.keys(), line.boundingBox(), {QgsWkbTypes::PolygonGeometry}, mContext);
             for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
             {
-                if (std::find(polygonLayers.begin(), polygonLayers.end(), layerFeatureB.layer()) == polygonLayers.end())
+                // Merging the buffers of many neighbours takes a while
+                if (feedback && feedback->isCanceled())
+                    return;
+                if (!polygonLayers.contains(layerFeatureB.layer()))
                     continue;
                 QVector<QgsGeometry> geomsB = layerFeatureB.geometry().asGeometryCollection();
 
@@ -90,7 +94,7 @@ void LineCoveredByBoundaryCheck::fixError(const QMap<QString, FeaturePool *> &fe
     CheckerUtils::LayerFeatures layerFeaturesB(featurePools, featureIds.keys(), line.boundingBox(), {QgsWkbTypes::PolygonGeometry}, mContext);
     for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
     {
-        if (std::find(polygonLayers.begin(), polygonLayers.end(), layerFeatureB.layer()) == polygonLayers.end())
+        if (!polygonLayers.contains(layerFeatureB.layer()))
             continue;
         QVector<QgsGeometry> geomsB = layerFeatureB.geometry().asGeometryCollection();
 
@@ -1,16 +1,17 @@
 ﻿#include "linecoveredbylinecheck.h"
 #include "checkerutils.h"
+#include "qgsfeedback.h"
 #include "checkerror.h"
 #include "checkerutils.h"
 
-void LineCoveredByLineCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void LineCoveredByLineCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(layersA.begin(), layersA.end(), layerFeatureA.layer()) == layersA.end())
+        if (!layersA.contains(layerFeatureA.layer()))
             continue;
 
         // TODO, use QgsGeometryEngine
@@ -27,7 +28,10 @@ void LineCoveredByLineCheck::collectErrors(const QMap<QString, FeaturePool *> &f
             CheckerUtils::LayerFeatures layerFeaturesB(featurePools, featureIds.keys(), line.boundingBox(), {QgsWkbTypes::LineGeometry}, mContext);
             for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
             {
-                if (std::find(layersB.begin(), layersB.end(), layerFeatureB.layer()) == layersB.end())
+                // Merging the buffers of many neighbours takes a while
+                if (feedback && feedback->isCanceled())
+                    return;
+                if (!layersB.contains(layerFeatureB.layer()))
                     continue;
                 QVector<QgsGeometry> geomsB = layerFeatureB.geometry().asGeometryCollection();
 
@@ -86,7 +90,7 @@ void LineCoveredByLineCheck::fixError(const QMap<QString, FeaturePool *> &featur
     CheckerUtils::LayerFeatures layerFeaturesB(featurePools, featureIds.keys(), line.boundingBox(), {QgsWkbTypes::PolygonGeometry}, mContext);
     for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
     {
-        if (std::find(layersB.begin(), layersB.end(), layerFeatureB.layer()) == layersB.end())
+        if (!layersB.contains(layerFeatureB.layer()))
             continue;
         QVector<QgsGeometry> geomsB = layerFeatureB.geometry().asGeometryCollection();
 
@@ -3,14 +3,14 @@
 #include "checkerror.h"
 #include "qgsgeometryutils.h"
 
-void LineEndOnPointCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void LineEndOnPointCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, context());
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(lineLayers.begin(), lineLayers.end(), layerFeature.layer()) == lineLayers.end())
+        if (!lineLayers.contains(layerFeature.layer()))
             continue;
         const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
         for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
@@ -31,7 +31,7 @@ void LineEndOnPointCheck::collectErrors(const QMap<QString, FeaturePool *> &feat
                     CheckerUtils::LayerFeatures checkFeatures(featurePools, featureIds.keys(), rect, {QgsWkbTypes::PointGeometry}, mContext);
                     for (const CheckerUtils::LayerFeature &checkFeature : checkFeatures)
                     {
-                        if (std::find(pointLayers.begin(), pointLayers.end(), checkFeature.layer()) == pointLayers.end())
+                        if (!pointLayers.contains(checkFeature.layer()))
                             continue;
                         const QgsAbstractGeometry *testGeom = checkFeature.geometry().constGet();
                         for (int jPart = 0, mParts = testGeom->partCount(); jPart < mParts; ++jPart)
@@ -86,7 +86,7 @@ void LineEndOnPointCheck::fixError(const QMap<QString, FeaturePool *> &featurePo
     CheckerUtils::LayerFeatures checkFeatures(featurePools, featureIds.keys(), rect, {QgsWkbTypes::PointGeometry}, mContext);
     for (const CheckerUtils::LayerFeature &checkFeature : checkFeatures)
     {
-        if (std::find(pointLayers.begin(), pointLayers.end(), checkFeature.layer()) == pointLayers.end())
+        if (!pointLayers.contains(checkFeature.layer()))
             continue;
         const QgsAbstractGeometry *testGeom = checkFeature.geometry().constGet();
         for (int jPart = 0, mParts = testGeom->partCount(); jPart < mParts; ++jPart)
@@ -3,14 +3,14 @@
 #include "checkerror.h"
 #include "checkerutils.h"
 
-void LineInPolygonCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void LineInPolygonCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(lineLayers.begin(), lineLayers.end(), layerFeatureA.layer()) == lineLayers.end())
+        if (!lineLayers.contains(layerFeatureA.layer()))
             continue;
 
         // TODO, use  QgsGeometryEngine
@@ -26,7 +26,7 @@ void LineInPolygonCheck::collectErrors(const QMap<QString, FeaturePool *> &featu
             CheckerUtils::LayerFeatures layerFeaturesB(featurePools, featureIds.keys(), line.boundingBox(), {QgsWkbTypes::PolygonGeometry}, mContext);
             for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
             {
-                if (std::find(polygonLayers.begin(), polygonLayers.end(), layerFeatureB.layer()) == polygonLayers.end())
+                if (!polygonLayers.contains(layerFeatureB.layer()))
                     continue;
                 QVector<QgsGeometry> geomsB = layerFeatureB.geometry().asGeometryCollection();
 
@@ -74,7 +74,7 @@ void LineInPolygonCheck::fixError(const QMap<QString, FeaturePool *> &featurePoo
     CheckerUtils::LayerFeatures layerFeaturesB(featurePools, featureIds.keys(), line.boundingBox(), {QgsWkbTypes::PolygonGeometry}, mContext);
     for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
     {
-        if (std::find(polygonLayers.begin(), polygonLayers.end(), layerFeatureB.layer()) == polygonLayers.end())
+        if (!polygonLayers.contains(layerFeatureB.layer()))
             continue;
         QVector<QgsGeometry> geomsB = layerFeatureB.geometry().asGeometryCollection();
         for (int jPart = 0; jPart < geomsB.size(); ++jPart)
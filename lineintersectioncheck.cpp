@@ -4,7 +4,7 @@
 #include "qgsvectorlayer.h"
 #include "checkerror.h"
 
-void LineIntersectionCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void LineIntersectionCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
 
@@ -13,7 +13,7 @@ void LineIntersectionCheck::collectErrors(const QMap<QString, FeaturePool *> &fe
     QList<QString> layerIds = featureIds.keys();
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeatureA.layer()) == layers.end())
+        if (!layers.contains(layerFeatureA.layer()))
             continue;
         // Ensure each pair of layers only gets compared once: remove the current layer from the layerIds, but add it to the layerList for layerFeaturesB
         layerIds.removeOne(layerFeatureA.layer()->id());
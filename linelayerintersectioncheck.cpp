@@ -4,7 +4,7 @@
 #include "qgsvectorlayer.h"
 #include "checkerror.h"
 
-void LineLayerIntersectionCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void LineLayerIntersectionCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
 
@@ -13,7 +13,7 @@ void LineLayerIntersectionCheck::collectErrors(const QMap<QString, FeaturePool *
     QList<QString> layerIds = featureIds.keys();
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(layersA.begin(), layersA.end(), layerFeatureA.layer()) == layersA.end())
+        if (!layersA.contains(layerFeatureA.layer()))
             continue;
         // Ensure each pair of layers only gets compared once: remove the current layer from the layerIds, but add it to the layerList for layerFeaturesB
         layerIds.removeOne(layerFeatureA.layer()->id());
@@ -32,7 +32,7 @@ void LineLayerIntersectionCheck::collectErrors(const QMap<QString, FeaturePool *
             CheckerUtils::LayerFeatures layerFeaturesB(featurePools, QList<QString>() << layerFeatureA.layer()->id() << layerIds, line->boundingBox(), {QgsWkbTypes::LineGeometry}, mContext);
             for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
             {
-                if (std::find(layersB.begin(), layersB.end(), layerFeatureB.layer()) == layersB.end())
+                if (!layersB.contains(layerFeatureB.layer()))
                     continue;
                 // > : only report intersections within same layer once
                 if (layerFeatureA.layer()->id() == layerFeatureB.layer()->id())
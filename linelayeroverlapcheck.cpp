@@ -16,14 +16,14 @@ LineLayerOverlapCheck::LineLayerOverlapCheck(const CheckContext *context, const
     layersB = var.value<QSet<QgsVectorLayer *>>();
 }
 
-void LineLayerOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void LineLayerOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     const CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
     QList<QString> layerIds = featureIds.keys();
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(layersA.begin(), layersA.end(), layerFeatureA.layer()) == layersA.end())
+        if (!layersA.contains(layerFeatureA.layer()))
             continue;
         if (feedback && feedback->isCanceled())
             break;
@@ -51,7 +51,7 @@ void LineLayerOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &fe
             const CheckerUtils::LayerFeatures layerFeaturesB(featurePools, layerIds, lineA->boundingBox(), compatibleGeometryTypes(), mContext);
             for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
             {
-                if (std::find(layersB.begin(), layersB.end(), layerFeatureB.layer()) == layersB.end())
+                if (!layersB.contains(layerFeatureB.layer()))
                     continue;
                 if (feedback && feedback->isCanceled())
                     break;
@@ -0,0 +1,209 @@
+#include "linenetwork.h"
+#include "checkcontext.h"
+#include "checkerutils.h"
+#include "featurepool.h"
+#include "qgsgeometryutils.h"
+#include "qgslinestring.h"
+#include "qgsspatialindex.h"
+
+#include <QMutexLocker>
+#include <cmath>
+#include <limits>
+
+LineNetwork::LineNetwork( FeaturePool *featurePool, const CheckContext *context )
+  : mTolerance( context->tolerance )
+{
+  QMap<QString, FeaturePool *> featurePools;
+  featurePools.insert( featurePool->layerId(), featurePool );
+  QMap<QString, QgsFeatureIds> featureIds;
+  featureIds.insert( featurePool->layerId(), featurePool->allFeatureIds() );
+
+  // Vertices of the edges, to node line ends onto segments once all nodes are known
+  QVector<QgsPolylineXY> edgePoints;
+  QgsSpatialIndex edgeIndex;
+
+  const CheckerUtils::LayerFeatures layerFeatures( featurePools, featureIds, {QgsWkbTypes::LineGeometry}, nullptr, context, true );
+  for ( const CheckerUtils::LayerFeature &layerFeature : layerFeatures )
+  {
+    const QgsGeometry geometry = layerFeature.geometry();
+    const QgsAbstractGeometry *geom = geometry.constGet();
+    QVector<int> &featureEdges = mFeatureEdges[layerFeature.feature().id()];
+    for ( int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart )
+    {
+      const QgsLineString *line = dynamic_cast<const QgsLineString *>( CheckerUtils::getGeomPart( geom, iPart ) );
+      const int nVerts = line ? line->numPoints() : 0;
+      if ( nVerts > 0 )
+      {
+        const QgsPointXY start( line->xAt( 0 ), line->yAt( 0 ) );
+        const QgsPointXY end( line->xAt( nVerts - 1 ), line->yAt( nVerts - 1 ) );
+        mEndGrid[cell( start )].append( start );
+        mEndGrid[cell( end )].append( end );
+      }
+      if ( nVerts < 2 )
+      {
+        featureEdges.append( -1 );
+        continue;
+      }
+
+      QgsPolylineXY points;
+      points.reserve( nVerts );
+      for ( int iVert = 0; iVert < nVerts; ++iVert )
+      {
+        points.append( QgsPointXY( line->xAt( iVert ), line->yAt( iVert ) ) );
+      }
+
+      const int edgeNr = mEdges.size();
+      Edge edge;
+      edge.featureId = layerFeature.feature().id();
+      edge.part = iPart;
+      edge.vertexCount = nVerts;
+      edge.startNode = snap( points.first() );
+      edge.endNode = snap( points.last() );
+      for ( int iVert = 1; iVert < nVerts - 1; ++iVert )
+      {
+        ++mNodes[snap( points.at( iVert ) )].vertices;
+        mVertexGrid[cell( points.at( iVert ) )].append( points.at( iVert ) );
+      }
+      ++mNodes[edge.startNode].ends;
+      ++mNodes[edge.endNode].ends;
+      mNodes[edge.startNode].edges.append( edgeNr );
+      mNodes[edge.endNode].edges.append( edgeNr );
+
+      mEdges.append( edge );
+      featureEdges.append( edgeNr );
+      edgeIndex.addFeature( edgeNr, line->boundingBox() );
+      edgePoints.append( points );
+    }
+  }
+
+  const double sqrTolerance = mTolerance * mTolerance;
+  for ( Node &node : mNodes )
+  {
+    if ( node.ends == 0 )
+    {
+      continue;
+    }
+    const QgsRectangle rect( node.point.x() - mTolerance, node.point.y() - mTolerance,
+                             node.point.x() + mTolerance, node.point.y() + mTolerance );
+    const QList<QgsFeatureId> candidates = edgeIndex.intersects( rect );
+    for ( QgsFeatureId candidate : candidates )
+    {
+      const QgsPolylineXY &points = edgePoints.at( static_cast<int>( candidate ) );
+      for ( int i = 0, n = points.size() - 1; i < n; ++i )
+      {
+        // Ends close to a vertex were snapped to its node already
+        if ( node.point.sqrDist( points.at( i ) ) < sqrTolerance || node.point.sqrDist( points.at( i + 1 ) ) < sqrTolerance )
+        {
+          continue;
+        }
+        double minX, minY;
+        const double sqrDist = QgsGeometryUtils::sqrDistToLine( node.point.x(), node.point.y(),
+                               points.at( i ).x(), points.at( i ).y(), points.at( i + 1 ).x(), points.at( i + 1 ).y(),
+                               minX, minY, 4 * std::numeric_limits<double>::epsilon() );
+        if ( sqrDist < sqrTolerance )
+        {
+          ++node.crossings;
+        }
+      }
+    }
+  }
+}
+
+int LineNetwork::nodeAt( const QgsPointXY &point ) const
+{
+  const Cell center = cell( point );
+  const double sqrTolerance = mTolerance * mTolerance;
+  int nearest = -1;
+  double nearestSqrDist = sqrTolerance;
+  for ( qint64 x = center.first - 1; x <= center.first + 1; ++x )
+  {
+    for ( qint64 y = center.second - 1; y <= center.second + 1; ++y )
+    {
+      const QVector<int> nodes = mGrid.value( Cell( x, y ) );
+      for ( int index : nodes )
+      {
+        const double sqrDist = mNodes.at( index ).point.sqrDist( point );
+        if ( sqrDist < nearestSqrDist )
+        {
+          nearest = index;
+          nearestSqrDist = sqrDist;
+        }
+      }
+    }
+  }
+  return nearest;
+}
+
+bool LineNetwork::hasPointNear( const PointGrid &grid, const QgsPointXY &point ) const
+{
+  // The cells are as large as the tolerance, closer points are in the neighbouring cells
+  const Cell center = cell( point );
+  const double sqrTolerance = mTolerance * mTolerance;
+  for ( qint64 x = center.first - 1; x <= center.first + 1; ++x )
+  {
+    for ( qint64 y = center.second - 1; y <= center.second + 1; ++y )
+    {
+      auto it = grid.constFind( Cell( x, y ) );
+      if ( it == grid.constEnd() )
+      {
+        continue;
+      }
+      for ( const QgsPointXY &other : it.value() )
+      {
+        if ( other.sqrDist( point ) < sqrTolerance )
+        {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+LineNetwork::Cell LineNetwork::cell( const QgsPointXY &point ) const
+{
+  return Cell( static_cast<qint64>( std::floor( point.x() / mTolerance ) ), static_cast<qint64>( std::floor( point.y() / mTolerance ) ) );
+}
+
+int LineNetwork::snap( const QgsPointXY &point )
+{
+  int index = nodeAt( point );
+  if ( index < 0 )
+  {
+    index = mNodes.size();
+    Node node;
+    node.point = point;
+    mNodes.append( node );
+    mGrid[cell( point )].append( index );
+  }
+  return index;
+}
+
+
+std::shared_ptr<const LineNetwork> LineNetworkCache::network( FeaturePool *featurePool, const CheckContext *context )
+{
+  std::shared_ptr<Entry> entry;
+  {
+    QMutexLocker locker( &mMutex );
+    std::shared_ptr<Entry> &slot = mEntries[featurePool->layerId()];
+    if ( !slot )
+    {
+      slot = std::make_shared<Entry>();
+    }
+    entry = slot;
+  }
+
+  // Only this layer waits while its network is built
+  QMutexLocker locker( &entry->mutex );
+  if ( !entry->network )
+  {
+    entry->network = std::make_shared<const LineNetwork>( featurePool, context );
+  }
+  return entry->network;
+}
+
+void LineNetworkCache::clear()
+{
+  QMutexLocker locker( &mMutex );
+  mEntries.clear();
+}
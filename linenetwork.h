@@ -0,0 +1,158 @@
+#ifndef LINENETWORK_H
+#define LINENETWORK_H
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QVector>
+#include <memory>
+
+#include "qgsfeatureid.h"
+#include "qgspointxy.h"
+
+class CheckContext;
+class FeaturePool;
+
+/**
+ * \ingroup analysis
+ * The noded graph of the lines of a layer.
+ *
+ * Line vertices closer than the tolerance of the context are snapped to one node.
+ * A line end which lies on a segment of a line, its own line included, is noded
+ * onto that segment. Crossings of segments without a common vertex are not noded,
+ * none of the checks asks for them.
+ *
+ * Each line part is an edge between the nodes of its ends. Edges are not split at
+ * the nodes of their inner vertices, these nodes count the lines passing through.
+ *
+ * All coordinates are in the map crs. Once built, a network is read only and can
+ * be shared by the check threads.
+ */
+class LineNetwork
+{
+  public:
+
+    /**
+     * A node of the network.
+     */
+    struct Node
+    {
+      QgsPointXY point;
+      //! Number of line ends snapped to the node
+      int ends = 0;
+      //! Number of inner line vertices snapped to the node
+      int vertices = 0;
+      //! Number of segments passing through the node between two vertices
+      int crossings = 0;
+      //! Edges starting or ending at the node, a closed edge is listed twice
+      QVector<int> edges;
+
+      /**
+       * Returns the number of line branches meeting at the node.
+       * A line passing through the node counts twice.
+       */
+      int degree() const { return ends + 2 * ( vertices + crossings ); }
+    };
+
+    /**
+     * An edge of the network, one part of a line feature.
+     */
+    struct Edge
+    {
+      QgsFeatureId featureId = FID_NULL;
+      int part = -1;
+      int vertexCount = 0;
+      int startNode = -1;
+      int endNode = -1;
+    };
+
+    /**
+     * Builds the network of all line features in \a featurePool.
+     */
+    LineNetwork( FeaturePool *featurePool, const CheckContext *context );
+
+    int nodeCount() const { return mNodes.size(); }
+    const Node &node( int index ) const { return mNodes.at( index ); }
+
+    int edgeCount() const { return mEdges.size(); }
+    const Edge &edge( int index ) const { return mEdges.at( index ); }
+
+    /**
+     * Returns the edges of the parts of the feature \a fid in part order.
+     * Parts with less than two vertices have no edge and are listed as -1.
+     */
+    QVector<int> featureEdges( QgsFeatureId fid ) const { return mFeatureEdges.value( fid ); }
+
+    /**
+     * Returns the nearest node closer than the tolerance to \a point, or -1.
+     * Nodes are placed at the first vertex snapped to them, points near a node may
+     * still be farther than the tolerance from its vertices.
+     */
+    int nodeAt( const QgsPointXY &point ) const;
+
+    /**
+     * Returns TRUE if a line end lies closer than the tolerance to \a point.
+     * The actual end coordinates are compared, not the nodes they were snapped to.
+     */
+    bool hasEndNear( const QgsPointXY &point ) const { return hasPointNear( mEndGrid, point ); }
+
+    /**
+     * Returns TRUE if an inner line vertex lies closer than the tolerance to \a point.
+     * The actual vertex coordinates are compared, not the nodes they were snapped to.
+     */
+    bool hasVertexNear( const QgsPointXY &point ) const { return hasPointNear( mVertexGrid, point ); }
+
+  private:
+    typedef QPair<qint64, qint64> Cell;
+
+    typedef QHash<Cell, QVector<QgsPointXY> > PointGrid;
+
+    Cell cell( const QgsPointXY &point ) const;
+    int snap( const QgsPointXY &point );
+    bool hasPointNear( const PointGrid &grid, const QgsPointXY &point ) const;
+
+    double mTolerance;
+    QVector<Node> mNodes;
+    QVector<Edge> mEdges;
+    QHash<QgsFeatureId, QVector<int> > mFeatureEdges;
+    //! Nodes by grid cell, the cells are as large as the tolerance
+    QHash<Cell, QVector<int> > mGrid;
+    //! Line ends and inner vertices by grid cell
+    PointGrid mEndGrid;
+    PointGrid mVertexGrid;
+};
+
+/**
+ * \ingroup analysis
+ * The line networks of a checker run, each built when a check first asks for it.
+ *
+ * All methods are thread safe. A network stays valid for the check holding it
+ * even if the cache is cleared in between.
+ */
+class LineNetworkCache
+{
+  public:
+
+    /**
+     * Returns the network of the lines in \a featurePool, building it if needed.
+     * Checks asking for a network which is being built wait for it.
+     */
+    std::shared_ptr<const LineNetwork> network( FeaturePool *featurePool, const CheckContext *context );
+
+    /**
+     * Drops all networks. To be called whenever the features in the pools change.
+     */
+    void clear();
+
+  private:
+    struct Entry
+    {
+      QMutex mutex;
+      std::shared_ptr<const LineNetwork> network;
+    };
+
+    QMutex mMutex;
+    QHash<QString, std::shared_ptr<Entry> > mEntries;
+};
+
+#endif // LINENETWORK_H
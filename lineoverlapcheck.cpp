@@ -12,7 +12,7 @@ LineOverlapCheck::LineOverlapCheck(const CheckContext *context, const QVariantMa
     layers = var.value<QSet<QgsVectorLayer *>>();
 }
 
-void LineOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void LineOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
 
@@ -21,7 +21,7 @@ void LineOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &feature
     QList<QString> layerIds = featureIds.keys();
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeatureA.layer()) == layers.end())
+        if (!layers.contains(layerFeatureA.layer()))
             continue;
         if (feedback && feedback->isCanceled())
             break;
@@ -48,7 +48,7 @@ void LineSelfIntersectionCheckError::update(const SingleCheckError *other)
     mIntersection.point = err->mIntersection.point;
 }
 
-void LineSelfIntersectionCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void LineSelfIntersectionCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
 
@@ -56,7 +56,7 @@ void LineSelfIntersectionCheck::collectErrors(const QMap<QString, FeaturePool *>
     CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeaturesA)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
         QgsGeometry geometry = layerFeature.geometry();
         const QgsAbstractGeometry *geom = geometry.constGet();
@@ -32,7 +32,7 @@ bool LineSelfOverlapError::handleChanges(const Check::Changes &changes)
     return true;
 }
 
-void LineSelfOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void LineSelfOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
@@ -41,7 +41,7 @@ void LineSelfOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &fea
 
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
         QVector<LineSegment> totalLines;
         const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
@@ -0,0 +1,89 @@
+#ifndef LOCKWAITCOUNTER_H
+#define LOCKWAITCOUNTER_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <atomic>
+
+/**
+ * \ingroup analysis
+ * Locks a mutex or read-write lock and adds up the time threads waited for it.
+ *
+ * The clock is only read when the lock is taken by another thread, so an
+ * uncontended lock costs one extra tryLock(). Thread safe.
+ */
+class LockWaitCounter
+{
+  public:
+
+    /**
+     * Locks \a mutex, counting the wait if it is held by another thread.
+     */
+    void lock( QMutex &mutex )
+    {
+      if ( mutex.tryLock() )
+        return;
+      QElapsedTimer timer;
+      timer.start();
+      mutex.lock();
+      add( timer.nsecsElapsed() );
+    }
+
+    /**
+     * Locks \a lock for reading, counting the wait if a writer holds it.
+     */
+    void lockForRead( QReadWriteLock &lock )
+    {
+      if ( lock.tryLockForRead() )
+        return;
+      QElapsedTimer timer;
+      timer.start();
+      lock.lockForRead();
+      add( timer.nsecsElapsed() );
+    }
+
+    /**
+     * Locks \a lock for writing, counting the wait if it is held by another thread.
+     */
+    void lockForWrite( QReadWriteLock &lock )
+    {
+      if ( lock.tryLockForWrite() )
+        return;
+      QElapsedTimer timer;
+      timer.start();
+      lock.lockForWrite();
+      add( timer.nsecsElapsed() );
+    }
+
+    /**
+     * Returns the time in nanoseconds threads waited for the lock.
+     */
+    qint64 waitTime() const { return mWaitTime.load( std::memory_order_relaxed ); }
+
+    /**
+     * Returns how often the lock was held by another thread.
+     */
+    qint64 contentionCount() const { return mContentionCount.load( std::memory_order_relaxed ); }
+
+    /**
+     * Sets the wait time and the contention count back to 0.
+     */
+    void reset()
+    {
+      mWaitTime.store( 0, std::memory_order_relaxed );
+      mContentionCount.store( 0, std::memory_order_relaxed );
+    }
+
+  private:
+    void add( qint64 nsecs )
+    {
+      mWaitTime.fetch_add( nsecs, std::memory_order_relaxed );
+      mContentionCount.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    std::atomic<qint64> mWaitTime{ 0 };
+    std::atomic<qint64> mContentionCount{ 0 };
+};
+
+#endif // LOCKWAITCOUNTER_H
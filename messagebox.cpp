@@ -1,6 +1,7 @@
 ﻿#include "messagebox.h"
 #include "ui_messagebox.h"
 #include <QPushButton>
+#include <qgssettings.h>
 
 MessageBox::MessageBox(QWidget *parent) :
     QDialog(parent),
@@ -12,6 +13,12 @@ MessageBox::MessageBox(QWidget *parent) :
 
     connect(ui->btnCancel, &QPushButton::clicked, this, [&](){ this->hide(); });
     connect(ui->btnOK, &QPushButton::clicked, this, &MessageBox::run);
+
+    // Profiling costs a little time per feature, it stays off until turned on
+    ui->checkBoxProfile->setChecked(QgsSettings().value(QStringLiteral("/TopologyChecker/profile"), false).toBool());
+    connect(ui->checkBoxProfile, &QCheckBox::toggled, this, [](bool checked) {
+        QgsSettings().setValue(QStringLiteral("/TopologyChecker/profile"), checked);
+    });
 }
 
 MessageBox::~MessageBox()
@@ -28,3 +35,13 @@ double MessageBox::tolerance()
 {
     return ui->spinBoxTolerance->value();
 }
+
+bool MessageBox::incremental()
+{
+    return ui->checkBoxIncremental->isChecked();
+}
+
+bool MessageBox::profiling()
+{
+    return ui->checkBoxProfile->isChecked();
+}
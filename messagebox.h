@@ -17,6 +17,8 @@ public:
 
     bool selectedOnly();
     double tolerance();
+    bool incremental();
+    bool profiling();
 
 signals:
     void run();
@@ -23,14 +23,14 @@ QString PointDuplicateCheckError::duplicatesString(const QMap<QString, FeaturePo
     return str.join(QLatin1String("; "));
 }
 
-void PointDuplicateCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void PointDuplicateCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
     QList<QString> layerIds = featureIds.keys();
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(pointLayers.begin(), pointLayers.end(), layerFeatureA.layer()) == pointLayers.end())
+        if (!pointLayers.contains(layerFeatureA.layer()))
             continue;
         // Ensure each pair of layers only gets compared once: remove the current layer from the layerIds, but add it to the layerList for layerFeaturesB
         layerIds.removeOne(layerFeatureA.layer()->id());
@@ -49,7 +49,7 @@ void PointDuplicateCheck::collectErrors(const QMap<QString, FeaturePool *> &feat
         CheckerUtils::LayerFeatures layerFeaturesB(featurePools, QList<QString>() << layerFeatureA.layer()->id() << layerIds, bboxA, {geomType}, mContext);
         for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
         {
-            if (std::find(pointLayers.begin(), pointLayers.end(), layerFeatureB.layer()) == pointLayers.end())
+            if (!pointLayers.contains(layerFeatureB.layer()))
                 continue;
             // > : only report overlaps within same layer once
             if (layerFeatureA.layer()->id() == layerFeatureB.layer()->id() && layerFeatureB.feature().id() >= layerFeatureA.feature().id())
@@ -13,10 +13,10 @@ public:
                              const QgsPointXY &errorLocation,
                              const QMap<QString, FeaturePool *> &featurePools,
                              const QMap<QString, QList<QgsFeatureId>> &duplicates)
-        : CheckError(check, layerFeature, errorLocation, QgsVertexId(), duplicatesString(featurePools, duplicates)), mDuplicates(duplicates)
+        : CheckError(check, layerFeature, errorLocation, QgsVertexId(), duplicatesString(featurePools, duplicates)), mDuplicates(errorTable()->compactFeatures(duplicates))
     {
     }
-    QMap<QString, QList<QgsFeatureId>> duplicates() const { return mDuplicates; }
+    QMap<QString, QList<QgsFeatureId>> duplicates() const { return errorTable()->expandFeatures(mDuplicates); }
 
     bool isEqual(CheckError *other) const override
     {
@@ -24,11 +24,11 @@ public:
                other->layerId() == layerId() &&
                other->featureId() == featureId() &&
                // static_cast: since other->checker() == checker is only true if the types are actually the same
-               static_cast<PointDuplicateCheckError *>(other)->duplicates() == duplicates();
+               static_cast<PointDuplicateCheckError *>(other)->mDuplicates == mDuplicates;
     }
 
 private:
-    QMap<QString, QList<QgsFeatureId>> mDuplicates;
+    CheckErrorTable::FeatureList mDuplicates;
 
     static QString duplicatesString(const QMap<QString, FeaturePool *> &featurePools, const QMap<QString, QList<QgsFeatureId>> &duplicates);
 };
@@ -43,7 +43,7 @@ public:
         QVariant var = configuration.value("layersA");
         pointLayers = var.value<QSet<QgsVectorLayer *>>();
     }
-    void collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids = LayerFeatureIds()) const override;
+    void collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids = LayerFeatureIds()) const override;
     void fixError(const QMap<QString, FeaturePool *> &featurePools, CheckError *error, int method, const QMap<QString, int> &mergeAttributeIndices, Changes &changes) const override;
 
     QList<QgsWkbTypes::GeometryType> compatibleGeometryTypes() const override { return factoryCompatibleGeometryTypes(); }
@@ -3,13 +3,13 @@
 #include "qgsgeometryengine.h"
 #include "checkerror.h"
 
-void PointInPolygonCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void PointInPolygonCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(pointLayers.begin(), pointLayers.end(), layerFeature.layer()) == pointLayers.end())
+        if (!pointLayers.contains(layerFeature.layer()))
             continue;
         const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
         for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
@@ -29,7 +29,7 @@ void PointInPolygonCheck::collectErrors(const QMap<QString, FeaturePool *> &feat
             CheckerUtils::LayerFeatures checkFeatures(featurePools, featureIds.keys(), rect, {QgsWkbTypes::PolygonGeometry}, mContext);
             for (const CheckerUtils::LayerFeature &checkFeature : checkFeatures)
             {
-                if (std::find(polygonLayers.begin(), polygonLayers.end(), checkFeature.layer()) == polygonLayers.end())
+                if (!polygonLayers.contains(checkFeature.layer()))
                     continue;
                 ++nTested;
                 const QgsAbstractGeometry *testGeom = checkFeature.geometry().constGet();
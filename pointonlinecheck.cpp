@@ -6,7 +6,7 @@
 #include "featurepool.h"
 #include "checkerror.h"
 
-void PointOnLineCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void PointOnLineCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
 
@@ -14,7 +14,7 @@ void PointOnLineCheck::collectErrors(const QMap<QString, FeaturePool *> &feature
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(pointLayers.begin(), pointLayers.end(), layerFeature.layer()) == pointLayers.end())
+        if (!pointLayers.contains(layerFeature.layer()))
             continue;
         const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
         for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
@@ -32,7 +32,7 @@ void PointOnLineCheck::collectErrors(const QMap<QString, FeaturePool *> &feature
             CheckerUtils::LayerFeatures checkFeatures(featurePools, featureIds.keys(), rect, {QgsWkbTypes::LineGeometry}, mContext);
             for (const CheckerUtils::LayerFeature &checkFeature : checkFeatures)
             {
-                if (std::find(lineLayers.begin(), lineLayers.end(), checkFeature.layer()) == lineLayers.end())
+                if (!lineLayers.contains(checkFeature.layer()))
                     continue;
 
                 const QgsAbstractGeometry *testGeom = checkFeature.geometry().constGet();
@@ -92,7 +92,7 @@ void PointOnLineCheck::fixError(const QMap<QString, FeaturePool *> &featurePools
     CheckerUtils::LayerFeatures checkFeatures(featurePools, featureIds.keys(), rect, {QgsWkbTypes::LineGeometry}, mContext);
     for (const CheckerUtils::LayerFeature &checkFeature : checkFeatures)
     {
-        if (std::find(lineLayers.begin(), lineLayers.end(), checkFeature.layer()) == lineLayers.end())
+        if (!lineLayers.contains(checkFeature.layer()))
             continue;
         const QgsAbstractGeometry *testGeom = checkFeature.geometry().constGet();
         for (int jPart = 0, mParts = testGeom->partCount(); jPart < mParts; ++jPart)
@@ -133,7 +133,7 @@ void PointOnLineCheck::fixError(const QMap<QString, FeaturePool *> &featurePools
         bool init = true;
         for (const CheckerUtils::LayerFeature &checkFeature : checkFeatures)
         {
-            if (std::find(lineLayers.begin(), lineLayers.end(), checkFeature.layer()) == lineLayers.end())
+            if (!lineLayers.contains(checkFeature.layer()))
                 continue;
             const QgsAbstractGeometry *testGeom = checkFeature.geometry().constGet();
             for (int jPart = 0, mParts = testGeom->partCount(); jPart < mParts; ++jPart)
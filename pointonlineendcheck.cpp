@@ -1,18 +1,28 @@
 ﻿#include "pointonlineendcheck.h"
 #include "checkcontext.h"
+#include "linenetwork.h"
 #include "qgslinestring.h"
 #include "featurepool.h"
 #include "checkerror.h"
 
-void PointOnLineEndCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void PointOnLineEndCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
 
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
+
+    // The line layers are looked up in their networks, which are shared with the other line checks
+    QList<std::shared_ptr<const LineNetwork>> networks;
+    for (FeaturePool *featurePool : featurePools)
+    {
+        if (featurePool->geometryType() == QgsWkbTypes::LineGeometry && lineLayers.contains(featurePool->layerPtr().data()))
+            networks.append(mContext->lineNetworks()->network(featurePool, mContext));
+    }
+
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(pointLayers.begin(), pointLayers.end(), layerFeature.layer()) == pointLayers.end())
+        if (!pointLayers.contains(layerFeature.layer()))
             continue;
         const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
         for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
@@ -23,32 +33,13 @@ void PointOnLineEndCheck::collectErrors(const QMap<QString, FeaturePool *> &feat
                 // Should not happen
                 continue;
             }
-            // Check that point lies on a line
+            // Check that point lies on a line end
             bool touches = false;
-            QgsRectangle rect(point->x() - mContext->tolerance, point->y() - mContext->tolerance,
-                              point->x() + mContext->tolerance, point->y() + mContext->tolerance);
-            CheckerUtils::LayerFeatures checkFeatures(featurePools, featureIds.keys(), rect, {QgsWkbTypes::LineGeometry}, mContext);
-            for (const CheckerUtils::LayerFeature &checkFeature : checkFeatures)
+            for (const std::shared_ptr<const LineNetwork> &network : networks)
             {
-                if (std::find(lineLayers.begin(), lineLayers.end(), checkFeature.layer()) == lineLayers.end())
-                    continue;
-                const QgsAbstractGeometry *testGeom = checkFeature.geometry().constGet();
-
-                for (int jPart = 0, mParts = testGeom->partCount(); jPart < mParts; ++jPart)
-                {
-                    const QgsLineString *testLine = dynamic_cast<const QgsLineString *>(CheckerUtils::getGeomPart(testGeom, jPart));
-                    if (!testLine || testLine->numPoints() == 0)
-                    {
-                        continue;
-                    }
-                    if (point->distance(testLine->startPoint()) < mContext->tolerance || point->distance(testLine->endPoint()) < mContext->tolerance)
-                    {
-                        touches = true;
-                        break;
-                    }
-                }
-                if (touches)
+                if (network->hasEndNear(*point))
                 {
+                    touches = true;
                     break;
                 }
             }
@@ -90,7 +81,7 @@ void PointOnLineEndCheck::fixError(const QMap<QString, FeaturePool *> &featurePo
     CheckerUtils::LayerFeatures checkFeatures(featurePools, featureIds.keys(), rect, {QgsWkbTypes::LineGeometry}, mContext);
     for (const CheckerUtils::LayerFeature &checkFeature : checkFeatures)
     {
-        if (std::find(lineLayers.begin(), lineLayers.end(), checkFeature.layer()) == lineLayers.end())
+        if (!lineLayers.contains(checkFeature.layer()))
             continue;
         const QgsAbstractGeometry *testGeom = checkFeature.geometry().constGet();
 
@@ -132,7 +123,7 @@ void PointOnLineEndCheck::fixError(const QMap<QString, FeaturePool *> &featurePo
         bool init = true;
         for (const CheckerUtils::LayerFeature &checkFeature : checkFeatures)
         {
-            if (std::find(lineLayers.begin(), lineLayers.end(), checkFeature.layer()) == lineLayers.end())
+            if (!lineLayers.contains(checkFeature.layer()))
                 continue;
             const QgsAbstractGeometry *testGeom = checkFeature.geometry().constGet();
 
@@ -1,18 +1,28 @@
 ﻿#include "pointonlinenodecheck.h"
 #include "checkcontext.h"
+#include "linenetwork.h"
 #include "qgslinestring.h"
 #include "featurepool.h"
 #include "checkerror.h"
 
-void PointOnLineNodeCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void PointOnLineNodeCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
 
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
+
+    // The line layers are looked up in their networks, which are shared with the other line checks
+    QList<std::shared_ptr<const LineNetwork>> networks;
+    for (FeaturePool *featurePool : featurePools)
+    {
+        if (featurePool->geometryType() == QgsWkbTypes::LineGeometry && lineLayers.contains(featurePool->layerPtr().data()))
+            networks.append(mContext->lineNetworks()->network(featurePool, mContext));
+    }
+
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(pointLayers.begin(), pointLayers.end(), layerFeature.layer()) == pointLayers.end())
+        if (!pointLayers.contains(layerFeature.layer()))
             continue;
         const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
         for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
@@ -25,34 +35,11 @@ void PointOnLineNodeCheck::collectErrors(const QMap<QString, FeaturePool *> &fea
             }
             // Check that point lies on a line node
             bool touches = false;
-            QgsRectangle rect(point->x() - mContext->tolerance, point->y() - mContext->tolerance,
-                              point->x() + mContext->tolerance, point->y() + mContext->tolerance);
-            CheckerUtils::LayerFeatures checkFeatures(featurePools, featureIds.keys(), rect, {QgsWkbTypes::LineGeometry}, mContext);
-            for (const CheckerUtils::LayerFeature &checkFeature : checkFeatures)
+            for (const std::shared_ptr<const LineNetwork> &network : networks)
             {
-                if (std::find(lineLayers.begin(), lineLayers.end(), checkFeature.layer()) == lineLayers.end())
-                    continue;
-                const QgsAbstractGeometry *testGeom = checkFeature.geometry().constGet();
-                for (int jPart = 0, mParts = testGeom->partCount(); jPart < mParts; ++jPart)
-                {
-                    const QgsLineString *testLine = dynamic_cast<const QgsLineString *>(CheckerUtils::getGeomPart(testGeom, jPart));
-                    if (!testLine || testLine->numPoints() <= 2)
-                    {
-                        continue;
-                    }
-                    for (int i = 1; i < testLine->numPoints() - 1; ++i)
-                    {
-                        if (point->distance(testLine->pointN(i)) < mContext->tolerance)
-                        {
-                            touches = true;
-                            break;
-                        }
-                    }
-                    if (touches)
-                        break;
-                }
-                if (touches)
+                if (network->hasVertexNear(*point))
                 {
+                    touches = true;
                     break;
                 }
             }
@@ -95,7 +82,7 @@ void PointOnLineNodeCheck::fixError(const QMap<QString, FeaturePool *> &featureP
     CheckerUtils::LayerFeatures checkFeatures(featurePools, featureIds.keys(), rect, {QgsWkbTypes::LineGeometry}, mContext);
     for (const CheckerUtils::LayerFeature &checkFeature : checkFeatures)
     {
-        if (std::find(lineLayers.begin(), lineLayers.end(), checkFeature.layer()) == lineLayers.end())
+        if (!lineLayers.contains(checkFeature.layer()))
             continue;
         const QgsAbstractGeometry *testGeom = checkFeature.geometry().constGet();
         for (int jPart = 0, mParts = testGeom->partCount(); jPart < mParts; ++jPart)
@@ -140,7 +127,7 @@ void PointOnLineNodeCheck::fixError(const QMap<QString, FeaturePool *> &featureP
         bool init = true;
         for (const CheckerUtils::LayerFeature &checkFeature : checkFeatures)
         {
-            if (std::find(lineLayers.begin(), lineLayers.end(), checkFeature.layer()) == lineLayers.end())
+            if (!lineLayers.contains(checkFeature.layer()))
                 continue;
             const QgsAbstractGeometry *testGeom = checkFeature.geometry().constGet();
             for (int jPart = 0, mParts = testGeom->partCount(); jPart < mParts; ++jPart)
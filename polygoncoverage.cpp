@@ -0,0 +1,258 @@
+#include "polygoncoverage.h"
+#include "checkcontext.h"
+#include "checkerutils.h"
+#include "featurepool.h"
+#include "qgscoordinatetransform.h"
+#include "qgsfeedback.h"
+#include "qgsgeometryengine.h"
+#include "qgslinestring.h"
+#include "qgsmultilinestring.h"
+
+#include <QHash>
+#include <cmath>
+
+namespace
+{
+  typedef QPair<qint64, qint64> SnappedPoint;
+  typedef QPair<SnappedPoint, SnappedPoint> SegmentKey;
+
+  struct SegmentEntry
+  {
+    //! Number of rings running along the segment from the first to the second point of its key
+    int forward = 0;
+    //! Number of rings running along the segment the other way
+    int backward = 0;
+  };
+
+  SnappedPoint snapped( const QgsPointXY &point, double tolerance )
+  {
+    return SnappedPoint( std::llround( point.x() / tolerance ), std::llround( point.y() / tolerance ) );
+  }
+
+  QgsPointXY snappedPoint( const SnappedPoint &point, double tolerance )
+  {
+    return QgsPointXY( point.first * tolerance, point.second * tolerance );
+  }
+
+  bool claimedBy( const QMap<QString, QgsFeatureIds> &featureIds, const CheckerUtils::LayerFeature &layerFeature )
+  {
+    return featureIds.value( layerFeature.layerId() ).contains( layerFeature.feature().id() );
+  }
+
+  //! Returns the polygons containing \a point
+  QList<PolygonCoverage::FeatureKey> claimsAt( const QMap<QString, FeaturePool *> &featurePools, const QMap<QString, QgsFeatureIds> &featureIds,
+      const CheckContext *context, const QgsPointXY &point )
+  {
+    QList<PolygonCoverage::FeatureKey> claims;
+    const QgsRectangle rect( point.x() - context->tolerance, point.y() - context->tolerance,
+                             point.x() + context->tolerance, point.y() + context->tolerance );
+    const CheckerUtils::LayerFeatures layerFeatures( featurePools, featureIds.keys(), rect, {QgsWkbTypes::PolygonGeometry}, context );
+    for ( const CheckerUtils::LayerFeature &layerFeature : layerFeatures )
+    {
+      if ( claimedBy( featureIds, layerFeature ) && layerFeature.geometry().contains( &point ) )
+      {
+        claims.append( qMakePair( layerFeature.layerId(), layerFeature.feature().id() ) );
+      }
+    }
+    return claims;
+  }
+
+  //! Returns the polygons whose interior intersects the interior of \a face
+  QList<PolygonCoverage::FeatureKey> claimsOf( const QMap<QString, FeaturePool *> &featurePools, const QMap<QString, QgsFeatureIds> &featureIds,
+      const CheckContext *context, const QgsGeometry &face )
+  {
+    QList<PolygonCoverage::FeatureKey> claims;
+    std::unique_ptr<QgsGeometryEngine> faceEngine = CheckerUtils::createGeomEngine( face.constGet(), context->tolerance );
+    faceEngine->prepareGeometry();
+    const CheckerUtils::LayerFeatures layerFeatures( featurePools, featureIds.keys(), face.boundingBox(), {QgsWkbTypes::PolygonGeometry}, context );
+    for ( const CheckerUtils::LayerFeature &layerFeature : layerFeatures )
+    {
+      const QgsGeometry geometry = layerFeature.geometry();
+      if ( claimedBy( featureIds, layerFeature ) && faceEngine->relatePattern( geometry.constGet(), QStringLiteral( "T********" ) ) )
+      {
+        claims.append( qMakePair( layerFeature.layerId(), layerFeature.feature().id() ) );
+      }
+    }
+    return claims;
+  }
+}
+
+PolygonCoverage::PolygonCoverage( const QMap<QString, FeaturePool *> &featurePools,
+                                  const QMap<QString, QgsFeatureIds> &featureIds,
+                                  const CheckContext *context,
+                                  QgsFeedback *feedback )
+{
+  const double tolerance = context->tolerance;
+
+  // Hash all ring segments, with the polygon interior on the left of each
+  QHash<SegmentKey, SegmentEntry> segments;
+  const CheckerUtils::LayerFeatures layerFeatures( featurePools, featureIds, {QgsWkbTypes::PolygonGeometry}, feedback, context, true );
+  for ( const CheckerUtils::LayerFeature &layerFeature : layerFeatures )
+  {
+    if ( feedback && feedback->isCanceled() )
+    {
+      return;
+    }
+    const QgsGeometry geometry = layerFeature.geometry();
+    const QgsAbstractGeometry *geom = geometry.constGet();
+    for ( int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart )
+    {
+      for ( int iRing = 0, nRings = geom->ringCount( iPart ); iRing < nRings; ++iRing )
+      {
+        const int nVerts = geom->vertexCount( iPart, iRing );
+        if ( nVerts < 3 )
+        {
+          continue;
+        }
+        QgsPolylineXY ring;
+        ring.reserve( nVerts + 1 );
+        for ( int iVert = 0; iVert < nVerts; ++iVert )
+        {
+          ring.append( QgsPointXY( geom->vertexAt( QgsVertexId( iPart, iRing, iVert ) ) ) );
+        }
+        if ( ring.first() != ring.last() )
+        {
+          ring.append( ring.first() );
+        }
+
+        // Exterior rings counter clockwise, holes clockwise
+        double signedArea = 0;
+        for ( int i = 0, n = ring.size() - 1; i < n; ++i )
+        {
+          signedArea += ring.at( i ).x() * ring.at( i + 1 ).y() - ring.at( i + 1 ).x() * ring.at( i ).y();
+        }
+        const bool reversed = ( signedArea < 0 ) == ( iRing == 0 );
+
+        for ( int i = 0, n = ring.size() - 1; i < n; ++i )
+        {
+          const QgsPointXY &from = reversed ? ring.at( i + 1 ) : ring.at( i );
+          const QgsPointXY &to = reversed ? ring.at( i ) : ring.at( i + 1 );
+          const SnappedPoint a = snapped( from, tolerance );
+          const SnappedPoint b = snapped( to, tolerance );
+          if ( a == b )
+          {
+            continue;
+          }
+          const bool forward = a < b;
+          SegmentEntry &entry = segments[forward ? SegmentKey( a, b ) : SegmentKey( b, a )];
+          ++( forward ? entry.forward : entry.backward );
+        }
+      }
+    }
+  }
+
+  // Arcs shared by two neighbours separate two faces claimed equally often, drop them
+  std::unique_ptr<QgsMultiLineString> openSegments = qgis::make_unique<QgsMultiLineString>();
+  for ( auto it = segments.constBegin(); it != segments.constEnd(); ++it )
+  {
+    if ( it.value().forward == 1 && it.value().backward == 1 )
+    {
+      ++mSharedSegmentCount;
+      continue;
+    }
+    // Noded on the grid they were matched on, vertices of neighbours closer than the tolerance meet
+    openSegments->addGeometry( new QgsLineString( QVector<QgsPointXY>() << snappedPoint( it.key().first, tolerance ) << snappedPoint( it.key().second, tolerance ) ) );
+    ++mOpenSegmentCount;
+  }
+  segments.clear();
+  if ( mOpenSegmentCount == 0 || ( feedback && feedback->isCanceled() ) )
+  {
+    return;
+  }
+
+  const QgsGeometry noded = QgsGeometry( openSegments.release() ).node();
+  if ( noded.isNull() )
+  {
+    mErrorMessage = QStringLiteral( "Could not node the polygon boundaries" );
+    return;
+  }
+  const QgsGeometry faces = QgsGeometry::polygonize( QVector<QgsGeometry>() << noded );
+  if ( faces.isNull() )
+  {
+    mErrorMessage = QStringLiteral( "Could not build the faces of the polygon boundaries" );
+    return;
+  }
+
+  QgsGeometryPartIterator parts = faces.constGet()->parts();
+  while ( parts.hasNext() )
+  {
+    if ( feedback && feedback->isCanceled() )
+    {
+      return;
+    }
+    Face face;
+    face.geometry = QgsGeometry( parts.next()->clone() );
+    const QgsGeometry inside = face.geometry.pointOnSurface();
+    if ( inside.isNull() )
+    {
+      continue;
+    }
+    const int claimCount = claimsAt( featurePools, featureIds, context, inside.asPoint() ).size();
+    if ( claimCount == 0 )
+    {
+      mGaps.append( face );
+    }
+    else if ( claimCount > 1 )
+    {
+      // Neighbours of the claiming polygons may share arcs inside the face
+      face.claims = claimsOf( featurePools, featureIds, context, face.geometry );
+      mOverlaps.append( face );
+    }
+  }
+}
+
+QMap<QString, QgsFeatureIds> PolygonCoverage::coverageFeatureIds( const QMap<QString, FeaturePool *> &featurePools,
+    const QMap<QString, QgsFeatureIds> &featureIds,
+    const QSet<QString> &layerIds,
+    const CheckContext *context )
+{
+  // Layers listed without features are only compared with, their features are not checked
+  QMap<QString, QgsFeatureIds> checkedIds;
+  bool complete = true;
+  for ( auto it = featureIds.constBegin(); it != featureIds.constEnd(); ++it )
+  {
+    const FeaturePool *featurePool = featurePools.value( it.key() );
+    if ( featurePool && layerIds.contains( it.key() ) && !it.value().isEmpty() )
+    {
+      checkedIds.insert( it.key(), it.value() );
+      complete = complete && it.value().size() == featurePool->allFeatureIds().size();
+    }
+  }
+  if ( checkedIds.isEmpty() )
+  {
+    return checkedIds;
+  }
+
+  QMap<QString, QgsFeatureIds> coverageIds;
+  if ( complete )
+  {
+    for ( const QString &layerId : layerIds )
+    {
+      if ( const FeaturePool *featurePool = featurePools.value( layerId ) )
+      {
+        coverageIds.insert( layerId, featurePool->allFeatureIds() );
+      }
+    }
+    return coverageIds;
+  }
+
+  // Incremental runs and rechecks after a fix, only the surroundings of the checked features are built
+  coverageIds = checkedIds;
+  const CheckerUtils::LayerFeatures layerFeatures( featurePools, checkedIds, {QgsWkbTypes::PolygonGeometry}, nullptr, context, true );
+  for ( const CheckerUtils::LayerFeature &layerFeature : layerFeatures )
+  {
+    QgsRectangle bbox = layerFeature.geometry().boundingBox();
+    bbox.grow( context->tolerance );
+    for ( const QString &layerId : layerIds )
+    {
+      const FeaturePool *featurePool = featurePools.value( layerId );
+      if ( !featurePool || featurePool->geometryType() != QgsWkbTypes::PolygonGeometry )
+      {
+        continue;
+      }
+      const QgsCoordinateTransform ct( featurePool->crs(), context->mapCrs, context->transformContext );
+      coverageIds[layerId].unite( featurePool->getIntersects( ct.transform( bbox, QgsCoordinateTransform::ReverseTransform ) ) );
+    }
+  }
+  return coverageIds;
+}
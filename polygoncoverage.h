@@ -0,0 +1,112 @@
+#ifndef POLYGONCOVERAGE_H
+#define POLYGONCOVERAGE_H
+
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QSet>
+#include <QString>
+
+#include "qgsfeatureid.h"
+#include "qgsgeometry.h"
+
+class CheckContext;
+class FeaturePool;
+class QgsFeedback;
+
+/**
+ * \ingroup analysis
+ * The faces of a polygon coverage which are not claimed by exactly one polygon.
+ *
+ * All ring segments are hashed on their end points snapped to the tolerance of the
+ * context. A segment which one polygon runs along in one direction and another
+ * polygon in the opposite direction is an arc shared by two neighbours and is
+ * dropped. Only the remaining segments, the boundary of the coverage and the
+ * boundaries of gaps and overlaps, are noded and polygonized with GEOS.
+ *
+ * The number of polygons claiming a face is the same everywhere in the face, it is
+ * counted at a point inside it. Faces claimed by no polygon are gaps, faces claimed
+ * by two or more polygons are overlaps.
+ *
+ * All geometries are in the map crs.
+ */
+class PolygonCoverage
+{
+  public:
+
+    /**
+     * A feature as pair of layer id and feature id.
+     */
+    typedef QPair<QString, QgsFeatureId> FeatureKey;
+
+    /**
+     * A face of the coverage.
+     */
+    struct Face
+    {
+      QgsGeometry geometry;
+      //! The polygons whose interior intersects the face, empty for gaps
+      QList<FeatureKey> claims;
+    };
+
+    /**
+     * Builds the coverage of the polygons \a featureIds in \a featurePools.
+     * Stops early if \a feedback is canceled.
+     */
+    PolygonCoverage( const QMap<QString, FeaturePool *> &featurePools,
+                     const QMap<QString, QgsFeatureIds> &featureIds,
+                     const CheckContext *context,
+                     QgsFeedback *feedback = nullptr );
+
+    /**
+     * Returns the polygons of the layers \a layerIds which make up the coverage around the
+     * checked features \a featureIds.
+     * If the checked features are all the features of their layers, these are all the features
+     * of \a layerIds, layers the checked ones are compared with included. Otherwise these are
+     * the checked features and the features of \a layerIds whose bounding box intersects one
+     * of them, so that the faces they share with polygons outside the checked set are found.
+     */
+    static QMap<QString, QgsFeatureIds> coverageFeatureIds( const QMap<QString, FeaturePool *> &featurePools,
+        const QMap<QString, QgsFeatureIds> &featureIds,
+        const QSet<QString> &layerIds,
+        const CheckContext *context );
+
+    /**
+     * Returns FALSE if GEOS failed to build the faces, see errorMessage().
+     */
+    bool isValid() const { return mErrorMessage.isEmpty(); }
+
+    /**
+     * Returns the reason why the faces could not be built.
+     */
+    QString errorMessage() const { return mErrorMessage; }
+
+    /**
+     * Returns the faces claimed by no polygon.
+     */
+    const QList<Face> &gaps() const { return mGaps; }
+
+    /**
+     * Returns the faces claimed by two or more polygons.
+     */
+    const QList<Face> &overlaps() const { return mOverlaps; }
+
+    /**
+     * Returns the number of distinct segments shared by two neighbours.
+     */
+    int sharedSegmentCount() const { return mSharedSegmentCount; }
+
+    /**
+     * Returns the number of distinct segments which were handed to GEOS.
+     */
+    int openSegmentCount() const { return mOpenSegmentCount; }
+
+  private:
+    QList<Face> mGaps;
+    QList<Face> mOverlaps;
+    QString mErrorMessage;
+    int mSharedSegmentCount = 0;
+    int mOpenSegmentCount = 0;
+};
+
+#endif // POLYGONCOVERAGE_H
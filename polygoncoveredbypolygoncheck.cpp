@@ -6,13 +6,13 @@
 #include "qgsvectorlayer.h"
 #include "checkerror.h"
 
-void PolygonCoveredByPolygonCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void PolygonCoveredByPolygonCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(layersA.begin(), layersA.end(), layerFeatureA.layer()) == layersA.end())
+        if (!layersA.contains(layerFeatureA.layer()))
             continue;
         if (feedback && feedback->isCanceled())
             break;
@@ -27,7 +27,7 @@ void PolygonCoveredByPolygonCheck::collectErrors(const QMap<QString, FeaturePool
             CheckerUtils::LayerFeatures layerFeaturesB(featurePools, featureIds.keys(), polygon.boundingBox(), {QgsWkbTypes::PolygonGeometry}, mContext);
             for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
             {
-                if (std::find(layersB.begin(), layersB.end(), layerFeatureB.layer()) == layersB.end())
+                if (!layersB.contains(layerFeatureB.layer()))
                     continue;
                 QVector<QgsGeometry> geomsB = layerFeatureB.geometry().asGeometryCollection();
 
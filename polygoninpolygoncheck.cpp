@@ -1,29 +1,49 @@
 ﻿#include "polygoninpolygoncheck.h"
+#include "candidatepairs.h"
 #include "checkcontext.h"
 #include "qgsgeometryengine.h"
 #include "featurepool.h"
 #include "qgsvectorlayer.h"
 
-void PolygonInPolygonCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void PolygonInPolygonCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
-    CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext);
+    // In the map crs like the features of layersB, the candidates of the features are shared with the other checks of the run
+    CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
+    CandidatePairCache *candidatePairs = mContext->candidatePairs();
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(layersA.begin(), layersA.end(), layerFeatureA.layer()) == layersA.end())
+        if (!layersA.contains(layerFeatureA.layer()))
             continue;
-        const QgsAbstractGeometry *geom = layerFeatureA.geometry().constGet();
+
+        // The features of layersB whose bounding box intersects the one of the whole feature
+        QList<CheckerUtils::LayerFeature> layerFeaturesB;
+        for (const QString &layerIdB : featureIds.keys())
+        {
+            FeaturePool *featurePoolB = featurePools.value(layerIdB);
+            if (!compatibleGeometryTypes().contains(featurePoolB->geometryType()) || !layersB.contains(featurePoolB->layerPtr().data()))
+                continue;
+            for (QgsFeatureId idB : candidatePairs->candidates(featurePools, layerFeatureA, layerIdB, mContext->tolerance, mContext))
+            {
+                CheckerUtils::LayerFeature layerFeatureB;
+                if (candidatePairs->layerFeature(featurePoolB, idB, mContext, layerFeatureB))
+                    layerFeaturesB.append(layerFeatureB);
+            }
+        }
+
+        const QgsGeometry geometry = layerFeatureA.geometry();
+        const QgsAbstractGeometry *geom = geometry.constGet();
         for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
         {
             const QgsAbstractGeometry *geomA = CheckerUtils::getGeomPart(geom, iPart);
             QgsRectangle bboxA = geomA->boundingBox();
             bool contains = false;
-            CheckerUtils::LayerFeatures layerFeaturesB(featurePools, featureIds.keys(), bboxA, compatibleGeometryTypes(), mContext);
-            for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
+            for (const CheckerUtils::LayerFeature &layerFeatureB : qgis::as_const(layerFeaturesB))
             {
-                if (std::find(layersB.begin(), layersB.end(), layerFeatureB.layer()) == layersB.end())
+                const QgsGeometry testGeometry = layerFeatureB.geometry();
+                if (!testGeometry.boundingBox().intersects(bboxA))
                     continue;
-                const QgsAbstractGeometry *testGeom = layerFeatureB.geometry().constGet();
+                const QgsAbstractGeometry *testGeom = testGeometry.constGet();
                 for (int jPart = 0, mParts = testGeom->partCount(); jPart < mParts; ++jPart)
                 {
                     const QgsAbstractGeometry *geomB = CheckerUtils::getGeomPart(testGeom, jPart);
@@ -77,7 +97,7 @@ void PolygonInPolygonCheck::fixError(const QMap<QString, FeaturePool *> &feature
     CheckerUtils::LayerFeatures layerFeaturesB(featurePools, featureIds.keys(), bboxA, compatibleGeometryTypes(), mContext);
     for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
     {
-        if (std::find(layersB.begin(), layersB.end(), layerFeatureB.layer()) == layersB.end())
+        if (!layersB.contains(layerFeatureB.layer()))
             continue;
         const QgsAbstractGeometry *testGeom = layerFeatureB.geometry().constGet();
         for (int jPart = 0, mParts = testGeom->partCount(); jPart < mParts; ++jPart)
@@ -1,5 +1,6 @@
 ﻿#include "polygonlayeroverlapcheck.h"
 #include "checkcontext.h"
+#include "polygoncoverage.h"
 #include "qgsgeometryengine.h"
 #include "featurepool.h"
 #include "qgsvectorlayer.h"
@@ -15,20 +16,55 @@ PolygonLayerOverlapCheck::PolygonLayerOverlapCheck(const CheckContext *context,
     layersB = var.value<QSet<QgsVectorLayer *>>();
 }
 
-void PolygonLayerOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void PolygonLayerOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
-    const CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
-    QList<QString> layerIds = featureIds.keys();
+
+    // Overlaps are the faces of the coverage claimed by more than one polygon. The layers of
+    // layersB are listed without features, their polygons are added around the checked ones.
+    QSet<QString> coverageLayerIds;
+    for (auto it = featurePools.constBegin(); it != featurePools.constEnd(); ++it)
+    {
+        if (layersA.contains(it.value()->layerPtr().data()) || layersB.contains(it.value()->layerPtr().data()))
+            coverageLayerIds.insert(it.key());
+    }
+    const PolygonCoverage coverage(featurePools, PolygonCoverage::coverageFeatureIds(featurePools, featureIds, coverageLayerIds, mContext), mContext, feedback);
+    if (!coverage.isValid())
+    {
+        messages.append(tr("Overlap check: %1").arg(coverage.errorMessage()));
+        return;
+    }
+
+    // Only the polygons claiming a face together are compared with GEOS
+    QMap<QString, QgsFeatureIds> candidateIds;
+    QHash<PolygonCoverage::FeatureKey, QSet<PolygonCoverage::FeatureKey>> candidates;
+    for (const PolygonCoverage::Face &overlap : coverage.overlaps())
+    {
+        for (const PolygonCoverage::FeatureKey &a : overlap.claims)
+        {
+            for (const PolygonCoverage::FeatureKey &b : overlap.claims)
+            {
+                if (a == b || !layersA.contains(featurePools.value(a.first)->layerPtr().data()) || !layersB.contains(featurePools.value(b.first)->layerPtr().data()))
+                    continue;
+                // Overlaps between two polygons around the checked ones are left to the runs checking them
+                if (!featureIds.value(a.first).contains(a.second) && !featureIds.value(b.first).contains(b.second))
+                    continue;
+                // > : only report overlaps within same layer once
+                if (a.first == b.first && b.second >= a.second)
+                    continue;
+                candidateIds[a.first].insert(a.second);
+                candidates[a].insert(b);
+            }
+        }
+    }
+
+    const CheckerUtils::LayerFeatures layerFeaturesA(featurePools, candidateIds, compatibleGeometryTypes(), nullptr, mContext, true);
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(layersA.begin(), layersA.end(), layerFeatureA.layer()) == layersA.end())
-            continue;
         if (feedback && feedback->isCanceled())
             break;
 
         const QgsGeometry geomA = layerFeatureA.geometry();
-        QgsRectangle bboxA = geomA.boundingBox();
         std::unique_ptr<QgsGeometryEngine> geomEngineA = CheckerUtils::createGeomEngine(geomA.constGet(), mContext->tolerance);
         geomEngineA->prepareGeometry();
         if (!geomEngineA->isValid())
@@ -37,19 +73,16 @@ void PolygonLayerOverlapCheck::collectErrors(const QMap<QString, FeaturePool *>
             continue;
         }
 
-        const CheckerUtils::LayerFeatures layerFeaturesB(featurePools, QList<QString>() << layerIds, bboxA, compatibleGeometryTypes(), mContext);
-        for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
+        const QSet<PolygonCoverage::FeatureKey> others = candidates.value(qMakePair(layerFeatureA.layerId(), layerFeatureA.feature().id()));
+        for (const PolygonCoverage::FeatureKey &other : others)
         {
-            if (std::find(layersB.begin(), layersB.end(), layerFeatureB.layer()) == layersB.end())
-                continue;
             if (feedback && feedback->isCanceled())
                 break;
-
-            // > : only report overlaps within same layer once
-            if (layerFeatureA.layerId() == layerFeatureB.layerId() && layerFeatureB.feature().id() >= layerFeatureA.feature().id())
-            {
+            FeaturePool *featurePoolB = featurePools.value(other.first);
+            QgsFeature featureB;
+            if (!featurePoolB->getFeature(other.second, featureB))
                 continue;
-            }
+            const CheckerUtils::LayerFeature layerFeatureB(featurePoolB, featureB, mContext, true);
 
             QString errMsg;
             const QgsGeometry geometryB = layerFeatureB.geometry();
@@ -1,5 +1,7 @@
 ﻿#include "polygonoverlapcheck.h"
+#include "candidatepairs.h"
 #include "checkcontext.h"
+#include "polygoncoverage.h"
 #include "qgsgeometryengine.h"
 #include "featurepool.h"
 #include "qgsvectorlayer.h"
@@ -13,23 +15,55 @@ PolygonOverlapCheck::PolygonOverlapCheck(const CheckContext *context, const QVar
     layers = var.value<QSet<QgsVectorLayer *>>();
 }
 
-void PolygonOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void PolygonOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
-    const CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
-    QList<QString> layerIds = featureIds.keys();
+
+    // Overlaps are the faces of the coverage claimed by more than one polygon. When only some
+    // features are checked, the polygons around them are added to find their overlaps.
+    QSet<QString> coverageLayerIds;
+    for (auto it = featurePools.constBegin(); it != featurePools.constEnd(); ++it)
+    {
+        if (layers.contains(it.value()->layerPtr().data()))
+            coverageLayerIds.insert(it.key());
+    }
+    const PolygonCoverage coverage(featurePools, PolygonCoverage::coverageFeatureIds(featurePools, featureIds, coverageLayerIds, mContext), mContext, feedback);
+    if (!coverage.isValid())
+    {
+        messages.append(tr("Overlap check: %1").arg(coverage.errorMessage()));
+        return;
+    }
+
+    // Only the polygons claiming a face together are compared with GEOS
+    QMap<QString, QgsFeatureIds> candidateIds;
+    QHash<PolygonCoverage::FeatureKey, QSet<PolygonCoverage::FeatureKey>> candidates;
+    for (const PolygonCoverage::Face &overlap : coverage.overlaps())
+    {
+        for (const PolygonCoverage::FeatureKey &a : overlap.claims)
+        {
+            for (const PolygonCoverage::FeatureKey &b : overlap.claims)
+            {
+                // Overlaps are looked for within a layer and reported once
+                if (a.first != b.first || b.second >= a.second)
+                    continue;
+                // Overlaps between two polygons around the checked ones are left to the runs checking them
+                if (!featureIds.value(a.first).contains(a.second) && !featureIds.value(b.first).contains(b.second))
+                    continue;
+                candidateIds[a.first].insert(a.second);
+                candidates[a].insert(b);
+            }
+        }
+    }
+
+    const CheckerUtils::LayerFeatures layerFeaturesA(featurePools, candidateIds, compatibleGeometryTypes(), nullptr, mContext, true);
+    // A polygon overlapping several others is compared with each of them, it is reprojected once
+    CandidatePairCache *candidatePairs = mContext->candidatePairs();
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeatureA.layer()) == layers.end())
-            continue;
         if (feedback && feedback->isCanceled())
             break;
 
-        // Ensure each pair of layers only gets compared once: remove the current layer from the layerIds, but add it to the layerList for layerFeaturesB
-        layerIds.removeOne(layerFeatureA.layer()->id());
-
         const QgsGeometry geomA = layerFeatureA.geometry();
-        QgsRectangle bboxA = geomA.boundingBox();
         std::unique_ptr<QgsGeometryEngine> geomEngineA = CheckerUtils::createGeomEngine(geomA.constGet(), mContext->tolerance);
         geomEngineA->prepareGeometry();
         if (!geomEngineA->isValid())
@@ -38,19 +72,14 @@ void PolygonOverlapCheck::collectErrors(const QMap<QString, FeaturePool *> &feat
             continue;
         }
 
-        const CheckerUtils::LayerFeatures layerFeaturesB(featurePools, QList<QString>() << layerFeatureA.layer()->id(), bboxA, compatibleGeometryTypes(), mContext);
-        for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
+        const QSet<PolygonCoverage::FeatureKey> others = candidates.value(qMakePair(layerFeatureA.layerId(), layerFeatureA.feature().id()));
+        for (const PolygonCoverage::FeatureKey &other : others)
         {
-            if (std::find(layers.begin(), layers.end(), layerFeatureB.layer()) == layers.end())
-                continue;
             if (feedback && feedback->isCanceled())
                 break;
-
-            // > : only report overlaps within same layer once
-            if (layerFeatureA.layerId() == layerFeatureB.layerId() && layerFeatureB.feature().id() >= layerFeatureA.feature().id())
-            {
+            CheckerUtils::LayerFeature layerFeatureB;
+            if (!candidatePairs->layerFeature(featurePools.value(other.first), other.second, mContext, layerFeatureB))
                 continue;
-            }
 
             QString errMsg;
             const QgsGeometry geometryB = layerFeatureB.geometry();
@@ -1,93 +1,36 @@
 ﻿#include "pseudoscheck.h"
 #include "checkcontext.h"
+#include "linenetwork.h"
 #include "qgsgeometryutils.h"
 #include "featurepool.h"
 #include "checkerror.h"
 
-class PointComparer
-{
-public:
-    bool operator()(const QgsPointXY &p1, const QgsPointXY &p2) const
-    {
-        if (p1.x() < p2.x())
-        {
-            return true;
-        }
-
-        if (p1.x() == p2.x() && p1.y() < p2.y())
-        {
-            return true;
-        }
-
-        return false;
-    }
-};
-
-void PseudosCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void PseudosCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
-
-    for (auto it : featurePools)
+    const QSet<QgsVectorLayer *> layers = configuredLayers();
+    const QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
+    for (auto it = featureIds.constBegin(); it != featureIds.constEnd(); ++it)
     {
+        FeaturePool *featurePool = featurePools.value(it.key());
+        if (!featurePool || it.value().isEmpty() || featurePool->geometryType() != QgsWkbTypes::LineGeometry || !layers.contains(featurePool->layerPtr().data()))
+            continue;
 
-        QgsVectorLayer *layer = it->layer();
-
-        QgsPointXY startPoint;
-        QgsPointXY endPoint;
-
-        std::multimap<QgsPointXY, QgsFeatureId, PointComparer> endVerticesMap;
-
-        QgsFeature feature;
-        QgsFeatureRequest req;
-        QgsFeatureIds featureIds = it->allFeatureIds();
-        req.setFilterFids(featureIds);
-        QgsFeatureIterator iterator = it->layer()->getFeatures(req);
-        while (iterator.nextFeature(feature))
+        // Exactly two line ends meet at a pseudo node and nothing else
+        const std::shared_ptr<const LineNetwork> network = mContext->lineNetworks()->network(featurePool, mContext);
+        for (int iNode = 0, nNodes = network->nodeCount(); iNode < nNodes; ++iNode)
         {
-            if (!feature.hasGeometry() || feature.geometry().isNull())
+            if (feedback && feedback->isCanceled())
+                return;
+            const LineNetwork::Node &node = network->node(iNode);
+            if (node.ends != 2 || node.degree() != 2)
                 continue;
-
-            QgsGeometry geo = feature.geometry();
-
-            if (geo.isMultipart())
-            {
-                QgsMultiPolylineXY lines = geo.asMultiPolyline();
-                for (int m = 0; m < lines.count(); m++)
-                {
-                    QgsPolylineXY line = lines[m];
-                    startPoint = line[0];
-                    endPoint = line[line.size() - 1];
-
-                    endVerticesMap.insert(std::pair<QgsPointXY, QgsFeatureId>(startPoint, feature.id()));
-                    endVerticesMap.insert(std::pair<QgsPointXY, QgsFeatureId>(endPoint, feature.id()));
-                }
-            }
-            else
-            {
-                QgsPolylineXY polyline = geo.asPolyline();
-                startPoint = polyline[0];
-                endPoint = polyline[polyline.size() - 1];
-                endVerticesMap.insert(std::pair<QgsPointXY, QgsFeatureId>(startPoint, feature.id()));
-                endVerticesMap.insert(std::pair<QgsPointXY, QgsFeatureId>(endPoint, feature.id()));
-            }
-        }
-
-        for (std::multimap<QgsPointXY, QgsFeatureId, PointComparer>::iterator pointIt = endVerticesMap.begin(), end = endVerticesMap.end(); pointIt != end; pointIt = endVerticesMap.upper_bound(pointIt->first))
-        {
-            QgsPointXY p = pointIt->first;
-            QgsFeatureId k = pointIt->second;
-
-            size_t repetitions = endVerticesMap.count(p);
-
-            if (repetitions == 2)
-            {
-                QgsGeometry conflictGeom = QgsGeometry::fromPointXY(p);
-
-                QgsFeature feat;
-                layer->getFeatures(QgsFeatureRequest().setFilterFid(k)).nextFeature(feat);
-
-                errors.append(new CheckError(this, layer->id(), feature.id(), conflictGeom, p));
-            }
+            const LineNetwork::Edge &edge = network->edge(node.edges.first());
+            const LineNetwork::Edge &otherEdge = network->edge(node.edges.last());
+            if (!it.value().contains(edge.featureId) && !it.value().contains(otherEdge.featureId))
+                continue;
+            const int vertex = edge.startNode == iNode ? 0 : edge.vertexCount - 1;
+            errors.append(new CheckError(this, it.key(), edge.featureId, QgsGeometry::fromPointXY(node.point), node.point, QgsVertexId(edge.part, 0, vertex)));
         }
     }
 }
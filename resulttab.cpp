@@ -1,7 +1,9 @@
 ﻿#include "resulttab.h"
 #include "ui_resulttab.h"
 #include "checkerror.h"
+#include "checktracer.h"
 #include <qgsmapcanvas.h>
+#include <qgsmessagebar.h>
 #include <QDialog>
 #include <qgsproject.h>
 #include <QMessageBox>
@@ -13,6 +15,10 @@
 #include <QButtonGroup>
 #include <QDialogButtonBox>
 #include <QPlainTextEdit>
+#include <QProgressDialog>
+#include <QTreeWidget>
+#include <QJsonDocument>
+#include <algorithm>
 
 QString ResultTab::sSettingsGroup = QStringLiteral("/TopologyChecker/default_fix_methods/");
 
@@ -20,14 +26,13 @@ ResultTab::ResultTab(QgisInterface *iface, Checker *checker, QTabWidget *tabWidg
     : QWidget(parent), ui(new Ui::ResultTab), mTabWidget(tabWidget), mIface(iface), mChecker(checker)
 {
     ui->setupUi(this);
-    ui->progressBarFixErrors->hide();
     this->grabKeyboard();
-    mErrorCount = 0;
-    mFixedCount = 0;
 
-    connect(checker, &Checker::errorAdded, this, &ResultTab::addError);
-    connect(checker, &Checker::errorUpdated, this, &ResultTab::updateError);
-    connect(ui->tableWidgetErrors->selectionModel(), &QItemSelectionModel::selectionChanged, this, &ResultTab::onSelectionChanged);
+    mModel = new CheckErrorModel(checker, this);
+    ui->tableViewErrors->setModel(mModel);
+
+    connect(mModel, &CheckErrorModel::countsChanged, this, &ResultTab::updateErrorCount);
+    connect(ui->tableViewErrors->selectionModel(), &QItemSelectionModel::selectionChanged, this, &ResultTab::onSelectionChanged);
     connect(ui->btnOpenAttributeTable, &QAbstractButton::clicked, this, &ResultTab::openAttributeTable);
     connect(ui->checkBoxHighlight, &QAbstractButton::clicked, this, &ResultTab::highlightErrors);
     connect(QgsProject::instance(), static_cast<void (QgsProject::*)(const QStringList &)>(&QgsProject::layersWillBeRemoved), this, &ResultTab::checkRemovedLayer);
@@ -38,6 +43,8 @@ ResultTab::ResultTab(QgisInterface *iface, Checker *checker, QTabWidget *tabWidg
     connect(ui->btnClassify, &QPushButton::clicked, this, &ResultTab::classify);
 
     connect(ui->btnSwitch, &QPushButton::clicked, this, &ResultTab::switchByKey);
+    connect(ui->btnProfile, &QPushButton::clicked, this, &ResultTab::showProfile);
+    ui->btnProfile->setEnabled(mChecker->isProfilingEnabled());
 
     bool allLayersEditable = true;
     for (const FeaturePool *featurePool : mChecker->featurePools().values())
@@ -53,26 +60,53 @@ ResultTab::ResultTab(QgisInterface *iface, Checker *checker, QTabWidget *tabWidg
         ui->btnFix->setEnabled(false);
         ui->btnFixWithDefault->setEnabled(false);
     }
+    // A tiled run released its features, the errors can only be reviewed
+    if (!mChecker->canFixErrors())
+    {
+        ui->btnFix->setEnabled(false);
+        ui->btnFixWithDefault->setEnabled(false);
+        ui->btnFix->setToolTip(QStringLiteral("分块检查的错误无法修复，请不设内存上限重新检查"));
+        ui->btnFixWithDefault->setToolTip(ui->btnFix->toolTip());
+    }
 
-    ui->tableWidgetErrors->horizontalHeader()->setSortIndicator(0, Qt::AscendingOrder);
-    ui->tableWidgetErrors->resizeColumnToContents(0);
-    ui->tableWidgetErrors->resizeColumnToContents(1);
-    ui->tableWidgetErrors->horizontalHeader()->setStretchLastSection(true);
-    // Not sure why, but this is needed...
-    ui->tableWidgetErrors->setSortingEnabled(true);
-    ui->tableWidgetErrors->setSortingEnabled(false);
+    ui->tableViewErrors->horizontalHeader()->setSortIndicator(0, Qt::AscendingOrder);
+    ui->tableViewErrors->resizeColumnToContents(0);
+    ui->tableViewErrors->resizeColumnToContents(1);
+    ui->tableViewErrors->horizontalHeader()->setStretchLastSection(true);
 }
 
 ResultTab::~ResultTab()
 {
     delete ui;
+    // The model refers to the errors of the checker
+    delete mModel;
     delete mChecker;
     qDeleteAll(mCurrentRubberBands);
 }
 
 void ResultTab::finalize()
 {
-    ui->tableWidgetErrors->setSortingEnabled(true);
+    // Sorts all errors in the background
+    ui->tableViewErrors->setSortingEnabled(true);
+    if (CheckTracer::isEnabled())
+    {
+        CheckTracer::stop();
+        const QString traceFile = QgsSettings().value(QStringLiteral("/TopologyChecker/traceFile")).toString();
+        if (!CheckTracer::write(traceFile))
+            mIface->messageBar()->pushWarning(QStringLiteral("性能跟踪"), QStringLiteral("无法写入 %1").arg(QDir::toNativeSeparators(traceFile)));
+    }
+    if (mChecker->isCanceled())
+    {
+        mIface->messageBar()->pushWarning(QStringLiteral("检查已取消"), QStringLiteral("检查未完成，只列出了取消前找到的错误"));
+    }
+    if (mChecker->skippedFeatureCount() > 0)
+    {
+        mIface->messageBar()->pushInfo(QStringLiteral("增量检查"), QStringLiteral("%1 个要素自上次检查以来未发生变化，已沿用上次的检查结果").arg(mChecker->skippedFeatureCount()));
+    }
+    if (mChecker->spilledErrorCount() > 0)
+    {
+        mIface->messageBar()->pushWarning(QStringLiteral("错误过多"), QStringLiteral("另有 %1 个错误未列出，已写入 %2").arg(mChecker->spilledErrorCount()).arg(QDir::toNativeSeparators(mChecker->spillFileName())));
+    }
     if (!mChecker->getMessages().isEmpty())
     {
         QDialog dialog;
@@ -94,28 +128,14 @@ void ResultTab::keyReleaseEvent(QKeyEvent *event)
     switch (event->key())
     {
     case Qt::Key_A:
-        ui->tableWidgetErrors->selectRow(mCurrentRow + 1);
+        ui->tableViewErrors->selectRow(mCurrentRow + 1);
         break;
     case Qt::Key_S:
-        ui->tableWidgetErrors->selectRow(mCurrentRow - 1);
+        ui->tableViewErrors->selectRow(mCurrentRow - 1);
         break;
     }
 }
 
-void ResultTab::setRowStatus(int row, const QColor &color, const QString &message, bool selectable)
-{
-    for (int col = 0, nCols = ui->tableWidgetErrors->columnCount(); col < nCols; ++col)
-    {
-        QTableWidgetItem *item = ui->tableWidgetErrors->item(row, col);
-        item->setBackground(color);
-        if (!selectable)
-        {
-            item->setFlags(item->flags() & ~Qt::ItemIsSelectable);
-            item->setForeground(Qt::lightGray);
-        }
-    }
-    ui->tableWidgetErrors->item(row, 5)->setText(message);
-}
 #include <qgspolygon.h>
 bool ResultTab::exportErrorsDo(const QString &file)
 {
@@ -152,9 +172,8 @@ bool ResultTab::exportErrorsDo(const QString &file)
     int fieldErrPos = layer->fields().lookupField(QStringLiteral("coordinate"));
     int fieldErrValue = layer->fields().lookupField(QStringLiteral("value"));
     int fieldErrFix = layer->fields().lookupField(QStringLiteral("resolution"));
-    for (int row = 0, nRows = ui->tableWidgetErrors->rowCount(); row < nRows; ++row)
+    for (CheckError *error : mChecker->errors())
     {
-        CheckError *error = ui->tableWidgetErrors->item(row, 0)->data(Qt::UserRole).value<CheckError *>();
         QString layerName = QString();
         const QString layerId = error->layerId();
         if (mChecker->featurePools().keys().contains(layerId))
@@ -206,10 +225,13 @@ bool ResultTab::exportErrorsDo(const QString &file)
 
 void ResultTab::updateComboBox()
 {
-    int row = ui->tableWidgetErrors->currentRow();
-    CheckError *error = ui->tableWidgetErrors->item(row, 0)->data(Qt::UserRole).value<CheckError *>();
-    const QList<CheckResolutionMethod> resolutionMethods = error->check()->availableResolutionMethods();
+    CheckError *error = mModel->error(ui->tableViewErrors->currentIndex().row());
     ui->mComboBox->clear();
+    if (!error)
+    {
+        return;
+    }
+    const QList<CheckResolutionMethod> resolutionMethods = error->check()->availableResolutionMethods();
     int i = 0;
     for (const CheckResolutionMethod &method : resolutionMethods)
     {
@@ -218,82 +240,18 @@ void ResultTab::updateComboBox()
     }
 }
 
-void ResultTab::addError(CheckError *error)
+void ResultTab::updateErrorCount()
 {
-    bool sortingWasEnabled = ui->tableWidgetErrors->isSortingEnabled();
-    if (sortingWasEnabled)
-        ui->tableWidgetErrors->setSortingEnabled(false);
-
-    int row = ui->tableWidgetErrors->rowCount();
-    int prec = 7 - std::floor(std::max(0., std::log10(std::max(error->location().x(), error->location().y()))));
-    QString posStr = QStringLiteral("%1, %2").arg(error->location().x(), 0, 'f', prec).arg(error->location().y(), 0, 'f', prec);
-
-    ui->tableWidgetErrors->insertRow(row);
-    QTableWidgetItem *idItem = new QTableWidgetItem();
-    idItem->setData(Qt::EditRole, error->featureId() != FID_NULL ? QVariant(error->featureId()) : QVariant());
-    ui->tableWidgetErrors->setItem(row, 0, new QTableWidgetItem(!error->layerId().isEmpty() ? mChecker->featurePools()[error->layerId()]->layer()->name() : ""));
-    ui->tableWidgetErrors->setItem(row, 1, idItem);
-    ui->tableWidgetErrors->setItem(row, 2, new QTableWidgetItem(error->description()));
-    ui->tableWidgetErrors->setItem(row, 3, new QTableWidgetItem(posStr));
-    QTableWidgetItem *valueItem = new QTableWidgetItem();
-    valueItem->setData(Qt::EditRole, error->value());
-    ui->tableWidgetErrors->setItem(row, 4, valueItem);
-    ui->tableWidgetErrors->setItem(row, 5, new QTableWidgetItem(QString()));
-    ui->tableWidgetErrors->item(row, 0)->setData(Qt::UserRole, QVariant::fromValue(error));
-    ++mErrorCount;
-    ui->labelErrorCount->setText(QStringLiteral("错误数目：") + QString::number(mErrorCount) + QStringLiteral("，修复数目：") + QString::number(mFixedCount));
-    mErrorMap.insert(error, QPersistentModelIndex(ui->tableWidgetErrors->model()->index(row, 0)));
-
-    if (sortingWasEnabled)
-        ui->tableWidgetErrors->setSortingEnabled(true);
-}
-
-void ResultTab::updateError(CheckError *error, bool statusChanged)
-{
-    if (!mErrorMap.contains(error))
-    {
-        return;
-    }
-    // Disable sorting to prevent crashes: if i.e. sorting by col 0, as soon as the item(row, 0) is set,
-    // the row is potentially moved due to sorting, and subsequent item(row, col) reference wrong item
-    bool sortingWasEnabled = ui->tableWidgetErrors->isSortingEnabled();
-    if (sortingWasEnabled)
-        ui->tableWidgetErrors->setSortingEnabled(false);
-
-    int row = mErrorMap.value(error).row();
-    int prec = 7 - std::floor(std::max(0., std::log10(std::max(error->location().x(), error->location().y()))));
-    QString posStr = QStringLiteral("%1, %2").arg(error->location().x(), 0, 'f', prec).arg(error->location().y(), 0, 'f', prec);
-
-    ui->tableWidgetErrors->item(row, 3)->setText(posStr);
-    ui->tableWidgetErrors->item(row, 4)->setData(Qt::EditRole, error->value());
-    if (error->status() == CheckError::StatusFixed)
-    {
-        setRowStatus(row, Qt::green, tr("Fixed: %1").arg(error->resolutionMessage()), true);
-        ++mFixedCount;
-    }
-    else if (error->status() == CheckError::StatusFixFailed)
-    {
-        setRowStatus(row, Qt::red, tr("Fix failed: %1").arg(error->resolutionMessage()), true);
-    }
-    else if (error->status() == CheckError::StatusObsolete)
-    {
-        //ui->tableWidgetErrors->setRowHidden(row, true);
-        setRowStatus( row, Qt::gray, tr( "Obsolete" ), false );
-        --mErrorCount;
-    }
-    ui->labelErrorCount->setText(QStringLiteral("错误数目：") + QString::number(mErrorCount) + QStringLiteral("，修复数目：") + QString::number(mFixedCount));
-
-    if (sortingWasEnabled)
-        ui->tableWidgetErrors->setSortingEnabled(true);
+    ui->labelErrorCount->setText(QStringLiteral("错误数目：") + QString::number(mModel->errorCount()) + QStringLiteral("，修复数目：") + QString::number(mModel->fixedCount()));
 }
 
 void ResultTab::onSelectionChanged(const QItemSelection &newSel, const QItemSelection &)
 {
     updateComboBox();
 
-    QModelIndex idx = ui->tableWidgetErrors->currentIndex();
-    mCurrentRow = ui->tableWidgetErrors->currentRow();
-    if (idx.isValid() && !ui->tableWidgetErrors->isRowHidden(idx.row()) && newSel.contains(idx))
+    QModelIndex idx = ui->tableViewErrors->currentIndex();
+    mCurrentRow = idx.row();
+    if (idx.isValid() && newSel.contains(idx))
     {
         highlightErrors();
     }
@@ -310,21 +268,24 @@ void ResultTab::highlightErrors(bool current)
     qDeleteAll(mCurrentRubberBands);
     mCurrentRubberBands.clear();
 
-    QList<QTableWidgetItem *> items;
+    QList<CheckError *> errors;
     QVector<QgsPointXY> errorPositions;
     QgsRectangle totextent;
 
     if (current)
     {
-        items.append(ui->tableWidgetErrors->currentItem());
+        if (CheckError *error = mModel->error(ui->tableViewErrors->currentIndex().row()))
+            errors.append(error);
     }
     else
     {
-        items.append(ui->tableWidgetErrors->selectedItems());
+        for (const QModelIndex &idx : ui->tableViewErrors->selectionModel()->selectedRows())
+        {
+            errors.append(mModel->error(idx.row()));
+        }
     }
-    for (QTableWidgetItem *item : qgis::as_const(items))
+    for (CheckError *error : qgis::as_const(errors))
     {
-        CheckError *error = ui->tableWidgetErrors->item(item->row(), 0)->data(Qt::UserRole).value<CheckError *>();
 
         const QgsGeometry geom = error->geometry();
         if (ui->checkBoxHighlight->isChecked() && !geom.isNull())
@@ -399,9 +360,9 @@ void ResultTab::highlightErrors(bool current)
 void ResultTab::openAttributeTable()
 {
     QMap<QString, QSet<QgsFeatureId>> ids;
-    for (QModelIndex idx : ui->tableWidgetErrors->selectionModel()->selectedRows())
+    for (QModelIndex idx : ui->tableViewErrors->selectionModel()->selectedRows())
     {
-        CheckError *error = ui->tableWidgetErrors->item(idx.row(), 0)->data(Qt::UserRole).value<CheckError *>();
+        CheckError *error = mModel->error(idx.row());
         QgsFeatureId id = error->featureId();
         if (id >= 0)
         {
@@ -475,21 +436,22 @@ void ResultTab::exportErrors()
 
 void ResultTab::fixCurrentError()
 {
-    int row = ui->tableWidgetErrors->currentRow();
-    CheckError *error = ui->tableWidgetErrors->item(row, 0)->data(Qt::UserRole).value<CheckError *>();
+    CheckError *error = mModel->error(ui->tableViewErrors->currentIndex().row());
+    if (!error)
+    {
+        return;
+    }
     mChecker->fixError(error, ui->mComboBox->currentData().toInt(), true);
 }
 
 void ResultTab::fixErrorsWithDefault()
 {
-    int sum = ui->tableWidgetErrors->rowCount();
+    int sum = mModel->rowCount();
     QList<CheckError *> errors;
 
     for (int i = 0; i < sum; ++i)
     {
-        if(ui->tableWidgetErrors->isRowHidden(i))
-            continue;
-        CheckError *error = ui->tableWidgetErrors->item(i, 0)->data(Qt::UserRole).value<CheckError *>();
+        CheckError *error = mModel->error(i);
         if (error->status() < CheckError::StatusFixed)
         {
             errors.append(error);
@@ -505,9 +467,6 @@ void ResultTab::fixErrorsWithDefault()
         return;
     }
 
-    // Disable sorting while fixing errors
-    ui->tableWidgetErrors->setSortingEnabled(false);
-
     // clear rubberbands
     qDeleteAll(mCurrentRubberBands);
     mCurrentRubberBands.clear();
@@ -516,18 +475,23 @@ void ResultTab::fixErrorsWithDefault()
     mCloseable = false;
 
     //setCursor(Qt::WaitCursor);
-    ui->progressBarFixErrors->setVisible(true);
-    ui->progressBarFixErrors->setRange(0, errors.size());
+    // Modal, only its cancel button takes input while the errors are fixed
+    QProgressDialog progress(QStringLiteral("正在修复错误..."), QStringLiteral("取消"), 0, errors.size(), this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
 
+    int fixedCount = 0;
     for (CheckError *error : qgis::as_const(errors))
     {
+        // The errors fixed so far stay fixed
+        if (progress.wasCanceled())
+            break;
         int fixMethod = QgsSettings().value(sSettingsGroup + error->check()->id(), QVariant::fromValue<int>(0)).toInt();
 
         mChecker->fixError(error, fixMethod);
-        ui->progressBarFixErrors->setValue(ui->progressBarFixErrors->value() + 1);
-        QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+        progress.setValue(++fixedCount);
     }
-    ui->progressBarFixErrors->hide();
+    progress.setValue(errors.size());
 
     //unsetCursor();
 
@@ -537,7 +501,6 @@ void ResultTab::fixErrorsWithDefault()
     }
 
     mCloseable = true;
-    ui->tableWidgetErrors->setSortingEnabled(true);
 }
 
 void ResultTab::setDefaultResolutionMethods()
@@ -611,46 +574,90 @@ void ResultTab::classify()
 
 void ResultTab::doClassify()
 {
-    mErrorCount = 0;
-    mFixedCount = 0;
     mClassifyDialog->hide();
-    QStringList selectedTypes = mClassifyDialog->selectedType();
-
-    int sum = ui->tableWidgetErrors->rowCount();
+    // The error count is updated once the filter has been applied
+    mModel->setCheckFilter(mClassifyDialog->selectedType());
+}
 
-    for (int i = 0; i < sum; ++i)
+void ResultTab::switchByKey()
+{
+    if(enableKeyboard)
+    {
+        ui->btnSwitch->setIcon(QIcon(":/icons/mSwitchFalse.svg"));
+    }
+    else
     {
-        ui->tableWidgetErrors->showRow(i);
-        CheckError *error = ui->tableWidgetErrors->item(i, 0)->data(Qt::UserRole).value<CheckError *>();
-        if (!selectedTypes.contains(error->check()->description()))
+        ui->btnSwitch->setIcon(QIcon(":/icons/mSwitch.svg"));
+    }
+    enableKeyboard = !enableKeyboard;
+}
+
+void ResultTab::showProfile()
+{
+    const CheckProfile &profile = mChecker->profile();
+    QMap<QString, QString> layerNames;
+    for (auto it = mChecker->featurePools().constBegin(); it != mChecker->featurePools().constEnd(); ++it)
+    {
+        layerNames.insert(it.key(), it.value()->layerName());
+    }
+
+    // Slowest checks first
+    QList<const Check *> checks = profile.checks();
+    std::sort(checks.begin(), checks.end(), [&profile](const Check *a, const Check *b) {
+        return profile.total(a).wallTime > profile.total(b).wallTime;
+    });
+
+    QTreeWidget *tree = new QTreeWidget();
+    tree->setHeaderLabels({QStringLiteral("检查 / 图层"), QStringLiteral("耗时(ms)"), QStringLiteral("要素数"), QStringLiteral("候选要素"),
+                           QStringLiteral("GEOS 调用"), QStringLiteral("GEOS 耗时(ms)"), QStringLiteral("读取耗时(ms)"), QStringLiteral("缓存未命中"),
+                           QStringLiteral("投影耗时(ms)"), QStringLiteral("错误数")});
+    auto setCounters = [](QTreeWidgetItem *item, const CheckProfile::Counters &counters) {
+        const QList<double> values = {counters.wallTime / 1e6, double(counters.featuresVisited), double(counters.candidatePairs),
+                                      double(counters.geosCalls), counters.geosTime / 1e6, counters.fetchTime / 1e6,
+                                      double(counters.cacheMisses), counters.reprojectionTime / 1e6, double(counters.errors)};
+        for (int i = 0; i < values.size(); ++i)
         {
-            ui->tableWidgetErrors->setRowHidden(i, true);
+            item->setText(i + 1, QString::number(values[i], 'f', i == 0 || i == 4 || i == 5 || i == 7 ? 1 : 0));
+            item->setTextAlignment(i + 1, Qt::AlignRight | Qt::AlignVCenter);
         }
-        else
+    };
+    for (const Check *check : qgis::as_const(checks))
+    {
+        QTreeWidgetItem *checkItem = new QTreeWidgetItem(tree, {check ? check->description() : QStringLiteral("要素读取（多项检查共用）")});
+        setCounters(checkItem, profile.total(check));
+        const QMap<QString, CheckProfile::Counters> layers = profile.layerCounters(check);
+        for (auto it = layers.constBegin(); it != layers.constEnd(); ++it)
         {
-            ++mErrorCount;
-            if (error->status() == CheckError::StatusFixed)
-            {
-                ++mFixedCount;
-            }
-            else if (error->status() == CheckError::StatusObsolete)
-            {
-                --mErrorCount;
-            }
+            QTreeWidgetItem *layerItem = new QTreeWidgetItem(checkItem, {it.key().isEmpty() ? QStringLiteral("（所有图层）") : layerNames.value(it.key())});
+            setCounters(layerItem, it.value());
         }
     }
-    ui->labelErrorCount->setText(QStringLiteral("错误数目：") + QString::number(mErrorCount) + QStringLiteral("，修复数目：") + QString::number(mFixedCount));
+    tree->resizeColumnToContents(0);
+
+    QDialog dialog(this);
+    dialog.setLayout(new QVBoxLayout());
+    dialog.layout()->addWidget(tree);
+    QDialogButtonBox *bbox = new QDialogButtonBox(QDialogButtonBox::Close, Qt::Horizontal);
+    QPushButton *exportButton = bbox->addButton(QStringLiteral("导出 JSON"), QDialogButtonBox::ActionRole);
+    dialog.layout()->addWidget(bbox);
+    connect(bbox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    connect(exportButton, &QAbstractButton::clicked, this, &ResultTab::exportProfile);
+    dialog.setWindowTitle(QStringLiteral("检查耗时"));
+    dialog.resize(900, 500);
+    dialog.exec();
 }
 
-void ResultTab::switchByKey()
+void ResultTab::exportProfile()
 {
-    if(enableKeyboard)
+    const QString file = QFileDialog::getSaveFileName(this, QStringLiteral("选择输出文件"), QString(), QStringLiteral("JSON (*.json)"));
+    if (file.isEmpty())
     {
-        ui->btnSwitch->setIcon(QIcon(":/icons/mSwitchFalse.svg"));
+        return;
     }
-    else
+
+    QFile jsonFile(QgsFileUtils::ensureFileNameHasExtension(file, {QStringLiteral("json")}));
+    if (!jsonFile.open(QFile::WriteOnly | QFile::Truncate) || jsonFile.write(QJsonDocument(mChecker->profileToJson()).toJson()) < 0)
     {
-        ui->btnSwitch->setIcon(QIcon(":/icons/mSwitch.svg"));
+        QMessageBox::critical(this, QStringLiteral("导出"), QStringLiteral("无法写入 %1").arg(QDir::toNativeSeparators(jsonFile.fileName())));
     }
-    enableKeyboard = !enableKeyboard;
 }
@@ -6,6 +6,7 @@
 #include <qgisinterface.h>
 #include <qgsrubberband.h>
 #include "checker.h"
+#include "checkerrormodel.h"
 #include "classifydialog.h"
 #include <QItemSelection>
 #include <QKeyEvent>
@@ -37,14 +38,11 @@ private:
     ClassifyDialog *mClassifyDialog = nullptr;
     Checker *mChecker = nullptr;
     QList<QgsRubberBand *> mCurrentRubberBands;
-    QMap<CheckError *, QPersistentModelIndex> mErrorMap;
+    CheckErrorModel *mModel = nullptr;
     QMap<QString, QPointer<QDialog>> mAttribTableDialogs;
-    int mErrorCount;
-    int mFixedCount;
 
     bool mCloseable = true;
 
-    void setRowStatus( int row, const QColor &color, const QString &message, bool selectable );
     bool exportErrorsDo( const QString &file );
     void updateComboBox();
 
@@ -52,8 +50,7 @@ private:
     int mCurrentRow = -1;
 
 private slots:
-    void addError( CheckError *error );
-    void updateError( CheckError *error, bool statusChanged );
+    void updateErrorCount();
     void onSelectionChanged( const QItemSelection &newSel, const QItemSelection & /*oldSel*/ );
     void highlightErrors( bool current = false );
     void openAttributeTable();
@@ -66,6 +63,8 @@ private slots:
     void classify();
     void doClassify();
     void switchByKey();
+    void showProfile();
+    void exportProfile();
 
 };
 
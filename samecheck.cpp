@@ -1,4 +1,5 @@
 ﻿#include "samecheck.h"
+#include "candidatepairs.h"
 #include "checkcontext.h"
 #include "qgsgeometryengine.h"
 #include "qgsspatialindex.h"
@@ -32,21 +33,22 @@ QString SameCheckError::duplicatesString(const QMap<QString, FeaturePool *> &fea
     return str.join(QLatin1String("; "));
 }
 
-void SameCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void SameCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds(featurePools) : ids.toMap();
     CheckerUtils::LayerFeatures layerFeaturesA(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true);
     QList<QString> layerIds = featureIds.keys();
+    // The same pairs are compared by the other checks of the run on these layers
+    CandidatePairCache *candidatePairs = mContext->candidatePairs();
     for (const CheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeatureA.layer()) == layers.end())
+        if (!layers.contains(layerFeatureA.layer()))
             continue;
         // Ensure each pair of layers only gets compared once: remove the current layer from the layerIds, but add it to the layerList for layerFeaturesB
         layerIds.removeOne(layerFeatureA.layer()->id());
 
         QgsGeometry geomA = layerFeatureA.geometry();
 
-        QgsRectangle bboxA = geomA.boundingBox();
         std::unique_ptr<QgsGeometryEngine> geomEngineA = CheckerUtils::createGeomEngine(geomA.constGet(), mContext->tolerance);
         if (!geomEngineA->isValid())
         {
@@ -62,37 +64,41 @@ void SameCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools,
             ids << layerFeatureA.layer()->id();
         else
             ids << layerFeatureA.layer()->id() << layerIds;
-        CheckerUtils::LayerFeatures layerFeaturesB(featurePools, ids, bboxA, {geomType}, mContext);
-        for (const CheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB)
+        for (const QString &layerIdB : ids)
         {
-            if (std::find(layers.begin(), layers.end(), layerFeatureB.layer()) == layers.end())
+            FeaturePool *featurePoolB = featurePools.value(layerIdB);
+            if (featurePoolB->geometryType() != geomType || !layers.contains(featurePoolB->layerPtr().data()))
                 continue;
-            // > : only report overlaps within same layer once
-            if (layerFeatureA.layer()->id() == layerFeatureB.layer()->id() && layerFeatureB.feature().id() >= layerFeatureA.feature().id())
+            for (QgsFeatureId idB : candidatePairs->candidates(featurePools, layerFeatureA, layerIdB, mContext->tolerance, mContext))
             {
-                continue;
-            }
+                // > : only report overlaps within same layer once, the candidates are sorted
+                if (layerIdB == layerFeatureA.layerId() && idB >= layerFeatureA.feature().id())
+                    break;
+                CheckerUtils::LayerFeature layerFeatureB;
+                if (!candidatePairs->layerFeature(featurePoolB, idB, mContext, layerFeatureB))
+                    continue;
 
-            const QgsGeometry geomB = layerFeatureB.geometry();
-            if (!sameNode) {
-                QgsGeometry bufferA = geomA.buffer(mContext->tolerance, 5);
-                QgsGeometry bufferB = geomB.buffer(mContext->tolerance, 5);
+                const QgsGeometry geomB = layerFeatureB.geometry();
+                if (!sameNode) {
+                    QgsGeometry bufferA = geomA.buffer(mContext->tolerance, 5);
+                    QgsGeometry bufferB = geomB.buffer(mContext->tolerance, 5);
 
-                if(bufferA.contains(geomB) && bufferB.contains(geomA)) {
-                    duplicates[layerFeatureB.layer()->id()].append(layerFeatureB.feature().id());
+                    if(bufferA.contains(geomB) && bufferB.contains(geomA)) {
+                        duplicates[layerIdB].append(idB);
+                    }
+                    continue;
                 }
-                continue;
-            }
 
-            QString errMsg;
-            const bool equal = geomEngineA->isEqual( geomB.constGet(), &errMsg );
-            if (equal && errMsg.isEmpty())
-            {
-                duplicates[layerFeatureB.layer()->id()].append(layerFeatureB.feature().id());
-            }
-            else if (!errMsg.isEmpty())
-            {
-                messages.append(tr("Duplicate check failed for (%1, %2): %3").arg(layerFeatureA.id(), layerFeatureB.id(), errMsg));
+                QString errMsg;
+                const bool equal = geomEngineA->isEqual( geomB.constGet(), &errMsg );
+                if (equal && errMsg.isEmpty())
+                {
+                    duplicates[layerIdB].append(idB);
+                }
+                else if (!errMsg.isEmpty())
+                {
+                    messages.append(tr("Duplicate check failed for (%1, %2): %3").arg(layerFeatureA.id(), layerFeatureB.id(), errMsg));
+                }
             }
         }
         if (!duplicates.isEmpty())
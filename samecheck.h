@@ -14,12 +14,12 @@ public:
                    const QgsPointXY &errorLocation,
                    const QMap<QString, FeaturePool *> &featurePools,
                    const QMap<QString, QList<QgsFeatureId>> &duplicates)
-        : CheckError(check, layerFeature, errorLocation, QgsVertexId(), duplicatesString(featurePools, duplicates)), mDuplicates(duplicates)
+        : CheckError(check, layerFeature, errorLocation, QgsVertexId(), duplicatesString(featurePools, duplicates)), mDuplicates(errorTable()->compactFeatures(duplicates))
     {
     }
 
     //! Returns the duplicates
-    QMap<QString, QList<QgsFeatureId>> duplicates() const { return mDuplicates; }
+    QMap<QString, QList<QgsFeatureId>> duplicates() const { return errorTable()->expandFeatures(mDuplicates); }
 
     //! Returns if the \a other error is equivalent
     bool isEqual(CheckError *other) const override
@@ -28,11 +28,11 @@ public:
                other->layerId() == layerId() &&
                other->featureId() == featureId() &&
                // static_cast: since other->checker() == checker is only true if the types are actually the same
-               static_cast<SameCheckError *>(other)->duplicates() == duplicates();
+               static_cast<SameCheckError *>(other)->mDuplicates == mDuplicates;
     }
 
 private:
-    QMap<QString, QList<QgsFeatureId>> mDuplicates;
+    CheckErrorTable::FeatureList mDuplicates;
 
     static QString duplicatesString(const QMap<QString, FeaturePool *> &featurePools, const QMap<QString, QList<QgsFeatureId>> &duplicates);
 };
@@ -49,7 +49,7 @@ public:
         withinLayer = configuration.value(QStringLiteral("excludeEndpoint")).toBool();
         sameNode = configuration.value(QStringLiteral("sameNode")).toBool();
     }
-    void collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids = LayerFeatureIds()) const override;
+    void collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids = LayerFeatureIds()) const override;
     void fixError(const QMap<QString, FeaturePool *> &featurePools, CheckError *error, int method, const QMap<QString, int> &mergeAttributeIndices, Changes &changes) const override;
 
     QList<QgsWkbTypes::GeometryType> compatibleGeometryTypes() const override { return factoryCompatibleGeometryTypes(); }
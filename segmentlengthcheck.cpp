@@ -2,8 +2,9 @@
 #include "segmentlengthcheck.h"
 #include "featurepool.h"
 #include "checkerror.h"
+#include "vertexmetrics.h"
 
-void SegmentLengthCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void SegmentLengthCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
 
@@ -11,33 +12,42 @@ void SegmentLengthCheck::collectErrors(const QMap<QString, FeaturePool *> &featu
     CheckerUtils::LayerFeatures layerFeatures(featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext);
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
-        double layerToMapUnits = scaleFactor(layerFeature.layer());
-        double minLength = mLengthMin / layerToMapUnits;
-        double maxLength = mLengthMax / layerToMapUnits;
+        collectFeatureErrors(layerFeature, errors);
+    }
+}
+
+void SegmentLengthCheck::collectFeatureErrors(const CheckerUtils::LayerFeature &layerFeature, CheckErrorSink &errors) const
+{
+    double layerToMapUnits = scaleFactor(layerFeature.layer());
+    double minLength = mLengthMin / layerToMapUnits;
+    double maxLength = mLengthMax / layerToMapUnits;
+    // Compare squared lengths, the square root is only taken for reported segments
+    const double minSqrLength = minLength > 0 ? minLength * minLength : -1.0;
+    const double maxSqrLength = maxLength >= 0 ? maxLength * maxLength : -1.0;
 
-        const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
-        for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+    const QgsAbstractGeometry *geom = layerFeature.geometry().constGet();
+    VertexMetrics metrics;
+    for (int iPart = 0, nParts = geom->partCount(); iPart < nParts; ++iPart)
+    {
+        for (int iRing = 0, nRings = geom->ringCount(iPart); iRing < nRings; ++iRing)
         {
-            for (int iRing = 0, nRings = geom->ringCount(iPart); iRing < nRings; ++iRing)
+            metrics.setRing(geom, iPart, iRing);
+            const int nVerts = metrics.size();
+            if (nVerts < 2)
             {
-                bool isClosed = false;
-                int nVerts = CheckerUtils::polyLineSize(geom, iPart, iRing, &isClosed);
-                if (nVerts < 2)
-                {
-                    continue;
-                }
-                for (int iVert = isClosed ? 0 : 1, jVert = isClosed ? nVerts - 1 : 0; iVert < nVerts; jVert = iVert++)
+                continue;
+            }
+            metrics.compute();
+            for (int iVert = metrics.firstSegment(); iVert < nVerts; ++iVert)
+            {
+                double sqrDist = metrics.sqrSegmentLength(iVert);
+                if (sqrDist >= minSqrLength && sqrDist <= maxSqrLength)
                 {
-                    QgsPoint pi = geom->vertexAt(QgsVertexId(iPart, iRing, iVert));
-                    QgsPoint pj = geom->vertexAt(QgsVertexId(iPart, iRing, jVert));
-                    double dist = pi.distance(pj);
-                    if (dist >= minLength && dist <= maxLength)
-                    {
-                        QgsPointXY pos(0.5 * (pi.x() + pj.x()), 0.5 * (pi.y() + pj.y()));
-                        errors.append(new CheckError(this, layerFeature, pos, QgsVertexId(iPart, iRing, iVert), dist * layerToMapUnits, CheckError::ValueLength));
-                    }
+                    int jVert = iVert == 0 ? nVerts - 1 : iVert - 1;
+                    QgsPointXY pos(0.5 * (metrics.x(iVert) + metrics.x(jVert)), 0.5 * (metrics.y(iVert) + metrics.y(jVert)));
+                    errors.append(new CheckError(this, layerFeature, pos, QgsVertexId(iPart, iRing, iVert), std::sqrt(sqrDist) * layerToMapUnits, CheckError::ValueLength));
                 }
             }
         }
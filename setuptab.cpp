@@ -6,15 +6,23 @@
 #include "widget.h"
 #include "checkitemdialog.h"
 #include "checker.h"
+#include "checkplancompiler.h"
+#include "checktracer.h"
+#include "checksnapshot.h"
 
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
 #include <QFileDialog>
 #include <QLineEdit>
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <qgsmessagebar.h>
 #include <qgsproject.h>
 #include <qgsvectorfilewriter.h>
+#include <qgssettings.h>
 
 SetupTab::SetupTab(QgisInterface *iface, CheckDock *checkDock, QWidget *parent)
     : QWidget(parent), ui(new Ui::SetupTab), mIface(iface), mCheckDock(checkDock)
@@ -260,51 +268,9 @@ void SetupTab::save()
 {
     if (curList == nullptr || mlists.size() <= 0)
         return;
-    QJsonArray groupArray;
-    for (int i = 0; i < curList->groups.size(); ++i)
-    {
-
-        CheckGroup group = curList->groups[i];
-        QJsonArray itemArray;
-
-        for (int j = 0; j < group.items.size(); ++j)
-        {
-
-            CheckItem item = group.items[j];
-            QJsonArray setArray;
-
-            for (int k = 0; k < item.sets.size(); ++k)
-            {
-
-                CheckSet set = item.sets[k];
-
-                QJsonObject object({{"name", set.name}});
-                object.insert("layersA", QJsonArray::fromStringList(set.layersAStr));
-                object.insert("layersB", QJsonArray::fromStringList(set.layersBStr));
-                object.insert("angle", set.angle);
-                object.insert("upperLimit", set.upperLimit);
-                object.insert("lowerLimit", set.lowerLimit);
-                object.insert("excludeEndpoint", set.excludeEndpoint);
-                object.insert("oneToOne", set.oneToOne);
-                object.insert("attr", set.attr);
-                setArray.append(object);
-            }
-
-            QJsonObject itemObj;
-            itemObj.insert("name", item.name);
-            itemObj.insert("sets", setArray);
-            itemArray.append(itemObj);
-        }
-
-        QJsonObject groupObj;
-        groupObj.insert("name", group.name);
-        groupObj.insert("items", itemArray);
-        groupArray.append(groupObj);
-    }
-
     QString fileName = QFileDialog::getSaveFileName(this, QStringLiteral("保存"), "./" + curList->name, "Json(*.json)");
 
-    QJsonDocument doc(groupArray);
+    QJsonDocument doc(curList->toJson());
     QByteArray jsonData = doc.toJson();
 
     QFile file(fileName);
@@ -327,56 +293,7 @@ void SetupTab::read()
     QString str = file.readAll();
     QJsonDocument d = QJsonDocument::fromJson(str.toUtf8());
 
-    CheckList list;
-    QJsonArray arr = d.array();
-    for (int i = 0; i < arr.size(); ++i)
-    {
-        QJsonValue val = arr[i];
-        QJsonObject obj = val.toObject();
-        CheckGroup group(obj["name"].toString());
-
-        QJsonArray items = obj["items"].toArray();
-        for (int j = 0; j < items.size(); ++j)
-        {
-            val = items[j];
-            obj = val.toObject();
-            CheckItem item(obj["name"].toString());
-
-            QJsonArray sets = obj["sets"].toArray();
-            for (int k = 0; k < sets.size(); ++k)
-            {
-                val = sets[k];
-                obj = val.toObject();
-
-                // CheckSet set(obj["name"].toString(),obj["description"].toString());
-                CheckSet set(obj["name"].toString());
-                QStringList list;
-                QJsonArray array = obj["layersA"].toArray();
-                for (auto it : as_const(array))
-                    list.append(it.toString());
-                set.layersAStr = list;
-                list.clear();
-                array = obj["layersB"].toArray();
-                for (auto it : as_const(array))
-                    list.append(it.toString());
-                set.layersBStr = list;
-                set.angle = obj["angle"].toDouble();
-                set.upperLimit = obj["upperLimit"].toDouble();
-                set.lowerLimit = obj["lowerLimit"].toDouble();
-                set.excludeEndpoint = obj["excludeEndpoint"].toBool();
-                set.oneToOne = obj["oneToOne"].toBool();
-                set.attr = obj["attr"].toString();
-
-                item.sets.push_back(set);
-            }
-
-            group.items.push_back(item);
-        }
-
-        list.groups.push_back(group);
-    }
-
-    list.name = QFileInfo(fileName).completeBaseName();
+    CheckList list = CheckList::fromJson(QFileInfo(fileName).completeBaseName(), d.array());
 
     int i = mlists.size();
     mlists.push_back(list);
@@ -700,37 +617,58 @@ void SetupTab::run()
         return;
     }
 
-    // Get process layer
-    QSet<QgsVectorLayer *> processLayers;
-    for (auto i : curList->groups)
+    bool selectedOnly = mMessageBox->selectedOnly();
+    double tolerance = mMessageBox->tolerance();
+
+    // Build and validate the checks before any feature is read
+    QgsVectorLayer *firstLayer = nullptr;
+    for (const CheckGroup &group : curList->groups)
     {
-        for (auto j : (i.items))
+        for (const CheckItem &item : group.items)
         {
-            for (auto set : (j.sets))
+            for (const CheckSet &set : item.sets)
             {
-                for (auto layer : as_const(set.layersA))
-                    processLayers.insert(layer);
-                for (auto layer : as_const(set.layersB))
-                    processLayers.insert(layer);
-                for (auto layer : as_const(set.excludedLayers))
-                    processLayers.insert(layer);
+                if (!firstLayer && !set.layersA.isEmpty())
+                    firstLayer = *set.layersA.begin();
             }
         }
     }
+    if (firstLayer == nullptr)
+        return;
+
+    QgsProject::instance()->setCrs(firstLayer->crs());
+
+    CheckContext *context = new CheckContext(tolerance, QgsProject::instance()->crs(), QgsProject::instance()->transformContext(), QgsProject::instance());
+
+    CheckPlanCompiler compiler(*curList);
+    if (!compiler.compile(context))
+    {
+        QMessageBox::critical(this, QStringLiteral("一键检查项"), QStringLiteral("检查方案有误：\n") + compiler.errors().join(QLatin1Char('\n')));
+        delete context;
+        return;
+    }
+    if (!compiler.warnings().isEmpty())
+    {
+        mIface->messageBar()->pushWarning(QStringLiteral("检查方案"), compiler.warnings().join(QStringLiteral("；")));
+    }
 
+    // Get process layer
+    QSet<QgsVectorLayer *> processLayers = compiler.layers();
     if (processLayers.empty())
+    {
+        delete context;
         return;
+    }
 
     for (QgsVectorLayer *layer : processLayers)
     {
         if (layer->isEditable())
         {
             QMessageBox::critical(this, tr("Check Geometries"), tr("Input layer '%1' is not allowed to be in editing mode.").arg(layer->name()));
+            delete context;
             return;
         }
     }
-    bool selectedOnly = mMessageBox->selectedOnly();
-    double tolerance = mMessageBox->tolerance();
     mIsRunningInBackground = true;
     // Setup checker
     setCursor(Qt::WaitCursor);
@@ -749,13 +687,39 @@ void SetupTab::run()
         featurePools.insert(layer->id(), new VectorDataProviderFeaturePool(layer, selectedOnly));
     }
 
-    QgsProject::instance()->setCrs((*processLayers.begin())->crs());
+    QList<Check *> checks = compiler.takeChecks();
 
-    CheckContext *context = new CheckContext(tolerance, QgsProject::instance()->crs(), QgsProject::instance()->transformContext(), QgsProject::instance());
+    Checker *checker = new Checker(checks, context, featurePools);
 
-    QList<Check *> checks = getChecks(context);
+    // Only whole layers can be compared with the previous run
+    if (mMessageBox->incremental() && !selectedOnly)
+    {
+        // Lists of the same name in other projects check other layers, they get their own snapshot
+        QStringList layerKeys;
+        for (QgsVectorLayer *layer : qgis::as_const(processLayers))
+            layerKeys.append(CheckSnapshot::layerKey(layer));
+        layerKeys.sort();
+        QByteArray sourceHash = QCryptographicHash::hash(layerKeys.join(QLatin1Char('\n')).toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+
+        QDir dir(QgsApplication::qgisSettingsDirPath() + QStringLiteral("TopologyChecker/snapshots"));
+        if (dir.mkpath(QStringLiteral(".")))
+            checker->setSnapshotPath(dir.filePath(QStringLiteral("%1_%2.snapshot").arg(curList->name, QString::fromLatin1(sourceHash))));
+    }
 
-    Checker *checker = new Checker(checks, context, featurePools);
+    // Errors beyond the memory limit are written to a GeoPackage instead of the result list
+    int maxErrorsInMemory = QgsSettings().value(QStringLiteral("/TopologyChecker/maxErrorsInMemory"), 500000).toInt();
+    QDir spillDir(QgsApplication::qgisSettingsDirPath() + QStringLiteral("TopologyChecker/errors"));
+    if (maxErrorsInMemory > 0 && spillDir.mkpath(QStringLiteral(".")))
+    {
+        QString spillFile = spillDir.filePath(QStringLiteral("%1_%2.gpkg").arg(curList->name, QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMddhhmmss"))));
+        checker->setErrorSpill(maxErrorsInMemory, spillFile);
+    }
+
+    // The profile of the run is shown on the result tab
+    checker->setProfilingEnabled(mMessageBox->profiling());
+    // A trace of the run is written to this file when it is finished
+    if (!QgsSettings().value(QStringLiteral("/TopologyChecker/traceFile")).toString().isEmpty())
+        CheckTracer::start();
 
     emit checkerStarted(checker);
 
@@ -767,69 +731,22 @@ void SetupTab::run()
     CheckTask * task = new CheckTask(checker);
     QgsApplication::taskManager()->addTask( task );
 
-    connect(task, &QgsTask::taskCompleted, this, [&](){
+    auto finished = [this](){
         emit checkerFinished( true );
         this->setEnabled(true);
         mIsRunningInBackground = false;
         mCheckDock->setFeatures(QDockWidget::AllDockWidgetFeatures);
-    });
-}
-
-QList<Check *> SetupTab::getChecks(CheckContext *context)
-{
-    QList<Check *> checks;
-    for (int i = 0; i < curList->groups.size(); ++i)
-    {
-        CheckGroup &group = curList->groups[i];
-        for (int j = 0; j < group.items.size(); ++j)
-        {
-            CheckItem &item = group.items[j];
-            CheckItemDialog *dialog = new CheckItemDialog(mIface, &item, mCheckDock, this);
-
-            checks.append(dialog->getChecks(context));
-            delete dialog;
-        }
-    }
-    return checks;
+    };
+    connect(task, &QgsTask::taskCompleted, this, finished);
+    // The errors found until the run was canceled are shown as well
+    connect(task, &QgsTask::taskTerminated, this, finished);
 }
 
 void SetupTab::initItemLayers()
 {
     if (curList == nullptr)
         return;
-    for (auto &i : curList->groups)
-    {
-        for (auto &j : (i.items))
-        {
-            for (auto &set : (j.sets))
-            {
-                set.layersA.clear();
-                set.layersB.clear();
-                for (auto layerName : set.layersAStr)
-                {
-                    for (auto layer : layers)
-                    {
-                        if (layer->name() == layerName)
-                        {
-                            set.layersA.insert(layer);
-                            break;
-                        }
-                    }
-                }
-                for (auto layerName : set.layersBStr)
-                {
-                    for (auto layer : layers)
-                    {
-                        if (layer->name() == layerName)
-                        {
-                            set.layersB.insert(layer);
-                            break;
-                        }
-                    }
-                }
-            }
-        }
-    }
+    curList->resolveLayers(layers);
 }
 
 void SetupTab::setupItemLayers()
@@ -65,7 +65,6 @@ private slots:
     void run();
 
 private:
-    QList<Check *> getChecks(CheckContext *context);
     void initItemLayers();
     void setupItemLayers();
 };
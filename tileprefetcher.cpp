@@ -0,0 +1,84 @@
+#include "tileprefetcher.h"
+#include "featurepool.h"
+
+#include <QElapsedTimer>
+#include <QtConcurrentRun>
+
+TilePrefetcher::TilePrefetcher( const QMap<QString, FeaturePool *> &featurePools, const QList<TileExtents> &tiles, int depth )
+  : mFeaturePools( featurePools )
+  , mTiles( tiles )
+  , mDepth( depth > 0 ? depth : 0 )
+{
+  // One reader, the data providers are the bottleneck and the checks need the other cores
+  mThreadPool.setMaxThreadCount( 1 );
+  mFutures.reserve( mTiles.size() );
+  for ( int i = 0; i < mTiles.size(); ++i )
+  {
+    mFutures.append( QFuture<TileFeatures>() );
+  }
+  mScheduled.fill( false, mTiles.size() );
+  for ( int i = 0; i < mDepth && i < mTiles.size(); ++i )
+  {
+    schedule( i );
+  }
+}
+
+TilePrefetcher::~TilePrefetcher()
+{
+  mThreadPool.waitForDone();
+}
+
+TilePrefetcher::TileFeatures TilePrefetcher::take( int index )
+{
+  for ( int i = index + 1; i <= index + mDepth && i < mTiles.size(); ++i )
+  {
+    schedule( i );
+  }
+
+  QFuture<TileFeatures> future = mFutures.at( index );
+  // Release the features with the future once they are handed over
+  mFutures[index] = QFuture<TileFeatures>();
+  if ( !mScheduled.at( index ) )
+  {
+    // Not scheduled, read it right here
+    QElapsedTimer timer;
+    timer.start();
+    TileFeatures features = fetch( mFeaturePools, mTiles.at( index ) );
+    mStallTime += timer.elapsed();
+    ++mStallCount;
+    return features;
+  }
+  if ( !future.isFinished() )
+  {
+    QElapsedTimer timer;
+    timer.start();
+    future.waitForFinished();
+    mStallTime += timer.elapsed();
+    ++mStallCount;
+  }
+  return future.result();
+}
+
+void TilePrefetcher::schedule( int index )
+{
+  if ( mScheduled.at( index ) )
+  {
+    return;
+  }
+  mScheduled[index] = true;
+  mFutures[index] = QtConcurrent::run( &mThreadPool, &TilePrefetcher::fetch, mFeaturePools, mTiles.at( index ) );
+}
+
+TilePrefetcher::TileFeatures TilePrefetcher::fetch( const QMap<QString, FeaturePool *> &featurePools, const TileExtents &extents )
+{
+  TileFeatures features;
+  for ( auto it = extents.constBegin(); it != extents.constEnd(); ++it )
+  {
+    FeaturePool *featurePool = featurePools.value( it.key() );
+    if ( featurePool )
+    {
+      features.insert( it.key(), featurePool->fetchExtent( it.value() ) );
+    }
+  }
+  return features;
+}
@@ -0,0 +1,83 @@
+#ifndef TILEPREFETCHER_H
+#define TILEPREFETCHER_H
+
+#include <QFuture>
+#include <QList>
+#include <QMap>
+#include <QThreadPool>
+#include <QVector>
+
+#include "qgsfeature.h"
+#include "qgsrectangle.h"
+
+class FeaturePool;
+
+/**
+ * \ingroup analysis
+ * Reads the features of the next tiles of a tiled run in the background.
+ *
+ * While the checks run on one tile, the features of the following \a depth tiles
+ * are read and their geometries parsed on a thread of its own, so the checks do
+ * not wait for the data provider when they move on. Not thread safe, take() is
+ * meant to be called by the thread walking the tiles.
+ */
+class TilePrefetcher
+{
+  public:
+
+    /**
+     * The extents to load for each layer id, in the crs of the layer.
+     */
+    typedef QMap<QString, QgsRectangle> TileExtents;
+
+    /**
+     * The features read for each layer id.
+     */
+    typedef QMap<QString, QgsFeatureList> TileFeatures;
+
+    /**
+     * Creates a prefetcher for the \a tiles in the order they are checked.
+     * Up to \a depth tiles after the one taken last are read ahead, with 0
+     * each tile is only read when it is taken.
+     */
+    TilePrefetcher( const QMap<QString, FeaturePool *> &featurePools, const QList<TileExtents> &tiles, int depth );
+
+    /**
+     * Waits for reads still running.
+     */
+    ~TilePrefetcher();
+
+    TilePrefetcher( const TilePrefetcher & ) = delete;
+    TilePrefetcher &operator=( const TilePrefetcher & ) = delete;
+
+    /**
+     * Returns the features of the tile at \a index, waiting until they are read,
+     * and starts reading the tiles after it.
+     */
+    TileFeatures take( int index );
+
+    /**
+     * Returns the time in milliseconds take() waited for tiles which were not read yet.
+     */
+    qint64 stallTime() const { return mStallTime; }
+
+    /**
+     * Returns the number of tiles take() had to wait for.
+     */
+    int stallCount() const { return mStallCount; }
+
+  private:
+    void schedule( int index );
+    static TileFeatures fetch( const QMap<QString, FeaturePool *> &featurePools, const TileExtents &extents );
+
+    QMap<QString, FeaturePool *> mFeaturePools;
+    QList<TileExtents> mTiles;
+    int mDepth = 1;
+    QThreadPool mThreadPool;
+    QList<QFuture<TileFeatures> > mFutures;
+    QVector<bool> mScheduled;
+    qint64 mStallTime = 0;
+    int mStallCount = 0;
+};
+
+#endif // TILEPREFETCHER_H
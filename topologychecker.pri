@@ -9,6 +9,7 @@ FORMS += \
 
 HEADERS += \
     $$PWD/checkdock.h \
+    $$PWD/checkerrormodel.h \
     $$PWD/checkitemdialog.h \
     $$PWD/checktask.h \
     $$PWD/classifydialog.h \
@@ -20,6 +21,7 @@ HEADERS += \
 
 SOURCES += \
     $$PWD/checkdock.cpp \
+    $$PWD/checkerrormodel.cpp \
     $$PWD/checkitemdialog.cpp \
     $$PWD/checktask.cpp \
     $$PWD/classifydialog.cpp \
@@ -2,8 +2,9 @@
 #include "checkcontext.h"
 #include "featurepool.h"
 #include "checkerror.h"
+#include "qgsfeedback.h"
 
-void UniqueAttrCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
+void UniqueAttrCheck::collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids) const
 {
     Q_UNUSED(messages)
 
@@ -12,7 +13,7 @@ void UniqueAttrCheck::collectErrors(const QMap<QString, FeaturePool *> &featureP
 
     for (const CheckerUtils::LayerFeature &layerFeature : layerFeatures)
     {
-        if (std::find(layers.begin(), layers.end(), layerFeature.layer()) == layers.end())
+        if (!layers.contains(layerFeature.layer()))
             continue;
         QgsFeature f = layerFeature.feature();
         if (!f.attribute(attr).isValid())
@@ -33,6 +34,8 @@ void UniqueAttrCheck::collectErrors(const QMap<QString, FeaturePool *> &featureP
         QgsFeature checkF;
         while (featureIt.nextFeature(checkF))
         {
+            if (feedback && feedback->isCanceled())
+                return;
             if (checkF.id() >= f.id())
                 continue;
             if (checkF.attribute(attr) == var)
@@ -12,11 +12,11 @@ public:
                        const QgsPointXY &errorLocation,
                        const QString &attr,
                        const QList<QgsFeatureId> &duplicates)
-        :CheckError(check, layerFeature, errorLocation, QgsVertexId(), duplicatesString(attr, duplicates)), mAttr(attr), mDuplicates(duplicates)
+        :CheckError(check, layerFeature, errorLocation, QgsVertexId(), duplicatesString(attr, duplicates)), mAttrIndex(errorTable()->intern(attr)), mDuplicates(duplicates)
     {
-        mlayerId = layerFeature.layerId();
     }
     QList<QgsFeatureId> duplicates() const { return mDuplicates; }
+    const QString &attr() const { return errorTable()->string(mAttrIndex); }
 
     bool isEqual(CheckError *other) const override
     {
@@ -25,13 +25,11 @@ public:
                other->featureId() == featureId() &&
                // static_cast: since other->checker() == checker is only true if the types are actually the same
                static_cast<AttrDuplicateError *>(other)->duplicates() == duplicates() &&
-               static_cast<AttrDuplicateError *>(other)->mlayerId == mlayerId &&
-               static_cast<AttrDuplicateError *>(other)->mAttr == mAttr;
+               static_cast<AttrDuplicateError *>(other)->mAttrIndex == mAttrIndex;
     }
-    QString mlayerId;
-    QString mAttr;
 
 private:
+    int mAttrIndex = -1;
     QList<QgsFeatureId> mDuplicates;
 
     QString duplicatesString(const QString &attr, const QList<QgsFeatureId> &duplicates);
@@ -51,7 +49,7 @@ public:
     static QList<QgsWkbTypes::GeometryType> factoryCompatibleGeometryTypes() { return {QgsWkbTypes::PointGeometry, QgsWkbTypes::LineGeometry, QgsWkbTypes::PolygonGeometry}; }
     static bool factoryIsCompatible(QgsVectorLayer *layer) SIP_SKIP { return factoryCompatibleGeometryTypes().contains(layer->geometryType()); }
     QList<QgsWkbTypes::GeometryType> compatibleGeometryTypes() const override { return factoryCompatibleGeometryTypes(); }
-    void collectErrors(const QMap<QString, FeaturePool *> &featurePools, QList<CheckError *> &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids = LayerFeatureIds()) const override;
+    void collectErrors(const QMap<QString, FeaturePool *> &featurePools, CheckErrorSink &errors, QStringList &messages, QgsFeedback *feedback, const LayerFeatureIds &ids = LayerFeatureIds()) const override;
     void fixError(const QMap<QString, FeaturePool *> &featurePools, CheckError *error, int method, const QMap<QString, int> &mergeAttributeIndices, Changes &changes) const override;
     Q_DECL_DEPRECATED QStringList resolutionMethods() const override;
     static QString factoryDescription() { return QStringLiteral("检查唯一标识码"); }
@@ -2,13 +2,21 @@ HEADERS += \
     $$PWD/anglecheck.h \
     $$PWD/areacheck.h \
     $$PWD/attrvalidcheck.h \
+    $$PWD/candidatepairs.h \
     $$PWD/check.h \
     $$PWD/checkcontext.h \
     $$PWD/checker.h \
     $$PWD/checkerror.h \
+    $$PWD/checkerrorsink.h \
+    $$PWD/checkerrortable.h \
     $$PWD/checkerutils.h \
+    $$PWD/checkfactory.h \
+    $$PWD/checkplancompiler.h \
+    $$PWD/checkprofile.h \
     $$PWD/checkresolutionmethod.h \
     $$PWD/checkset.h \
+    $$PWD/checksnapshot.h \
+    $$PWD/checktracer.h \
     $$PWD/clockwisecheck.h \
     $$PWD/collinearcheck.h \
     $$PWD/convexhullcheck.h \
@@ -25,18 +33,21 @@ HEADERS += \
     $$PWD/lineendonpointcheck.h \
     $$PWD/lineinpolygoncheck.h \
     $$PWD/lineintersectioncheck.h \
+    $$PWD/linenetwork.h \
     $$PWD/linelayerintersectioncheck.h \
     $$PWD/linelayeroverlapcheck.h \
     $$PWD/lineoverlapcheck.h \
     $$PWD/linesegment.h \
     $$PWD/lineselfintersectioncheck.h \
     $$PWD/lineselfoverlapcheck.h \
+    $$PWD/lockwaitcounter.h \
     $$PWD/pointduplicatecheck.h \
     $$PWD/pointinpolygoncheck.h \
     $$PWD/pointonboundarycheck.h \
     $$PWD/pointonlinecheck.h \
     $$PWD/pointonlineendcheck.h \
     $$PWD/pointonlinenodecheck.h \
+    $$PWD/polygoncoverage.h \
     $$PWD/polygoncoveredbypolygoncheck.h \
     $$PWD/polygoninpolygoncheck.h \
     $$PWD/polygonlayeroverlapcheck.h \
@@ -44,22 +55,32 @@ HEADERS += \
     $$PWD/pseudoscheck.h \
     $$PWD/samecheck.h \
     $$PWD/segmentlengthcheck.h \
+    $$PWD/tileprefetcher.h \
     $$PWD/turnbackcheck.h \
     $$PWD/uniqueattrcheck.h \
     $$PWD/vectordataproviderfeaturepool.h \
-    $$PWD/vectorlayerfeaturepool.h
+    $$PWD/vectorlayerfeaturepool.h \
+    $$PWD/vertexmetrics.h
 
 SOURCES += \
     $$PWD/anglecheck.cpp \
     $$PWD/areacheck.cpp \
     $$PWD/attrvalidcheck.cpp \
+    $$PWD/candidatepairs.cpp \
     $$PWD/check.cpp \
     $$PWD/checkcontext.cpp \
     $$PWD/checker.cpp \
     $$PWD/checkerror.cpp \
+    $$PWD/checkerrorsink.cpp \
+    $$PWD/checkerrortable.cpp \
     $$PWD/checkerutils.cpp \
+    $$PWD/checkfactory.cpp \
+    $$PWD/checkplancompiler.cpp \
+    $$PWD/checkprofile.cpp \
     $$PWD/checkresolutionmethod.cpp \
     $$PWD/checkset.cpp \
+    $$PWD/checksnapshot.cpp \
+    $$PWD/checktracer.cpp \
     $$PWD/clockwisecheck.cpp \
     $$PWD/collinearcheck.cpp \
     $$PWD/convexhullcheck.cpp \
@@ -76,6 +97,7 @@ SOURCES += \
     $$PWD/lineendonpointcheck.cpp \
     $$PWD/lineinpolygoncheck.cpp \
     $$PWD/lineintersectioncheck.cpp \
+    $$PWD/linenetwork.cpp \
     $$PWD/linelayerintersectioncheck.cpp \
     $$PWD/linelayeroverlapcheck.cpp \
     $$PWD/lineoverlapcheck.cpp \
@@ -88,6 +110,7 @@ SOURCES += \
     $$PWD/pointonlinecheck.cpp \
     $$PWD/pointonlineendcheck.cpp \
     $$PWD/pointonlinenodecheck.cpp \
+    $$PWD/polygoncoverage.cpp \
     $$PWD/polygoncoveredbypolygoncheck.cpp \
     $$PWD/polygoninpolygoncheck.cpp \
     $$PWD/polygonlayeroverlapcheck.cpp \
@@ -95,8 +118,10 @@ SOURCES += \
     $$PWD/pseudoscheck.cpp \
     $$PWD/samecheck.cpp \
     $$PWD/segmentlengthcheck.cpp \
+    $$PWD/tileprefetcher.cpp \
     $$PWD/turnbackcheck.cpp \
     $$PWD/uniqueattrcheck.cpp \
     $$PWD/vectordataproviderfeaturepool.cpp \
-    $$PWD/vectorlayerfeaturepool.cpp
+    $$PWD/vectorlayerfeaturepool.cpp \
+    $$PWD/vertexmetrics.cpp
 
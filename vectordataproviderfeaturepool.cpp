@@ -17,12 +17,21 @@ email                : matthias@opengis.ch
 #include "qgsthreadingutils.h"
 
 #include "qgsfeaturerequest.h"
+#include "checktracer.h"
 
-VectorDataProviderFeaturePool::VectorDataProviderFeaturePool( QgsVectorLayer *layer, bool selectedOnly )
+VectorDataProviderFeaturePool::VectorDataProviderFeaturePool( QgsVectorLayer *layer, bool selectedOnly, bool loadFeatures )
   : FeaturePool( layer )
   , mSelectedOnly( selectedOnly )
 {
+  if ( !loadFeatures )
+  {
+    return;
+  }
+
   // Build spatial index
+  CheckTracer::Span span( "buildFeaturePool", "pool" );
+  if ( span.isRecording() )
+    span.setDetail( layer->name() );
   QgsFeature feature;
   QgsFeatureRequest req;
   QgsFeatureIds featureIds;
@@ -35,6 +44,7 @@ VectorDataProviderFeaturePool::VectorDataProviderFeaturePool( QgsVectorLayer *la
   QgsFeatureIterator it = layer->getFeatures( req );
   while ( it.nextFeature( feature ) )
   {
+    countProviderFetch( feature );
     if ( feature.hasGeometry() )
     {
       insertFeature( feature );
@@ -34,8 +34,9 @@ class VectorDataProviderFeaturePool : public FeaturePool
     /**
      * Creates a new feature pool for the data provider of \a layer.
      * If \a selectedOnly is set to TRUE, only selected features will be managed by the pool.
+     * If \a loadFeatures is FALSE the pool starts empty and features are loaded with loadExtent().
      */
-    VectorDataProviderFeaturePool( QgsVectorLayer *layer, bool selectedOnly = false );
+    VectorDataProviderFeaturePool( QgsVectorLayer *layer, bool selectedOnly = false, bool loadFeatures = true );
 
     bool addFeature( QgsFeature &feature, QgsFeatureSink::Flags flags = QgsFeatureSink::Flags() ) override;
     bool addFeatures( QgsFeatureList &features, QgsFeatureSink::Flags flags = QgsFeatureSink::Flags() ) override;
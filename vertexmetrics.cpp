@@ -0,0 +1,120 @@
+#include "vertexmetrics.h"
+#include "checkerutils.h"
+#include "qgscurvepolygon.h"
+#include "qgslinestring.h"
+
+#include <algorithm>
+#include <cmath>
+
+void VertexMetrics::setRing(const QgsAbstractGeometry *geom, int iPart, int iRing)
+{
+    mX.clear();
+    mY.clear();
+    mClosed = true;
+    if (geom->isEmpty())
+    {
+        return;
+    }
+
+    const QgsAbstractGeometry *part = CheckerUtils::getGeomPart(geom, iPart);
+    const QgsCurve *curve = nullptr;
+    if (const QgsCurvePolygon *polygon = dynamic_cast<const QgsCurvePolygon *>(part))
+    {
+        curve = iRing == 0 ? polygon->exteriorRing() : polygon->interiorRing(iRing - 1);
+    }
+    else
+    {
+        curve = dynamic_cast<const QgsCurve *>(part);
+    }
+
+    if (const QgsLineString *line = dynamic_cast<const QgsLineString *>(curve))
+    {
+        const int n = line->numPoints();
+        mX.assign(line->xData(), line->xData() + n);
+        mY.assign(line->yData(), line->yData() + n);
+    }
+    else
+    {
+        // Curves and other geometries go through the vertices
+        const int n = geom->vertexCount(iPart, iRing);
+        mX.reserve(n);
+        mY.reserve(n);
+        for (int i = 0; i < n; ++i)
+        {
+            const QgsPoint p = geom->vertexAt(QgsVertexId(iPart, iRing, i));
+            mX.push_back(p.x());
+            mY.push_back(p.y());
+        }
+    }
+
+    const size_t n = mX.size();
+    mClosed = n > 0 && mX[0] == mX[n - 1] && mY[0] == mY[n - 1];
+    if (mClosed)
+    {
+        mX.pop_back();
+        mY.pop_back();
+    }
+}
+
+void VertexMetrics::compute(double cosSharp, double cosStraight)
+{
+    const int n = size();
+    mDx.assign(n + 1, 0.0);
+    mDy.assign(n + 1, 0.0);
+    mSqrLength.resize(n + 1);
+    mCos.resize(n);
+    mFlags.resize(n);
+    if (n == 0)
+    {
+        return;
+    }
+
+    const double *x = mX.data();
+    const double *y = mY.data();
+    double *dx = mDx.data();
+    double *dy = mDy.data();
+    double *len = mSqrLength.data();
+    double *cosine = mCos.data();
+    unsigned char *flags = mFlags.data();
+
+    // Segments, the open ring has no segment ending at vertex 0
+    for (int i = 1; i < n; ++i)
+    {
+        dx[i] = x[i] - x[i - 1];
+        dy[i] = y[i] - y[i - 1];
+    }
+    if (mClosed)
+    {
+        dx[0] = x[0] - x[n - 1];
+        dy[0] = y[0] - y[n - 1];
+    }
+    dx[n] = dx[0];
+    dy[n] = dy[0];
+    for (int i = 0; i <= n; ++i)
+    {
+        len[i] = dx[i] * dx[i] + dy[i] * dy[i];
+    }
+
+    // Angle at vertex i between the vectors to the previous and the next vertex
+    for (int i = 0; i < n; ++i)
+    {
+        const double denom = std::sqrt(len[i] * len[i + 1]);
+        const bool valid = denom > 0.0;
+        const double dot = -(dx[i] * dx[i + 1] + dy[i] * dy[i + 1]);
+        const double c = std::max(-1.0, std::min(1.0, valid ? dot / denom : 1.0));
+        cosine[i] = c;
+        flags[i] = static_cast<unsigned char>((valid ? HasAngle : 0) |
+                                              (valid && c > cosSharp ? Sharp : 0) |
+                                              (valid && c <= cosStraight ? Straight : 0));
+    }
+}
+
+double VertexMetrics::cosThreshold(double degrees)
+{
+    return std::cos(degrees / 180.0 * M_PI);
+}
+
+double VertexMetrics::angle(int i) const
+{
+    return std::acos(mCos[i]) / M_PI * 180.0;
+}
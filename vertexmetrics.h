@@ -0,0 +1,64 @@
+#ifndef VERTEXMETRICS_H
+#define VERTEXMETRICS_H
+
+#include <vector>
+
+class QgsAbstractGeometry;
+
+// Segment lengths and vertex angles of one ring, computed in a single pass over plain
+// coordinate arrays. Angles are compared as cosines against precomputed thresholds,
+// so the loop has no acos, no vertexAt and no exceptions and can be vectorized.
+class VertexMetrics
+{
+public:
+    // Reads ring iRing of part iPart of geom, without the closing vertex of a closed ring.
+    // The vertex indices match the ones of CheckerUtils::polyLineSize().
+    void setRing(const QgsAbstractGeometry *geom, int iPart, int iRing);
+
+    // Computes the segment lengths and angles. A vertex is sharp if its angle is
+    // below the angle of cosSharp and straight if it is above the angle of cosStraight.
+    void compute(double cosSharp = 2.0, double cosStraight = -2.0);
+
+    // Returns the cosine threshold for an angle in degrees
+    static double cosThreshold(double degrees);
+
+    int size() const { return static_cast<int>(mX.size()); }
+    bool isClosed() const { return mClosed; }
+    double x(int i) const { return mX[i]; }
+    double y(int i) const { return mY[i]; }
+
+    // First vertex which ends a segment, the segment of vertex 0 exists only in closed rings
+    int firstSegment() const { return mClosed ? 0 : 1; }
+
+    // Squared length of the segment from the previous vertex to vertex i
+    double sqrSegmentLength(int i) const { return mSqrLength[i]; }
+
+    // TRUE if both segments at vertex i have a length, only then it has an angle
+    bool hasAngle(int i) const { return mFlags[i] & HasAngle; }
+    bool isSharp(int i) const { return mFlags[i] & Sharp; }
+    bool isStraight(int i) const { return mFlags[i] & Straight; }
+    double cosAngle(int i) const { return mCos[i]; }
+
+    // Angle at vertex i in degrees, only to be called for reported vertices
+    double angle(int i) const;
+
+private:
+    enum Flag
+    {
+        HasAngle = 1,
+        Sharp = 2,
+        Straight = 4
+    };
+
+    bool mClosed = false;
+    std::vector<double> mX;
+    std::vector<double> mY;
+    // Segment deltas, entry i goes from vertex i - 1 to vertex i, entry n repeats entry 0
+    std::vector<double> mDx;
+    std::vector<double> mDy;
+    std::vector<double> mSqrLength;
+    std::vector<double> mCos;
+    std::vector<unsigned char> mFlags;
+};
+
+#endif // VERTEXMETRICS_H